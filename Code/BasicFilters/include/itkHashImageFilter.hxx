@@ -79,7 +79,9 @@ HashImageFilter<TImageType>::AfterThreadedGenerateData()
   ::HL_SHA1_CTX sha1Context;
   sha1.SHA1Reset ( &sha1Context );
 
-  typename ImageType::ConstPointer input = this->GetInput();
+  // The output is the caster's copy of the input, which unlike the
+  // input is known to be buffered contiguously
+  typename ImageType::ConstPointer input = this->GetOutput();
 
 
   // make a good guess about the number of components in each pixel
@@ -75,23 +75,24 @@ inline Image operator^( const Image &img1, const Image &img2 ) { return Xor(img1
 inline Image operator^( const Image &img, int s ) { return Xor(img, s ); }
 inline Image operator^( int s, const Image &img ) { return Xor(s, img ); }
 
-/** \todo these operators should some how be done "in-place" */
-inline Image operator+=( Image &img1, const Image &img2 ) { return img1 = Add(img1, img2 ); }
-inline Image operator+=( Image &img1, double s ) { return img1 = Add(img1, s ); }
-inline Image operator-=( Image &img1, const Image &img2 ) { return img1 = Subtract(img1, img2 ); }
-inline Image operator-=( Image &img1, double s ) { return img1 = Subtract(img1, s ); }
-inline Image operator*=( Image &img1, const Image &img2 ) { return img1 = Multiply(img1, img2 ); }
-inline Image operator*=( Image &img1, double s ) { return img1 = Multiply(img1, s ); }
-inline Image operator/=( Image &img1, const Image &img2 ) { return img1 = Divide(img1, img2 ); }
-inline Image operator/=( Image &img1, double s ) { return img1 = Divide(img1, s ); }
-inline Image operator%=( Image &img1, const Image &img2 ) { return img1 = Modulus(img1, img2 ); }
-inline Image operator%=( Image &img1, uint32_t s ) { return img1 = Modulus(img1, s ); }
-inline Image operator&=( Image &img1, const Image &img2 ) { return img1 = And(img1, img2 ); }
-inline Image operator&=( Image &img1, int s ) { return img1 = And(img1, s ); }
-inline Image operator|=( Image &img1, const Image &img2 ) { return img1 = Or(img1, img2 ); }
-inline Image operator|=( Image &img1, int s ) { return img1 = Or(img1, s ); }
-inline Image operator^=( Image &img1, const Image &img2 ) { return img1 = Xor(img1, img2 ); }
-inline Image operator^=( Image &img1, int s ) { return img1 = Xor(img1, s ); }
+/** The compound operators run the filter in place, reusing the
+ * buffer of img1 for the result when no other image shares it. */
+inline Image &operator+=( Image &img1, const Image &img2 ) { return AddImageFilter().ExecuteInPlace( img1, img2 ); }
+inline Image &operator+=( Image &img1, double s ) { return AddImageFilter().ExecuteInPlace( img1, s ); }
+inline Image &operator-=( Image &img1, const Image &img2 ) { return SubtractImageFilter().ExecuteInPlace( img1, img2 ); }
+inline Image &operator-=( Image &img1, double s ) { return SubtractImageFilter().ExecuteInPlace( img1, s ); }
+inline Image &operator*=( Image &img1, const Image &img2 ) { return MultiplyImageFilter().ExecuteInPlace( img1, img2 ); }
+inline Image &operator*=( Image &img1, double s ) { return MultiplyImageFilter().ExecuteInPlace( img1, s ); }
+inline Image &operator/=( Image &img1, const Image &img2 ) { return DivideImageFilter().ExecuteInPlace( img1, img2 ); }
+inline Image &operator/=( Image &img1, double s ) { return DivideImageFilter().ExecuteInPlace( img1, s ); }
+inline Image &operator%=( Image &img1, const Image &img2 ) { return ModulusImageFilter().ExecuteInPlace( img1, img2 ); }
+inline Image &operator%=( Image &img1, uint32_t s ) { return ModulusImageFilter().ExecuteInPlace( img1, s ); }
+inline Image &operator&=( Image &img1, const Image &img2 ) { return AndImageFilter().ExecuteInPlace( img1, img2 ); }
+inline Image &operator&=( Image &img1, int s ) { return AndImageFilter().ExecuteInPlace( img1, s ); }
+inline Image &operator|=( Image &img1, const Image &img2 ) { return OrImageFilter().ExecuteInPlace( img1, img2 ); }
+inline Image &operator|=( Image &img1, int s ) { return OrImageFilter().ExecuteInPlace( img1, s ); }
+inline Image &operator^=( Image &img1, const Image &img2 ) { return XorImageFilter().ExecuteInPlace( img1, img2 ); }
+inline Image &operator^=( Image &img1, int s ) { return XorImageFilter().ExecuteInPlace( img1, s ); }
 /**@} */
 }
 }
@@ -27,6 +27,7 @@
 #include "sitkDetail.h"
 #include "sitkVersion.h"
 #include "sitkImage.h"
+#include "sitkImageBufferPool.h"
 #include "sitkTransform.h"
 #include "sitkBSplineTransform.h"
 #include "sitkDisplacementFieldTransform.h"
@@ -23,6 +23,7 @@
 #include "sitkDetail.h"
 #include "sitkPixelIDTokens.h"
 #include "sitkEnableIf.h"
+#include "sitkInterpolator.h"
 
 #include "nsstd/type_traits.h"
 #include "nsstd/auto_ptr.h"
@@ -100,7 +101,7 @@ namespace simple
      * error or assertion will fail.
      *
      * The ITK image must be fully buffered, and must have a zero
-     * starting index for the Buffered/Largest regions.
+     * starting index for the Largest region.
      * @{
      */
     template <typename TImageType>
@@ -131,12 +132,28 @@ namespace simple
      * return an PixelID which identifies the image type which the
      * DataObject points to.
      *
+     * For a region view, the non-const method copies the region into
+     * a buffer of its own, and the const method returns a copy of the
+     * region which is kept with the view. Either way the ITK image has
+     * a buffer laid out as its largest possible region.
+     *
      * @{
      */
     itk::DataObject* GetITKBase( void );
     const itk::DataObject* GetITKBase( void ) const;
     /**@}*/
 
+    /** Get access to the internal ITK data object of a region view
+     * without copying it
+     *
+     * The buffered region of the ITK image is the buffer of the viewed
+     * image, which is larger than its largest possible region. It is
+     * only suitable for ITK filters which access their input through
+     * iterators over the requested region. For other images this is
+     * the same as GetITKBase.
+     */
+    const itk::DataObject* GetITKRegionViewBase( void ) const;
+
     // could return -1 if in valid
     PixelIDValueEnum GetPixelID( void ) const;
     PixelIDValueType GetPixelIDValue( void ) const;
@@ -329,6 +346,167 @@ namespace simple
 
     /** @} */
 
+    /** \brief Get the values of many pixels at once
+     *
+     * The indexes are given in one contiguous array of
+     * GetDimension() elements per pixel. The values are returned as
+     * doubles, with the components of a vector pixel stored
+     * consecutively, for any scalar or vector pixel type. This avoids
+     * the overhead of a call per pixel, notably in the wrapped
+     * languages.
+     *
+     * 64 bit integers beyond 2^53 are rounded, use the methods for
+     * the pixel type of the image below to get them exactly.
+     *
+     * An exception is thrown if any index is out of bounds, or for
+     * complex and label images.
+     */
+    std::vector<double> GetPixelsAsDouble( const std::vector<uint32_t> &indexes ) const;
+
+    /** \brief Set the values of many pixels at once
+     *
+     * The indexes and values are laid out as for GetPixelsAsDouble,
+     * the values are cast to the pixel type of the image. An
+     * exception is thrown if a value is not in the range of the pixel
+     * type, or is not a number for an integer pixel type.
+     */
+    void SetPixelsAsDouble( const std::vector<uint32_t> &indexes, const std::vector<double> &values );
+
+    /** \brief Get or set the values of many pixels at once, in the
+     * pixel type of the image
+     *
+     * The indexes and values are laid out as for GetPixelsAsDouble,
+     * but the values are not converted: 64 bit integers keep their
+     * full precision, and the values take no more memory than in the
+     * image. The correct method for the component type of the image
+     * must be called, otherwise an exception will be thrown.
+     *
+     * \sa Image::GetPixelIDValue
+     * @{
+     */
+    std::vector<int8_t>   GetPixelsAsInt8( const std::vector<uint32_t> &indexes ) const;
+    std::vector<uint8_t>  GetPixelsAsUInt8( const std::vector<uint32_t> &indexes ) const;
+    std::vector<int16_t>  GetPixelsAsInt16( const std::vector<uint32_t> &indexes ) const;
+    std::vector<uint16_t> GetPixelsAsUInt16( const std::vector<uint32_t> &indexes ) const;
+    std::vector<int32_t>  GetPixelsAsInt32( const std::vector<uint32_t> &indexes ) const;
+    std::vector<uint32_t> GetPixelsAsUInt32( const std::vector<uint32_t> &indexes ) const;
+    std::vector<int64_t>  GetPixelsAsInt64( const std::vector<uint32_t> &indexes ) const;
+    std::vector<uint64_t> GetPixelsAsUInt64( const std::vector<uint32_t> &indexes ) const;
+    std::vector<float>    GetPixelsAsFloat( const std::vector<uint32_t> &indexes ) const;
+
+    void SetPixelsAsInt8( const std::vector<uint32_t> &indexes, const std::vector<int8_t> &values );
+    void SetPixelsAsUInt8( const std::vector<uint32_t> &indexes, const std::vector<uint8_t> &values );
+    void SetPixelsAsInt16( const std::vector<uint32_t> &indexes, const std::vector<int16_t> &values );
+    void SetPixelsAsUInt16( const std::vector<uint32_t> &indexes, const std::vector<uint16_t> &values );
+    void SetPixelsAsInt32( const std::vector<uint32_t> &indexes, const std::vector<int32_t> &values );
+    void SetPixelsAsUInt32( const std::vector<uint32_t> &indexes, const std::vector<uint32_t> &values );
+    void SetPixelsAsInt64( const std::vector<uint32_t> &indexes, const std::vector<int64_t> &values );
+    void SetPixelsAsUInt64( const std::vector<uint32_t> &indexes, const std::vector<uint64_t> &values );
+    void SetPixelsAsFloat( const std::vector<uint32_t> &indexes, const std::vector<float> &values );
+    /** @} */
+
+    /** \brief Interpolate the image at many physical points at once
+     *
+     * The points are given in one contiguous array of GetDimension()
+     * coordinates per point, and the interpolated values are laid out
+     * as for GetPixelsAsDouble. Points more than half a pixel outside
+     * of the image get the default pixel value.
+     *
+     * Only sitkNearestNeighbor and sitkLinear are supported.
+     */
+    std::vector<double> EvaluateAtPhysicalPoints( const std::vector<double> &points,
+                                                  InterpolatorEnum interpolator = sitkLinear,
+                                                  double defaultPixelValue = 0.0 ) const;
+
+    /** \brief Copy a rectangular region of the image into an array
+     *
+     * The values of the region starting at index, of the given size,
+     * are returned as doubles with x varying fastest and the
+     * components of a vector pixel stored consecutively.
+     */
+    std::vector<double> GetRegionAsDouble( const std::vector<uint32_t> &index,
+                                           const std::vector<uint32_t> &size ) const;
+
+    /** \brief Copy an array into a rectangular region of the image
+     *
+     * The values are laid out as for GetRegionAsDouble, and are range
+     * checked as for SetPixelsAsDouble.
+     */
+    void SetRegionAsDouble( const std::vector<uint32_t> &index,
+                            const std::vector<uint32_t> &size,
+                            const std::vector<double> &values );
+
+    /** \brief Copy a rectangular region of the image to or from an
+     * array in the pixel type of the image
+     *
+     * The values are laid out as for GetRegionAsDouble, without
+     * conversion. The correct method for the component type of the
+     * image must be called, otherwise an exception will be thrown.
+     *
+     * \sa Image::GetPixelIDValue
+     * @{
+     */
+    std::vector<int8_t>   GetRegionAsInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const;
+    std::vector<uint8_t>  GetRegionAsUInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const;
+    std::vector<int16_t>  GetRegionAsInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const;
+    std::vector<uint16_t> GetRegionAsUInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const;
+    std::vector<int32_t>  GetRegionAsInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const;
+    std::vector<uint32_t> GetRegionAsUInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const;
+    std::vector<int64_t>  GetRegionAsInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const;
+    std::vector<uint64_t> GetRegionAsUInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const;
+    std::vector<float>    GetRegionAsFloat( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const;
+
+    void SetRegionAsInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<int8_t> &values );
+    void SetRegionAsUInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<uint8_t> &values );
+    void SetRegionAsInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<int16_t> &values );
+    void SetRegionAsUInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<uint16_t> &values );
+    void SetRegionAsInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<int32_t> &values );
+    void SetRegionAsUInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<uint32_t> &values );
+    void SetRegionAsInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<int64_t> &values );
+    void SetRegionAsUInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<uint64_t> &values );
+    void SetRegionAsFloat( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<float> &values );
+    /** @} */
+
+    /** \brief Get a view of a rectangular region of the image,
+     * without copying its pixels
+     *
+     * The view refers to the pixel buffer of this image and keeps it
+     * alive. Its origin is the physical point of index, so its pixels
+     * are at the same physical locations as in this image.
+     *
+     * Pixel-wise filters, such as the arithmetic ones, read a view in
+     * place. Other filters, the image writer, and the GetBuffer
+     * methods of a const view use a contiguous copy of the region,
+     * which is made once and kept with the view. Modifying the view
+     * copies the region into a buffer of its own first. Modifying this
+     * image copies its buffer, so the view never changes.
+     *
+     * Region views of label map images are not supported.
+     */
+    Image GetRegionView( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const;
+
+    /** \brief Returns true if the image is a region view of the
+     * buffer of another image. */
+    bool IsRegionView( void ) const;
+
+    /** \brief Layout of the buffer a region view refers to
+     *
+     * GetRegionViewBuffer returns the address of the buffer, which
+     * has the size GetRegionViewBufferSize and is laid out as
+     * described for GetBufferAsUInt8. GetRegionViewIndex is the index
+     * in that buffer of the first pixel of the view. For an image
+     * which is not a view the index is zero and the size is that of
+     * the image.
+     *
+     * These methods do not copy the buffer, they are intended for
+     * interfaces which support strided memory.
+     * @{
+     */
+    std::vector<uint32_t> GetRegionViewIndex( void ) const;
+    std::vector<uint32_t> GetRegionViewBufferSize( void ) const;
+    const void *GetRegionViewBuffer( void ) const;
+    /** @} */
+
    /** \brief Get a pointer to the image buffer
      * \warning this is dangerous
      *
@@ -381,9 +559,16 @@ namespace simple
      * The Image class by default performs lazy coping and
      * assignment. This method make sure that coping actually happens
      * to the itk::Image pointed to is only pointed to by this object.
+     * A region view is copied into a buffer of its own.
      */
     void MakeUnique( void );
 
+    /** \brief Returns true if no other image shares the itk::Image
+     * or the pixel container of this object. Region views are never
+     * unique.
+     */
+    bool IsUnique( void ) const;
+
   protected:
 
     /** \brief Methods called by the constructor to allocate and initialize
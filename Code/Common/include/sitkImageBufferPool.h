@@ -0,0 +1,100 @@
+/*=========================================================================
+*
+*  Copyright Insight Software Consortium
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef __sitkImageBufferPool_h
+#define __sitkImageBufferPool_h
+
+#include "sitkCommon.h"
+
+namespace itk
+{
+
+namespace simple
+{
+
+  /** \class ImageBufferPool
+   * \brief Process wide pool of image pixel buffers
+   *
+   * When enabled, the pixel buffers of images created afterwards,
+   * including the outputs of filters and procedural methods, are
+   * drawn from a pool and returned to it when the last image
+   * referring to them is destroyed. Pipelines that repeatedly
+   * produce images of the same size then reuse a few buffers instead
+   * of mapping and unmapping memory for every intermediate result.
+   *
+   * Buffers are grouped in size classes of eight per power of two,
+   * so a request is served by an idle buffer at most 12.5% larger.
+   * Buffers smaller than the minimum buffer size are left to the
+   * regular allocator. Label map images are not pooled.
+   *
+   * The pool is disabled by default. Disabling it releases the idle
+   * buffers, buffers still in use are freed when their images are.
+   */
+  class SITKCommon_EXPORT ImageBufferPool
+  {
+  public:
+
+    /** Enable or disable pooling for images allocated from now on.
+     * @{
+     */
+    static void SetEnabled( bool enabled );
+    static bool GetEnabled( void );
+    static void EnabledOn( void );
+    static void EnabledOff( void );
+    /**@}*/
+
+    /** Total size in bytes of the idle buffers kept for reuse. A
+     * buffer that is returned while the pool is full is freed. A
+     * smaller limit frees the largest idle buffers until the pool
+     * fits. The default does not limit the pool.
+     * @{
+     */
+    static void SetMaximumIdleSize( uint64_t maximumIdleSize );
+    static uint64_t GetMaximumIdleSize( void );
+    /**@}*/
+
+    /** Size in bytes below which buffers are not pooled, 64 KiB by
+     * default.
+     * @{
+     */
+    static void SetMinimumBufferSize( uint64_t minimumBufferSize );
+    static uint64_t GetMinimumBufferSize( void );
+    /**@}*/
+
+    /** Free all idle buffers. */
+    static void Trim( void );
+
+    /** Statistics of the pool. Allocations counts the buffers handed
+     * out, reuses those of them that were served by an idle buffer.
+     * @{
+     */
+    static uint64_t GetNumberOfAllocations( void );
+    static uint64_t GetNumberOfReuses( void );
+    static uint64_t GetNumberOfBuffersInUse( void );
+    static uint64_t GetSizeInUse( void );
+    static uint64_t GetNumberOfIdleBuffers( void );
+    static uint64_t GetIdleSize( void );
+    static void ResetStatistics( void );
+    /**@}*/
+
+    static std::string ToString( void );
+  };
+
+}
+}
+
+#endif
@@ -266,6 +266,8 @@ namespace itk {
       #endif
 
 
+      /** Cast an image to ITK, a region view is cast as a copy
+       * whose buffer is laid out as the image. */
       template< class TImageType >
         static typename TImageType::ConstPointer CastImageToITK( const Image &img )
       {
@@ -279,6 +281,22 @@ namespace itk {
         return itkImage;
       }
 
+      /** Cast an image to ITK without copying a region view, for
+       * pixel-wise filters which only access their input through
+       * iterators over the requested region. */
+      template< class TImageType >
+        static typename TImageType::ConstPointer CastImageViewToITK( const Image &img )
+      {
+        typename TImageType::ConstPointer itkImage =
+          dynamic_cast < const TImageType* > ( img.GetITKRegionViewBase() );
+
+        if ( itkImage.IsNull() )
+          {
+          sitkExceptionMacro( "Unexpected template dispatch error!" );
+          }
+        return itkImage;
+      }
+
       template< class TImageType >
         static Image CastITKToImage( TImageType *img )
       {
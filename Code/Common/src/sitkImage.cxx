@@ -98,6 +98,12 @@ namespace itk
     }
 
     const itk::DataObject* Image::GetITKBase( void ) const
+    {
+      assert( m_PimpleImage );
+      return m_PimpleImage->GetContiguousDataBase();
+    }
+
+    const itk::DataObject* Image::GetITKRegionViewBase( void ) const
     {
       assert( m_PimpleImage );
       return m_PimpleImage->GetDataBase();
@@ -715,10 +721,308 @@ namespace itk
       this->m_PimpleImage->SetPixelAsComplexFloat64( idx, v );
     }
 
+    std::vector<double> Image::GetPixelsAsDouble( const std::vector<uint32_t> &indexes ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetPixelsAsDouble( indexes );
+    }
+
+    void Image::SetPixelsAsDouble( const std::vector<uint32_t> &indexes, const std::vector<double> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetPixelsAsDouble( indexes, values );
+    }
+
+    std::vector<int8_t> Image::GetPixelsAsInt8( const std::vector<uint32_t> &indexes ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetPixelsAsInt8( indexes );
+    }
+
+    std::vector<uint8_t> Image::GetPixelsAsUInt8( const std::vector<uint32_t> &indexes ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetPixelsAsUInt8( indexes );
+    }
+
+    std::vector<int16_t> Image::GetPixelsAsInt16( const std::vector<uint32_t> &indexes ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetPixelsAsInt16( indexes );
+    }
+
+    std::vector<uint16_t> Image::GetPixelsAsUInt16( const std::vector<uint32_t> &indexes ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetPixelsAsUInt16( indexes );
+    }
+
+    std::vector<int32_t> Image::GetPixelsAsInt32( const std::vector<uint32_t> &indexes ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetPixelsAsInt32( indexes );
+    }
+
+    std::vector<uint32_t> Image::GetPixelsAsUInt32( const std::vector<uint32_t> &indexes ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetPixelsAsUInt32( indexes );
+    }
+
+    std::vector<int64_t> Image::GetPixelsAsInt64( const std::vector<uint32_t> &indexes ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetPixelsAsInt64( indexes );
+    }
+
+    std::vector<uint64_t> Image::GetPixelsAsUInt64( const std::vector<uint32_t> &indexes ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetPixelsAsUInt64( indexes );
+    }
+
+    std::vector<float> Image::GetPixelsAsFloat( const std::vector<uint32_t> &indexes ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetPixelsAsFloat( indexes );
+    }
+
+    void Image::SetPixelsAsInt8( const std::vector<uint32_t> &indexes, const std::vector<int8_t> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetPixelsAsInt8( indexes, values );
+    }
+
+    void Image::SetPixelsAsUInt8( const std::vector<uint32_t> &indexes, const std::vector<uint8_t> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetPixelsAsUInt8( indexes, values );
+    }
+
+    void Image::SetPixelsAsInt16( const std::vector<uint32_t> &indexes, const std::vector<int16_t> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetPixelsAsInt16( indexes, values );
+    }
+
+    void Image::SetPixelsAsUInt16( const std::vector<uint32_t> &indexes, const std::vector<uint16_t> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetPixelsAsUInt16( indexes, values );
+    }
+
+    void Image::SetPixelsAsInt32( const std::vector<uint32_t> &indexes, const std::vector<int32_t> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetPixelsAsInt32( indexes, values );
+    }
+
+    void Image::SetPixelsAsUInt32( const std::vector<uint32_t> &indexes, const std::vector<uint32_t> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetPixelsAsUInt32( indexes, values );
+    }
+
+    void Image::SetPixelsAsInt64( const std::vector<uint32_t> &indexes, const std::vector<int64_t> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetPixelsAsInt64( indexes, values );
+    }
+
+    void Image::SetPixelsAsUInt64( const std::vector<uint32_t> &indexes, const std::vector<uint64_t> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetPixelsAsUInt64( indexes, values );
+    }
+
+    void Image::SetPixelsAsFloat( const std::vector<uint32_t> &indexes, const std::vector<float> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetPixelsAsFloat( indexes, values );
+    }
+
+    std::vector<double> Image::EvaluateAtPhysicalPoints( const std::vector<double> &points,
+                                                         InterpolatorEnum interpolator,
+                                                         double defaultPixelValue ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->EvaluateAtPhysicalPoints( points, interpolator, defaultPixelValue );
+    }
+
+    std::vector<double> Image::GetRegionAsDouble( const std::vector<uint32_t> &index,
+                                                  const std::vector<uint32_t> &size ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetRegionAsDouble( index, size );
+    }
+
+    void Image::SetRegionAsDouble( const std::vector<uint32_t> &index,
+                                   const std::vector<uint32_t> &size,
+                                   const std::vector<double> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetRegionAsDouble( index, size, values );
+    }
+
+    std::vector<int8_t> Image::GetRegionAsInt8( const std::vector<uint32_t> &index,
+                                                const std::vector<uint32_t> &size ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetRegionAsInt8( index, size );
+    }
+
+    std::vector<uint8_t> Image::GetRegionAsUInt8( const std::vector<uint32_t> &index,
+                                                  const std::vector<uint32_t> &size ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetRegionAsUInt8( index, size );
+    }
+
+    std::vector<int16_t> Image::GetRegionAsInt16( const std::vector<uint32_t> &index,
+                                                  const std::vector<uint32_t> &size ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetRegionAsInt16( index, size );
+    }
+
+    std::vector<uint16_t> Image::GetRegionAsUInt16( const std::vector<uint32_t> &index,
+                                                    const std::vector<uint32_t> &size ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetRegionAsUInt16( index, size );
+    }
+
+    std::vector<int32_t> Image::GetRegionAsInt32( const std::vector<uint32_t> &index,
+                                                  const std::vector<uint32_t> &size ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetRegionAsInt32( index, size );
+    }
+
+    std::vector<uint32_t> Image::GetRegionAsUInt32( const std::vector<uint32_t> &index,
+                                                    const std::vector<uint32_t> &size ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetRegionAsUInt32( index, size );
+    }
+
+    std::vector<int64_t> Image::GetRegionAsInt64( const std::vector<uint32_t> &index,
+                                                  const std::vector<uint32_t> &size ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetRegionAsInt64( index, size );
+    }
+
+    std::vector<uint64_t> Image::GetRegionAsUInt64( const std::vector<uint32_t> &index,
+                                                    const std::vector<uint32_t> &size ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetRegionAsUInt64( index, size );
+    }
+
+    std::vector<float> Image::GetRegionAsFloat( const std::vector<uint32_t> &index,
+                                                const std::vector<uint32_t> &size ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetRegionAsFloat( index, size );
+    }
+
+    void Image::SetRegionAsInt8( const std::vector<uint32_t> &index,
+                                 const std::vector<uint32_t> &size,
+                                 const std::vector<int8_t> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetRegionAsInt8( index, size, values );
+    }
+
+    void Image::SetRegionAsUInt8( const std::vector<uint32_t> &index,
+                                  const std::vector<uint32_t> &size,
+                                  const std::vector<uint8_t> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetRegionAsUInt8( index, size, values );
+    }
+
+    void Image::SetRegionAsInt16( const std::vector<uint32_t> &index,
+                                  const std::vector<uint32_t> &size,
+                                  const std::vector<int16_t> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetRegionAsInt16( index, size, values );
+    }
+
+    void Image::SetRegionAsUInt16( const std::vector<uint32_t> &index,
+                                   const std::vector<uint32_t> &size,
+                                   const std::vector<uint16_t> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetRegionAsUInt16( index, size, values );
+    }
+
+    void Image::SetRegionAsInt32( const std::vector<uint32_t> &index,
+                                  const std::vector<uint32_t> &size,
+                                  const std::vector<int32_t> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetRegionAsInt32( index, size, values );
+    }
+
+    void Image::SetRegionAsUInt32( const std::vector<uint32_t> &index,
+                                   const std::vector<uint32_t> &size,
+                                   const std::vector<uint32_t> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetRegionAsUInt32( index, size, values );
+    }
+
+    void Image::SetRegionAsInt64( const std::vector<uint32_t> &index,
+                                  const std::vector<uint32_t> &size,
+                                  const std::vector<int64_t> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetRegionAsInt64( index, size, values );
+    }
+
+    void Image::SetRegionAsUInt64( const std::vector<uint32_t> &index,
+                                   const std::vector<uint32_t> &size,
+                                   const std::vector<uint64_t> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetRegionAsUInt64( index, size, values );
+    }
+
+    void Image::SetRegionAsFloat( const std::vector<uint32_t> &index,
+                                  const std::vector<uint32_t> &size,
+                                  const std::vector<float> &values )
+    {
+      assert( m_PimpleImage );
+      this->MakeUnique();
+      this->m_PimpleImage->SetRegionAsFloat( index, size, values );
+    }
+
 
     void Image::MakeUnique( void )
     {
-      if ( this->m_PimpleImage->GetReferenceCountOfImage() > 1 )
+      if ( !this->IsUnique() )
         {
         // note: care is take here to be exception safe with memory allocation
         nsstd::auto_ptr<PimpleImageBase> temp( this->m_PimpleImage->DeepCopy() );
@@ -727,5 +1031,48 @@ namespace itk
         }
 
     }
+
+    bool Image::IsUnique( void ) const
+    {
+      // ITK images, e.g. of an import or a graft, may share the pixel
+      // container without sharing the itk::Image
+      return this->m_PimpleImage->GetReferenceCountOfImage() == 1
+        && this->m_PimpleImage->GetReferenceCountOfPixelContainer() == 1
+        && !this->m_PimpleImage->IsRegionView();
+    }
+
+    Image Image::GetRegionView( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const
+    {
+      assert( m_PimpleImage );
+      Image view;
+      nsstd::auto_ptr<PimpleImageBase> temp( this->m_PimpleImage->RegionView( index, size ) );
+      delete view.m_PimpleImage;
+      view.m_PimpleImage = temp.release();
+      return view;
+    }
+
+    bool Image::IsRegionView( void ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->IsRegionView();
+    }
+
+    std::vector<uint32_t> Image::GetRegionViewIndex( void ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetRegionViewIndex();
+    }
+
+    std::vector<uint32_t> Image::GetRegionViewBufferSize( void ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetRegionViewBufferSize();
+    }
+
+    const void *Image::GetRegionViewBuffer( void ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->GetRegionViewBuffer();
+    }
   } // end namespace simple
 } // end namespace itk
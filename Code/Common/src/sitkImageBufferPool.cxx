@@ -0,0 +1,480 @@
+/*=========================================================================
+*
+*  Copyright Insight Software Consortium
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkImageBufferPool.h"
+
+#include "itkImportImageContainer.h"
+#include "itkObjectFactoryBase.h"
+#include "itkCreateObjectFunction.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkVersion.h"
+
+#include <complex>
+#include <cstring>
+#include <map>
+#include <new>
+#include <typeinfo>
+#include <vector>
+
+namespace
+{
+
+// The buffers of the pool and their bookkeeping. All members are
+// guarded by Mutex.
+struct BufferPool
+{
+  typedef std::map< uint64_t, std::vector< void * > > IdleBuffersType;
+  typedef std::map< void *, uint64_t >                BuffersInUseType;
+
+  BufferPool( void )
+    : Enabled( false ),
+      MaximumIdleSize( std::numeric_limits< uint64_t >::max() ),
+      MinimumBufferSize( 64u * 1024u ),
+      NumberOfAllocations( 0 ),
+      NumberOfReuses( 0 ),
+      SizeInUse( 0 ),
+      NumberOfIdleBuffers( 0 ),
+      IdleSize( 0 )
+  {
+  }
+
+  // Round up to one of eight size classes per power of two
+  static uint64_t GetSizeClass( uint64_t size )
+  {
+    unsigned int exponent = 0;
+    while ( ( uint64_t( 1 ) << ( exponent + 1 ) ) <= size )
+      {
+      ++exponent;
+      }
+    const uint64_t step = exponent > 3 ? uint64_t( 1 ) << ( exponent - 3 ) : 1u;
+    return ( ( size + step - 1 ) / step ) * step;
+  }
+
+  // Reads a member under the mutex
+  uint64_t Get( uint64_t BufferPool::*member )
+  {
+    this->Mutex.Lock();
+    const uint64_t value = this->*member;
+    this->Mutex.Unlock();
+    return value;
+  }
+
+  void * Allocate( uint64_t size )
+  {
+    this->Mutex.Lock();
+    const uint64_t minimumBufferSize = this->MinimumBufferSize;
+    this->Mutex.Unlock();
+
+    if ( size < minimumBufferSize || size > std::numeric_limits< size_t >::max() )
+      {
+      return NULL;
+      }
+
+    const uint64_t sizeClass = GetSizeClass( size );
+    void * buffer = NULL;
+
+    this->Mutex.Lock();
+    IdleBuffersType::iterator idle = this->IdleBuffers.find( sizeClass );
+    if ( idle != this->IdleBuffers.end() && !idle->second.empty() )
+      {
+      buffer = idle->second.back();
+      idle->second.pop_back();
+      --this->NumberOfIdleBuffers;
+      this->IdleSize -= sizeClass;
+      ++this->NumberOfReuses;
+      }
+    this->Mutex.Unlock();
+
+    if ( buffer == NULL )
+      {
+      buffer = ::operator new( static_cast< size_t >( sizeClass ), std::nothrow );
+      if ( buffer == NULL )
+        {
+        // Make room by giving the idle buffers back before failing
+        this->Trim( 0 );
+        buffer = ::operator new( static_cast< size_t >( sizeClass ), std::nothrow );
+        if ( buffer == NULL )
+          {
+          return NULL;
+          }
+        }
+      }
+
+    this->Mutex.Lock();
+    this->BuffersInUse[buffer] = sizeClass;
+    ++this->NumberOfAllocations;
+    this->SizeInUse += sizeClass;
+    this->Mutex.Unlock();
+
+    return buffer;
+  }
+
+  // Returns false for buffers that did not come from the pool
+  bool Release( void * buffer )
+  {
+    this->Mutex.Lock();
+    BuffersInUseType::iterator inUse = this->BuffersInUse.find( buffer );
+    if ( inUse == this->BuffersInUse.end() )
+      {
+      this->Mutex.Unlock();
+      return false;
+      }
+
+    const uint64_t sizeClass = inUse->second;
+    this->BuffersInUse.erase( inUse );
+    this->SizeInUse -= sizeClass;
+
+    const bool keep = this->Enabled
+      && sizeClass <= this->MaximumIdleSize
+      && this->IdleSize <= this->MaximumIdleSize - sizeClass;
+    if ( keep )
+      {
+      this->IdleBuffers[sizeClass].push_back( buffer );
+      ++this->NumberOfIdleBuffers;
+      this->IdleSize += sizeClass;
+      }
+    this->Mutex.Unlock();
+
+    if ( !keep )
+      {
+      ::operator delete( buffer );
+      }
+    return true;
+  }
+
+  // Frees idle buffers, the largest first, until at most
+  // maximumIdleSize bytes are left
+  void Trim( uint64_t maximumIdleSize )
+  {
+    std::vector< void * > buffers;
+
+    this->Mutex.Lock();
+    IdleBuffersType::iterator idle = this->IdleBuffers.end();
+    while ( this->IdleSize > maximumIdleSize && idle != this->IdleBuffers.begin() )
+      {
+      --idle;
+      while ( this->IdleSize > maximumIdleSize && !idle->second.empty() )
+        {
+        buffers.push_back( idle->second.back() );
+        idle->second.pop_back();
+        --this->NumberOfIdleBuffers;
+        this->IdleSize -= idle->first;
+        }
+      }
+    this->Mutex.Unlock();
+
+    for ( size_t i = 0; i < buffers.size(); ++i )
+      {
+      ::operator delete( buffers[i] );
+      }
+  }
+
+  itk::SimpleFastMutexLock Mutex;
+
+  bool             Enabled;
+  uint64_t         MaximumIdleSize;
+  uint64_t         MinimumBufferSize;
+
+  IdleBuffersType  IdleBuffers;
+  BuffersInUseType BuffersInUse;
+
+  uint64_t         NumberOfAllocations;
+  uint64_t         NumberOfReuses;
+  uint64_t         SizeInUse;
+  uint64_t         NumberOfIdleBuffers;
+  uint64_t         IdleSize;
+};
+
+// Never destroyed, images held in static variables may outlive any
+// static pool
+BufferPool & GetBufferPool( void )
+{
+  static BufferPool * pool = new BufferPool;
+  return *pool;
+}
+
+// Pixel container of itk::Image and itk::VectorImage that draws its
+// memory from the pool. Memory imported with SetImportPointer() is
+// left to the default container behavior.
+template< typename TElementIdentifier, typename TElement >
+class PooledImportImageContainer
+  : public itk::ImportImageContainer< TElementIdentifier, TElement >
+{
+public:
+  typedef PooledImportImageContainer                                  Self;
+  typedef itk::ImportImageContainer< TElementIdentifier, TElement >   Superclass;
+  typedef itk::SmartPointer< Self >                                   Pointer;
+  typedef itk::SmartPointer< const Self >                             ConstPointer;
+  typedef typename Superclass::ElementIdentifier                      ElementIdentifier;
+
+  itkFactorylessNewMacro( Self );
+  itkTypeMacro( PooledImportImageContainer, ImportImageContainer );
+
+protected:
+  PooledImportImageContainer( void ) {}
+
+  virtual ~PooledImportImageContainer( void )
+  {
+    // The destructor of the superclass would not call the override
+    this->DeallocateManagedMemory();
+  }
+
+  virtual TElement * AllocateElements( ElementIdentifier size, bool UseDefaultConstructor = false ) const
+  {
+    void * buffer = GetBufferPool().Allocate( static_cast< uint64_t >( size ) * sizeof( TElement ) );
+    if ( buffer == NULL )
+      {
+      return Superclass::AllocateElements( size, UseDefaultConstructor );
+      }
+    if ( UseDefaultConstructor )
+      {
+      std::memset( buffer, 0, static_cast< size_t >( size ) * sizeof( TElement ) );
+      }
+    return static_cast< TElement * >( buffer );
+  }
+
+  virtual void DeallocateManagedMemory( void )
+  {
+    TElement * buffer = this->GetImportPointer();
+    if ( buffer != NULL && this->GetContainerManageMemory() && GetBufferPool().Release( buffer ) )
+      {
+      // Let the superclass reset its state without deleting the buffer
+      this->SetContainerManageMemory( false );
+      Superclass::DeallocateManagedMemory();
+      this->SetContainerManageMemory( true );
+      }
+    else
+      {
+      Superclass::DeallocateManagedMemory();
+      }
+  }
+
+private:
+  PooledImportImageContainer( const Self & ); // purposely not implemented
+  void operator=( const Self & );             // purposely not implemented
+};
+
+// Replaces the pixel containers of all pixel types SimpleITK uses
+// while it is registered with the ITK object factory
+class PooledImportImageContainerFactory
+  : public itk::ObjectFactoryBase
+{
+public:
+  typedef PooledImportImageContainerFactory Self;
+  typedef itk::ObjectFactoryBase            Superclass;
+  typedef itk::SmartPointer< Self >         Pointer;
+  typedef itk::SmartPointer< const Self >   ConstPointer;
+
+  itkFactorylessNewMacro( Self );
+  itkTypeMacro( PooledImportImageContainerFactory, ObjectFactoryBase );
+
+  virtual const char * GetITKSourceVersion( void ) const
+  {
+    return ITK_SOURCE_VERSION;
+  }
+
+  virtual const char * GetDescription( void ) const
+  {
+    return "SimpleITK pooled image buffers";
+  }
+
+protected:
+  PooledImportImageContainerFactory( void )
+  {
+    this->RegisterContainer< int8_t >();
+    this->RegisterContainer< uint8_t >();
+    this->RegisterContainer< int16_t >();
+    this->RegisterContainer< uint16_t >();
+    this->RegisterContainer< int32_t >();
+    this->RegisterContainer< uint32_t >();
+    this->RegisterContainer< int64_t >();
+    this->RegisterContainer< uint64_t >();
+    this->RegisterContainer< float >();
+    this->RegisterContainer< double >();
+    this->RegisterContainer< std::complex< float > >();
+    this->RegisterContainer< std::complex< double > >();
+  }
+
+  template< typename TElement >
+  void RegisterContainer( void )
+  {
+    typedef itk::ImportImageContainer< itk::SizeValueType, TElement >     ContainerType;
+    typedef PooledImportImageContainer< itk::SizeValueType, TElement >    PooledContainerType;
+
+    this->RegisterOverride( typeid( ContainerType ).name(),
+                            typeid( PooledContainerType ).name(),
+                            "Pooled image buffer",
+                            true,
+                            itk::CreateObjectFunction< PooledContainerType >::New() );
+  }
+
+private:
+  PooledImportImageContainerFactory( const Self & ); // purposely not implemented
+  void operator=( const Self & );                    // purposely not implemented
+};
+
+PooledImportImageContainerFactory::Pointer PooledContainerFactory;
+
+}
+
+namespace itk
+{
+namespace simple
+{
+
+void ImageBufferPool::SetEnabled( bool enabled )
+{
+  BufferPool & pool = GetBufferPool();
+
+  pool.Mutex.Lock();
+  const bool changed = pool.Enabled != enabled;
+  pool.Enabled = enabled;
+  pool.Mutex.Unlock();
+
+  if ( !changed )
+    {
+    return;
+    }
+
+  if ( enabled )
+    {
+    if ( PooledContainerFactory.IsNull() )
+      {
+      PooledContainerFactory = PooledImportImageContainerFactory::New();
+      }
+    itk::ObjectFactoryBase::RegisterFactory( PooledContainerFactory );
+    }
+  else
+    {
+    itk::ObjectFactoryBase::UnRegisterFactory( PooledContainerFactory );
+    pool.Trim( 0 );
+    }
+}
+
+bool ImageBufferPool::GetEnabled( void )
+{
+  BufferPool & pool = GetBufferPool();
+  pool.Mutex.Lock();
+  const bool enabled = pool.Enabled;
+  pool.Mutex.Unlock();
+  return enabled;
+}
+
+void ImageBufferPool::EnabledOn( void )
+{
+  ImageBufferPool::SetEnabled( true );
+}
+
+void ImageBufferPool::EnabledOff( void )
+{
+  ImageBufferPool::SetEnabled( false );
+}
+
+void ImageBufferPool::SetMaximumIdleSize( uint64_t maximumIdleSize )
+{
+  BufferPool & pool = GetBufferPool();
+  pool.Mutex.Lock();
+  pool.MaximumIdleSize = maximumIdleSize;
+  pool.Mutex.Unlock();
+
+  pool.Trim( maximumIdleSize );
+}
+
+uint64_t ImageBufferPool::GetMaximumIdleSize( void )
+{
+  return GetBufferPool().Get( &BufferPool::MaximumIdleSize );
+}
+
+void ImageBufferPool::SetMinimumBufferSize( uint64_t minimumBufferSize )
+{
+  BufferPool & pool = GetBufferPool();
+  pool.Mutex.Lock();
+  pool.MinimumBufferSize = minimumBufferSize;
+  pool.Mutex.Unlock();
+}
+
+uint64_t ImageBufferPool::GetMinimumBufferSize( void )
+{
+  return GetBufferPool().Get( &BufferPool::MinimumBufferSize );
+}
+
+void ImageBufferPool::Trim( void )
+{
+  GetBufferPool().Trim( 0 );
+}
+
+uint64_t ImageBufferPool::GetNumberOfAllocations( void )
+{
+  return GetBufferPool().Get( &BufferPool::NumberOfAllocations );
+}
+
+uint64_t ImageBufferPool::GetNumberOfReuses( void )
+{
+  return GetBufferPool().Get( &BufferPool::NumberOfReuses );
+}
+
+uint64_t ImageBufferPool::GetNumberOfBuffersInUse( void )
+{
+  BufferPool & pool = GetBufferPool();
+  pool.Mutex.Lock();
+  const uint64_t numberOfBuffersInUse = pool.BuffersInUse.size();
+  pool.Mutex.Unlock();
+  return numberOfBuffersInUse;
+}
+
+uint64_t ImageBufferPool::GetSizeInUse( void )
+{
+  return GetBufferPool().Get( &BufferPool::SizeInUse );
+}
+
+uint64_t ImageBufferPool::GetNumberOfIdleBuffers( void )
+{
+  return GetBufferPool().Get( &BufferPool::NumberOfIdleBuffers );
+}
+
+uint64_t ImageBufferPool::GetIdleSize( void )
+{
+  return GetBufferPool().Get( &BufferPool::IdleSize );
+}
+
+void ImageBufferPool::ResetStatistics( void )
+{
+  BufferPool & pool = GetBufferPool();
+  pool.Mutex.Lock();
+  pool.NumberOfAllocations = 0;
+  pool.NumberOfReuses = 0;
+  pool.Mutex.Unlock();
+}
+
+std::string ImageBufferPool::ToString( void )
+{
+  std::ostringstream out;
+  out << "ImageBufferPool" << std::endl
+      << "  Enabled: " << ImageBufferPool::GetEnabled() << std::endl
+      << "  MaximumIdleSize: " << ImageBufferPool::GetMaximumIdleSize() << std::endl
+      << "  MinimumBufferSize: " << ImageBufferPool::GetMinimumBufferSize() << std::endl
+      << "  NumberOfAllocations: " << ImageBufferPool::GetNumberOfAllocations() << std::endl
+      << "  NumberOfReuses: " << ImageBufferPool::GetNumberOfReuses() << std::endl
+      << "  NumberOfBuffersInUse: " << ImageBufferPool::GetNumberOfBuffersInUse() << std::endl
+      << "  SizeInUse: " << ImageBufferPool::GetSizeInUse() << std::endl
+      << "  NumberOfIdleBuffers: " << ImageBufferPool::GetNumberOfIdleBuffers() << std::endl
+      << "  IdleSize: " << ImageBufferPool::GetIdleSize() << std::endl;
+  return out.str();
+}
+
+}
+}
@@ -21,6 +21,7 @@
 #include <vector>
 #include "sitkPixelIDTokens.h"
 #include "sitkTemplateFunctions.h"
+#include "sitkInterpolator.h"
 
 namespace itk
 {
@@ -50,6 +51,13 @@ namespace itk
     virtual PimpleImageBase *DeepCopy(void) const = 0;
     virtual itk::DataObject* GetDataBase( void ) = 0;
     virtual const itk::DataObject* GetDataBase( void ) const = 0;
+    virtual const itk::DataObject* GetContiguousDataBase( void ) const = 0;
+
+    virtual PimpleImageBase *RegionView( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const = 0;
+    virtual bool IsRegionView( void ) const = 0;
+    virtual std::vector<uint32_t> GetRegionViewIndex( void ) const = 0;
+    virtual std::vector<uint32_t> GetRegionViewBufferSize( void ) const = 0;
+    virtual const void *GetRegionViewBuffer( void ) const = 0;
 
     virtual unsigned int GetWidth( void ) const { return this->GetSize( 0 ); }
     virtual unsigned int GetHeight( void ) const { return this->GetSize( 1 ); }
@@ -75,6 +83,7 @@ namespace itk
 
 
     virtual int GetReferenceCountOfImage() const = 0;
+    virtual int GetReferenceCountOfPixelContainer() const = 0;
 
     virtual int8_t   GetPixelAsInt8( const std::vector<uint32_t> &idx) const = 0;
     virtual uint8_t  GetPixelAsUInt8( const std::vector<uint32_t> &idx) const = 0;
@@ -148,6 +157,52 @@ namespace itk
     virtual const uint64_t *GetBufferAsUInt64( ) const = 0;
     virtual const float    *GetBufferAsFloat( ) const = 0;
     virtual const double   *GetBufferAsDouble( ) const = 0;
+
+    virtual std::vector<double> GetPixelsAsDouble( const std::vector<uint32_t> &indexes ) const = 0;
+    virtual void SetPixelsAsDouble( const std::vector<uint32_t> &indexes, const std::vector<double> &values ) = 0;
+    virtual std::vector<double> EvaluateAtPhysicalPoints( const std::vector<double> &points, InterpolatorEnum interpolator, double defaultPixelValue ) const = 0;
+    virtual std::vector<double> GetRegionAsDouble( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const = 0;
+    virtual void SetRegionAsDouble( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<double> &values ) = 0;
+
+    virtual std::vector<int8_t> GetPixelsAsInt8( const std::vector<uint32_t> &indexes ) const = 0;
+    virtual std::vector<uint8_t> GetPixelsAsUInt8( const std::vector<uint32_t> &indexes ) const = 0;
+    virtual std::vector<int16_t> GetPixelsAsInt16( const std::vector<uint32_t> &indexes ) const = 0;
+    virtual std::vector<uint16_t> GetPixelsAsUInt16( const std::vector<uint32_t> &indexes ) const = 0;
+    virtual std::vector<int32_t> GetPixelsAsInt32( const std::vector<uint32_t> &indexes ) const = 0;
+    virtual std::vector<uint32_t> GetPixelsAsUInt32( const std::vector<uint32_t> &indexes ) const = 0;
+    virtual std::vector<int64_t> GetPixelsAsInt64( const std::vector<uint32_t> &indexes ) const = 0;
+    virtual std::vector<uint64_t> GetPixelsAsUInt64( const std::vector<uint32_t> &indexes ) const = 0;
+    virtual std::vector<float> GetPixelsAsFloat( const std::vector<uint32_t> &indexes ) const = 0;
+
+    virtual void SetPixelsAsInt8( const std::vector<uint32_t> &indexes, const std::vector<int8_t> &values ) = 0;
+    virtual void SetPixelsAsUInt8( const std::vector<uint32_t> &indexes, const std::vector<uint8_t> &values ) = 0;
+    virtual void SetPixelsAsInt16( const std::vector<uint32_t> &indexes, const std::vector<int16_t> &values ) = 0;
+    virtual void SetPixelsAsUInt16( const std::vector<uint32_t> &indexes, const std::vector<uint16_t> &values ) = 0;
+    virtual void SetPixelsAsInt32( const std::vector<uint32_t> &indexes, const std::vector<int32_t> &values ) = 0;
+    virtual void SetPixelsAsUInt32( const std::vector<uint32_t> &indexes, const std::vector<uint32_t> &values ) = 0;
+    virtual void SetPixelsAsInt64( const std::vector<uint32_t> &indexes, const std::vector<int64_t> &values ) = 0;
+    virtual void SetPixelsAsUInt64( const std::vector<uint32_t> &indexes, const std::vector<uint64_t> &values ) = 0;
+    virtual void SetPixelsAsFloat( const std::vector<uint32_t> &indexes, const std::vector<float> &values ) = 0;
+
+    virtual std::vector<int8_t> GetRegionAsInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const = 0;
+    virtual std::vector<uint8_t> GetRegionAsUInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const = 0;
+    virtual std::vector<int16_t> GetRegionAsInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const = 0;
+    virtual std::vector<uint16_t> GetRegionAsUInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const = 0;
+    virtual std::vector<int32_t> GetRegionAsInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const = 0;
+    virtual std::vector<uint32_t> GetRegionAsUInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const = 0;
+    virtual std::vector<int64_t> GetRegionAsInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const = 0;
+    virtual std::vector<uint64_t> GetRegionAsUInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const = 0;
+    virtual std::vector<float> GetRegionAsFloat( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const = 0;
+
+    virtual void SetRegionAsInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<int8_t> &values ) = 0;
+    virtual void SetRegionAsUInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<uint8_t> &values ) = 0;
+    virtual void SetRegionAsInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<int16_t> &values ) = 0;
+    virtual void SetRegionAsUInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<uint16_t> &values ) = 0;
+    virtual void SetRegionAsInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<int32_t> &values ) = 0;
+    virtual void SetRegionAsUInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<uint32_t> &values ) = 0;
+    virtual void SetRegionAsInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<int64_t> &values ) = 0;
+    virtual void SetRegionAsUInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<uint64_t> &values ) = 0;
+    virtual void SetRegionAsFloat( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<float> &values ) = 0;
   };
 
   } // end namespace simple
@@ -27,6 +27,13 @@
 #include "itkVectorImage.h"
 #include "itkLabelMap.h"
 #include "itkImageDuplicator.h"
+#include "itkContinuousIndex.h"
+#include "itkImageAlgorithm.h"
+#include "itkSimpleFastMutexLock.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace itk
 {
@@ -44,6 +51,99 @@ namespace itk
   struct MakeDependentOn
     : public U {};
 
+  // Conversions of buffer elements for the bulk pixel access methods,
+  // which do not support complex pixels. Values other than doubles
+  // are only exchanged with buffers of the same component type.
+  template <typename TValue, typename T>
+  inline TValue ComponentToValue( const T &v )
+  {
+    return static_cast<TValue>( v );
+  }
+
+  template <typename TValue, typename T>
+  inline TValue ComponentToValue( const std::complex<T> & )
+  {
+    sitkExceptionMacro( "Bulk pixel access is not supported for complex images!" );
+  }
+
+  template <typename TValue, typename T>
+  inline void ValueToComponent( TValue v, T &out )
+  {
+    out = static_cast<T>( v );
+  }
+
+  // Casting a double which is not in the range of the component type
+  // is undefined. The bounds of the integer types are powers of two,
+  // which doubles represent exactly, while their maximum may round up
+  // to the next power of two, so it is compared exclusively.
+  template <typename T>
+  inline void ValueToComponent( double v, T &out )
+  {
+    typedef std::numeric_limits<T> Limits;
+    if ( Limits::is_integer )
+      {
+      const double truncated = ( v < 0.0 ) ? std::ceil( v ) : std::floor( v );
+      if ( !( truncated >= static_cast<double>( Limits::min() )
+              && truncated < static_cast<double>( Limits::max() ) + 1.0 ) )
+        {
+        sitkExceptionMacro( "The value " << v << " is not in the range of the pixel type!" );
+        }
+      }
+    else if ( std::fabs( v ) > static_cast<double>( Limits::max() ) && std::fabs( v ) != Limits::infinity() )
+      {
+      sitkExceptionMacro( "The value " << v << " is not in the range of the pixel type!" );
+      }
+    out = static_cast<T>( v );
+  }
+
+  template <typename TValue, typename T>
+  inline void ValueToComponent( TValue, std::complex<T> & )
+  {
+    sitkExceptionMacro( "Bulk pixel access is not supported for complex images!" );
+  }
+
+  template <typename T>
+  inline void ValueToComponent( double, std::complex<T> & )
+  {
+    sitkExceptionMacro( "Bulk pixel access is not supported for complex images!" );
+  }
+
+  // The ITK image of a region view, its buffered region is larger than
+  // its largest possible region. ITK resets the largest possible
+  // region of an image without a source to the buffered region when
+  // it is the input of a filter, which this prevents.
+  template <class TImageType>
+  class RegionViewImage
+    : public TImageType
+  {
+  public:
+    typedef RegionViewImage            Self;
+    typedef TImageType                 Superclass;
+    typedef itk::SmartPointer<Self>    Pointer;
+
+    itkNewMacro( Self );
+    itkTypeMacro( RegionViewImage, TImageType );
+
+    virtual void UpdateOutputInformation( void )
+      {
+        if ( this->GetSource() )
+          {
+          Superclass::UpdateOutputInformation();
+          }
+        else if ( this->GetRequestedRegion().GetNumberOfPixels() == 0 )
+          {
+          this->SetRequestedRegionToLargestPossibleRegion();
+          }
+      }
+
+  protected:
+    RegionViewImage( void ) {}
+
+  private:
+    RegionViewImage( const Self & ); // purposely not implemented
+    void operator=( const Self & ); // purposely not implemented
+  };
+
   template <class TImageType>
   class PimpleImage
     : public PimpleImageBase
@@ -55,8 +155,9 @@ namespace itk
     typedef typename ImageType::IndexType IndexType;
     typedef typename ImageType::PixelType PixelType;
 
-    PimpleImage ( ImageType* image )
-      : m_Image( image )
+    PimpleImage ( ImageType* image, const ImageType* viewedImage = NULL )
+      : m_Image( image ),
+        m_ViewedImage( viewedImage )
       {
         sitkStaticAssert( ImageType::ImageDimension == 4 || ImageType::ImageDimension == 3 || ImageType::ImageDimension == 2,
                           "Image Dimension out of range" );
@@ -68,14 +169,17 @@ namespace itk
           sitkExceptionMacro( << "Unable to initialize an image with NULL" );
           }
 
-        if ( image->GetLargestPossibleRegion() != image->GetBufferedRegion() )
+        // The buffered region may be larger than the largest possible
+        // region for region views
+        if ( image->GetLargestPossibleRegion() != image->GetBufferedRegion()
+             && !image->GetBufferedRegion().IsInside( image->GetLargestPossibleRegion() ) )
           {
           sitkExceptionMacro( << "The image has a LargestPossibleRegion of " << image->GetLargestPossibleRegion()
                               << " while the buffered region is " << image->GetBufferedRegion() << std::endl
                               << "SimpleITK does not support streamming or unbuffered regions!" );
           }
 
-        const IndexType & idx = image->GetBufferedRegion().GetIndex();
+        const IndexType & idx = image->GetLargestPossibleRegion().GetIndex();
         for ( unsigned int i = 0; i < ImageType::ImageDimension; ++i )
           {
           if ( idx[i] != 0 )
@@ -86,13 +190,18 @@ namespace itk
           }
       }
 
-    virtual PimpleImageBase *ShallowCopy( void ) const { return new Self(this->m_Image.GetPointer()); }
+    virtual PimpleImageBase *ShallowCopy( void ) const { return new Self(this->m_Image.GetPointer(), this->m_ViewedImage.GetPointer()); }
     virtual PimpleImageBase *DeepCopy( void ) const { return this->DeepCopy<TImageType>(); }
 
     template <typename UImageType>
     typename DisableIf<IsLabel<UImageType>::Value, PimpleImageBase*>::Type
     DeepCopy( void ) const
       {
+        if ( this->IsRegionView() )
+          {
+          return new Self( this->CopyRegionView().GetPointer() );
+          }
+
         typedef itk::ImageDuplicator< ImageType > ImageDuplicatorType;
         typename ImageDuplicatorType::Pointer dup = ImageDuplicatorType::New();
 
@@ -112,6 +221,106 @@ namespace itk
 
     virtual itk::DataObject* GetDataBase( void ) { return this->m_Image.GetPointer(); }
     virtual const itk::DataObject* GetDataBase( void ) const { return this->m_Image.GetPointer(); }
+    virtual const itk::DataObject* GetContiguousDataBase( void ) const { return this->GetContiguousImage(); }
+
+    virtual PimpleImageBase *RegionView( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const
+      {
+        return this->RegionView<TImageType>( index, size );
+      }
+
+    template <typename UImageType>
+    typename DisableIf<IsLabel<UImageType>::Value, PimpleImageBase*>::Type
+    RegionView( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const
+      {
+        const unsigned int dimension = ImageType::ImageDimension;
+        if ( index.size() != dimension || size.size() != dimension )
+          {
+          sitkExceptionMacro( "The index and size of the region must have " << dimension << " elements!" );
+          }
+
+        const typename ImageType::SizeType &imageSize = this->m_Image->GetLargestPossibleRegion().GetSize();
+        typename ImageType::RegionType region;
+        for ( unsigned int d = 0; d < dimension; ++d )
+          {
+          if ( size[d] == 0 || static_cast<uint64_t>( index[d] ) + size[d] > imageSize[d] )
+            {
+            sitkExceptionMacro( "The region is not inside the image!" );
+            }
+          region.SetIndex( d, index[d] );
+          region.SetSize( d, size[d] );
+          }
+
+        typename ImageType::PointType origin;
+        this->m_Image->TransformIndexToPhysicalPoint( region.GetIndex(), origin );
+
+        // The buffered region is shifted so that the first pixel of the
+        // region has a zero index in the view
+        typename ImageType::RegionType bufferedRegion = this->m_Image->GetBufferedRegion();
+        for ( unsigned int d = 0; d < dimension; ++d )
+          {
+          bufferedRegion.SetIndex( d, bufferedRegion.GetIndex()[d] - region.GetIndex()[d] );
+          }
+
+        typename RegionViewImage<ImageType>::Pointer view = RegionViewImage<ImageType>::New();
+        view->CopyInformation( this->m_Image );
+        view->SetNumberOfComponentsPerPixel( this->m_Image->GetNumberOfComponentsPerPixel() );
+        view->SetOrigin( origin );
+        view->SetRegions( region.GetSize() );
+        view->SetBufferedRegion( bufferedRegion );
+        view->SetPixelContainer( const_cast<typename ImageType::PixelContainer *>( this->m_Image->GetPixelContainer() ) );
+        view->SetMetaDataDictionary( this->m_Image->GetMetaDataDictionary() );
+
+        // A view of a view refers to the image which owns the buffer
+        const ImageType *viewedImage = this->m_ViewedImage.IsNotNull() ? this->m_ViewedImage.GetPointer() : this->m_Image.GetPointer();
+        return new Self( view.GetPointer(), viewedImage );
+      }
+
+    template <typename UImageType>
+    typename EnableIf<IsLabel<UImageType>::Value, PimpleImageBase*>::Type
+    RegionView( const std::vector<uint32_t> &, const std::vector<uint32_t> & ) const
+      {
+        sitkExceptionMacro( "Region views are not supported for label images!" );
+      }
+
+    virtual bool IsRegionView( void ) const
+      {
+        return this->m_ViewedImage.IsNotNull()
+          || this->m_Image->GetBufferedRegion() != this->m_Image->GetLargestPossibleRegion();
+      }
+
+    virtual std::vector<uint32_t> GetRegionViewIndex( void ) const
+      {
+        std::vector<uint32_t> index( ImageType::ImageDimension );
+        for ( unsigned int d = 0; d < ImageType::ImageDimension; ++d )
+          {
+          index[d] = static_cast<uint32_t>( -this->m_Image->GetBufferedRegion().GetIndex()[d] );
+          }
+        return index;
+      }
+
+    virtual std::vector<uint32_t> GetRegionViewBufferSize( void ) const
+      {
+        return sitkITKVectorToSTL<uint32_t>( this->m_Image->GetBufferedRegion().GetSize() );
+      }
+
+    virtual const void *GetRegionViewBuffer( void ) const
+      {
+        return this->GetRegionViewBuffer<TImageType>();
+      }
+
+    template <typename UImageType>
+    typename DisableIf<IsLabel<UImageType>::Value, const void *>::Type
+    GetRegionViewBuffer( void ) const
+      {
+        return this->m_Image->GetPixelContainer()->GetBufferPointer();
+      }
+
+    template <typename UImageType>
+    typename EnableIf<IsLabel<UImageType>::Value, const void *>::Type
+    GetRegionViewBuffer( void ) const
+      {
+        sitkExceptionMacro( "This method is not supported for LabelMaps." );
+      }
 
 
     PixelIDValueEnum GetPixelID(void) const throw()
@@ -285,6 +494,26 @@ namespace itk
         return this->m_Image->GetReferenceCount();
       }
 
+    virtual int GetReferenceCountOfPixelContainer() const
+      {
+        return this->GetReferenceCountOfPixelContainer<TImageType>();
+      }
+
+    template <typename UImageType>
+    typename DisableIf<IsLabel<UImageType>::Value, int>::Type
+    GetReferenceCountOfPixelContainer( void ) const
+      {
+        return this->m_Image->GetPixelContainer()->GetReferenceCount();
+      }
+
+    // Label maps hold their pixels in label objects of their own
+    template <typename UImageType>
+    typename EnableIf<IsLabel<UImageType>::Value, int>::Type
+    GetReferenceCountOfPixelContainer( void ) const
+      {
+        return 1;
+      }
+
     virtual int8_t  GetPixelAsInt8( const std::vector<uint32_t> &idx) const
       {
         if ( IsLabel<ImageType>::Value )
@@ -625,6 +854,179 @@ namespace itk
         this->InternalSetPixel<BasicPixelID<std::complex<double> > >( idx, v );
       }
 
+    virtual std::vector<double> GetPixelsAsDouble( const std::vector<uint32_t> &indexes ) const
+      {
+        return this->InternalGetPixels<ImageType, double>( indexes );
+      }
+
+    virtual void SetPixelsAsDouble( const std::vector<uint32_t> &indexes, const std::vector<double> &values )
+      {
+        this->InternalSetPixels<ImageType>( indexes, values );
+      }
+
+    virtual std::vector<double> EvaluateAtPhysicalPoints( const std::vector<double> &points, InterpolatorEnum interpolator, double defaultPixelValue ) const
+      {
+        return this->InternalEvaluateAtPhysicalPoints<ImageType>( points, interpolator, defaultPixelValue );
+      }
+
+    virtual std::vector<double> GetRegionAsDouble( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const
+      {
+        return this->InternalGetRegion<ImageType, double>( index, size );
+      }
+
+    virtual void SetRegionAsDouble( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<double> &values )
+      {
+        this->InternalSetRegion<ImageType>( index, size, values );
+      }
+
+    virtual std::vector<int8_t> GetPixelsAsInt8( const std::vector<uint32_t> &indexes ) const
+      {
+        return this->InternalGetPixels<ImageType, int8_t>( indexes );
+      }
+    virtual std::vector<uint8_t> GetPixelsAsUInt8( const std::vector<uint32_t> &indexes ) const
+      {
+        return this->InternalGetPixels<ImageType, uint8_t>( indexes );
+      }
+    virtual std::vector<int16_t> GetPixelsAsInt16( const std::vector<uint32_t> &indexes ) const
+      {
+        return this->InternalGetPixels<ImageType, int16_t>( indexes );
+      }
+    virtual std::vector<uint16_t> GetPixelsAsUInt16( const std::vector<uint32_t> &indexes ) const
+      {
+        return this->InternalGetPixels<ImageType, uint16_t>( indexes );
+      }
+    virtual std::vector<int32_t> GetPixelsAsInt32( const std::vector<uint32_t> &indexes ) const
+      {
+        return this->InternalGetPixels<ImageType, int32_t>( indexes );
+      }
+    virtual std::vector<uint32_t> GetPixelsAsUInt32( const std::vector<uint32_t> &indexes ) const
+      {
+        return this->InternalGetPixels<ImageType, uint32_t>( indexes );
+      }
+    virtual std::vector<int64_t> GetPixelsAsInt64( const std::vector<uint32_t> &indexes ) const
+      {
+        return this->InternalGetPixels<ImageType, int64_t>( indexes );
+      }
+    virtual std::vector<uint64_t> GetPixelsAsUInt64( const std::vector<uint32_t> &indexes ) const
+      {
+        return this->InternalGetPixels<ImageType, uint64_t>( indexes );
+      }
+    virtual std::vector<float> GetPixelsAsFloat( const std::vector<uint32_t> &indexes ) const
+      {
+        return this->InternalGetPixels<ImageType, float>( indexes );
+      }
+
+    virtual void SetPixelsAsInt8( const std::vector<uint32_t> &indexes, const std::vector<int8_t> &values )
+      {
+        this->InternalSetPixels<ImageType>( indexes, values );
+      }
+    virtual void SetPixelsAsUInt8( const std::vector<uint32_t> &indexes, const std::vector<uint8_t> &values )
+      {
+        this->InternalSetPixels<ImageType>( indexes, values );
+      }
+    virtual void SetPixelsAsInt16( const std::vector<uint32_t> &indexes, const std::vector<int16_t> &values )
+      {
+        this->InternalSetPixels<ImageType>( indexes, values );
+      }
+    virtual void SetPixelsAsUInt16( const std::vector<uint32_t> &indexes, const std::vector<uint16_t> &values )
+      {
+        this->InternalSetPixels<ImageType>( indexes, values );
+      }
+    virtual void SetPixelsAsInt32( const std::vector<uint32_t> &indexes, const std::vector<int32_t> &values )
+      {
+        this->InternalSetPixels<ImageType>( indexes, values );
+      }
+    virtual void SetPixelsAsUInt32( const std::vector<uint32_t> &indexes, const std::vector<uint32_t> &values )
+      {
+        this->InternalSetPixels<ImageType>( indexes, values );
+      }
+    virtual void SetPixelsAsInt64( const std::vector<uint32_t> &indexes, const std::vector<int64_t> &values )
+      {
+        this->InternalSetPixels<ImageType>( indexes, values );
+      }
+    virtual void SetPixelsAsUInt64( const std::vector<uint32_t> &indexes, const std::vector<uint64_t> &values )
+      {
+        this->InternalSetPixels<ImageType>( indexes, values );
+      }
+    virtual void SetPixelsAsFloat( const std::vector<uint32_t> &indexes, const std::vector<float> &values )
+      {
+        this->InternalSetPixels<ImageType>( indexes, values );
+      }
+
+    virtual std::vector<int8_t> GetRegionAsInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const
+      {
+        return this->InternalGetRegion<ImageType, int8_t>( index, size );
+      }
+    virtual std::vector<uint8_t> GetRegionAsUInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const
+      {
+        return this->InternalGetRegion<ImageType, uint8_t>( index, size );
+      }
+    virtual std::vector<int16_t> GetRegionAsInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const
+      {
+        return this->InternalGetRegion<ImageType, int16_t>( index, size );
+      }
+    virtual std::vector<uint16_t> GetRegionAsUInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const
+      {
+        return this->InternalGetRegion<ImageType, uint16_t>( index, size );
+      }
+    virtual std::vector<int32_t> GetRegionAsInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const
+      {
+        return this->InternalGetRegion<ImageType, int32_t>( index, size );
+      }
+    virtual std::vector<uint32_t> GetRegionAsUInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const
+      {
+        return this->InternalGetRegion<ImageType, uint32_t>( index, size );
+      }
+    virtual std::vector<int64_t> GetRegionAsInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const
+      {
+        return this->InternalGetRegion<ImageType, int64_t>( index, size );
+      }
+    virtual std::vector<uint64_t> GetRegionAsUInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const
+      {
+        return this->InternalGetRegion<ImageType, uint64_t>( index, size );
+      }
+    virtual std::vector<float> GetRegionAsFloat( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const
+      {
+        return this->InternalGetRegion<ImageType, float>( index, size );
+      }
+
+    virtual void SetRegionAsInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<int8_t> &values )
+      {
+        this->InternalSetRegion<ImageType>( index, size, values );
+      }
+    virtual void SetRegionAsUInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<uint8_t> &values )
+      {
+        this->InternalSetRegion<ImageType>( index, size, values );
+      }
+    virtual void SetRegionAsInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<int16_t> &values )
+      {
+        this->InternalSetRegion<ImageType>( index, size, values );
+      }
+    virtual void SetRegionAsUInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<uint16_t> &values )
+      {
+        this->InternalSetRegion<ImageType>( index, size, values );
+      }
+    virtual void SetRegionAsInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<int32_t> &values )
+      {
+        this->InternalSetRegion<ImageType>( index, size, values );
+      }
+    virtual void SetRegionAsUInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<uint32_t> &values )
+      {
+        this->InternalSetRegion<ImageType>( index, size, values );
+      }
+    virtual void SetRegionAsInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<int64_t> &values )
+      {
+        this->InternalSetRegion<ImageType>( index, size, values );
+      }
+    virtual void SetRegionAsUInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<uint64_t> &values )
+      {
+        this->InternalSetRegion<ImageType>( index, size, values );
+      }
+    virtual void SetRegionAsFloat( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<float> &values )
+      {
+        this->InternalSetRegion<ImageType>( index, size, values );
+      }
+
 
   protected:
 
@@ -695,7 +1097,7 @@ namespace itk
                       typename ImageType::PixelType *>::Type
     InternalGetBuffer( void )
       {
-        return this->m_Image->GetPixelContainer()->GetBufferPointer();
+        return this->GetContiguousImage()->GetPixelContainer()->GetBufferPointer();
       }
 
     template < typename TPixelIDType >
@@ -715,7 +1117,7 @@ namespace itk
                       typename MakeDependentOn<TPixelIDType, ImageType>::InternalPixelType * >::Type
     InternalGetBuffer( void )
       {
-        return this->m_Image->GetPixelContainer()->GetBufferPointer();
+        return this->GetContiguousImage()->GetPixelContainer()->GetBufferPointer();
       }
 
     template < typename TPixelIDType >
@@ -795,8 +1197,414 @@ namespace itk
                             << "!" );
       }
 
+    // Offset in pixels of an index into the buffer, the index is
+    // checked against the bounds of the image
+    size_t ComputeBufferOffset( const uint32_t *index ) const
+      {
+        const typename ImageType::SizeType &size = this->m_Image->GetLargestPossibleRegion().GetSize();
+
+        IndexType itkIndex;
+        for ( unsigned int d = 0; d < ImageType::ImageDimension; ++d )
+          {
+          if ( index[d] >= size[d] )
+            {
+            sitkExceptionMacro( "index out of bounds" );
+            }
+          itkIndex[d] = index[d];
+          }
+        return static_cast<size_t>( this->m_Image->ComputeOffset( itkIndex ) );
+      }
+
+    // Copy of a region view into a buffer of its own
+    template <typename UImageType>
+    typename DisableIf<IsLabel<UImageType>::Value, ImagePointer>::Type
+    CopyRegionView( void ) const
+      {
+        ImagePointer output = ImageType::New();
+        output->CopyInformation( this->m_Image );
+        output->SetNumberOfComponentsPerPixel( this->m_Image->GetNumberOfComponentsPerPixel() );
+        output->SetRegions( this->m_Image->GetLargestPossibleRegion() );
+        output->Allocate();
+        output->SetMetaDataDictionary( this->m_Image->GetMetaDataDictionary() );
+
+        itk::ImageAlgorithm::Copy( this->m_Image.GetPointer(), output.GetPointer(),
+                                   output->GetLargestPossibleRegion(), output->GetLargestPossibleRegion() );
+        return output;
+      }
+
+    template <typename UImageType>
+    typename EnableIf<IsLabel<UImageType>::Value, ImagePointer>::Type
+    CopyRegionView( void ) const
+      {
+        sitkExceptionMacro( "Region views are not supported for label images!" );
+      }
+
+    ImagePointer CopyRegionView( void ) const
+      {
+        return this->CopyRegionView<TImageType>();
+      }
+
+    // The image itself, or for a region view a copy of it whose buffer
+    // is laid out as the image. The copy is made on first use and kept,
+    // the view's pixels never change.
+    ImageType *GetContiguousImage( void ) const
+      {
+        if ( !this->IsRegionView() )
+          {
+          return this->m_Image.GetPointer();
+          }
+
+        this->m_ContiguousImageMutex.Lock();
+        try
+          {
+          if ( this->m_ContiguousImage.IsNull() )
+            {
+            this->m_ContiguousImage = this->CopyRegionView();
+            }
+          }
+        catch ( ... )
+          {
+          this->m_ContiguousImageMutex.Unlock();
+          throw;
+          }
+        this->m_ContiguousImageMutex.Unlock();
+        return this->m_ContiguousImage.GetPointer();
+      }
+
+    // Offsets in pixels of the first pixel of each row, along the x
+    // axis, of a region
+    std::vector<size_t> ComputeRegionRowOffsets( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const
+      {
+        const unsigned int dimension = ImageType::ImageDimension;
+        if ( index.size() != dimension || size.size() != dimension )
+          {
+          sitkExceptionMacro( "The index and size of the region must have " << dimension << " elements!" );
+          }
+
+        const typename ImageType::SizeType &imageSize = this->m_Image->GetLargestPossibleRegion().GetSize();
+        size_t numberOfRows = 1;
+        for ( unsigned int d = 0; d < dimension; ++d )
+          {
+          if ( static_cast<uint64_t>( index[d] ) + size[d] > imageSize[d] )
+            {
+            sitkExceptionMacro( "The region is not inside the image!" );
+            }
+          numberOfRows *= ( d == 0 ) ? ( size[d] > 0 ) : size[d];
+          }
+
+        std::vector<size_t> offsets;
+        offsets.reserve( numberOfRows );
+
+        uint32_t rowIndex[ImageType::ImageDimension];
+        std::copy( index.begin(), index.end(), rowIndex );
+        for ( size_t r = 0; r < numberOfRows; ++r )
+          {
+          offsets.push_back( this->ComputeBufferOffset( rowIndex ) );
+          for ( unsigned int d = 1; d < dimension; ++d )
+            {
+            if ( ++rowIndex[d] < index[d] + size[d] )
+              {
+              break;
+              }
+            rowIndex[d] = index[d];
+            }
+          }
+        return offsets;
+      }
+
+    void CheckNumberOfElements( size_t numberOfElements, size_t expectedNumberOfElements, const char *what ) const
+      {
+        if ( numberOfElements != expectedNumberOfElements )
+          {
+          sitkExceptionMacro( "Expected " << expectedNumberOfElements << " " << what << " but got " << numberOfElements << "!" );
+          }
+      }
+
+    // Values other than doubles must be of the component type of the
+    // image, so that they are exchanged without conversion
+    template < typename TImage, typename TValue >
+    void CheckBulkValueType( void ) const
+      {
+        typedef typename TImage::PixelContainer::Element ComponentType;
+        if ( !nsstd::is_same<TValue, double>::value && !nsstd::is_same<TValue, ComponentType>::value )
+          {
+          sitkExceptionMacro( << "The image is of type: " << GetPixelIDValueAsString( this->GetPixelID() )
+                              << " which does not match the value type of the bulk access method!" );
+          }
+      }
+
+    // Converts the values without writing them, which throws for values
+    // that are not in the range of the component type
+    template < typename TComponent, typename TValue >
+    void CheckValues( const std::vector<TValue> &values ) const
+      {
+        TComponent component;
+        for ( size_t i = 0; i < values.size(); ++i )
+          {
+          ValueToComponent( values[i], component );
+          }
+      }
+
+    template < typename TImage, typename TValue >
+    typename DisableIf<IsLabel<TImage>::Value, std::vector<TValue> >::Type
+    InternalGetPixels( const std::vector<uint32_t> &indexes ) const
+      {
+        typedef typename TImage::PixelContainer::Element ComponentType;
+
+        this->CheckBulkValueType<TImage, TValue>();
+
+        const unsigned int dimension = TImage::ImageDimension;
+        const size_t numberOfPixels = indexes.size() / dimension;
+        this->CheckNumberOfElements( indexes.size(), numberOfPixels * dimension, "index elements" );
+
+        const unsigned int numberOfComponents = this->m_Image->GetNumberOfComponentsPerPixel();
+        const ComponentType *buffer = this->m_Image->GetPixelContainer()->GetBufferPointer();
+
+        std::vector<TValue> values( numberOfPixels * numberOfComponents );
+        for ( size_t p = 0; p < numberOfPixels; ++p )
+          {
+          const ComponentType *pixel = buffer + this->ComputeBufferOffset( &indexes[p * dimension] ) * numberOfComponents;
+          for ( unsigned int c = 0; c < numberOfComponents; ++c )
+            {
+            values[p * numberOfComponents + c] = ComponentToValue<TValue>( pixel[c] );
+            }
+          }
+        return values;
+      }
+
+    template < typename TImage, typename TValue >
+    typename DisableIf<IsLabel<TImage>::Value >::Type
+    InternalSetPixels( const std::vector<uint32_t> &indexes, const std::vector<TValue> &values )
+      {
+        typedef typename TImage::PixelContainer::Element ComponentType;
+
+        this->CheckBulkValueType<TImage, TValue>();
+
+        const unsigned int dimension = TImage::ImageDimension;
+        const size_t numberOfPixels = indexes.size() / dimension;
+        this->CheckNumberOfElements( indexes.size(), numberOfPixels * dimension, "index elements" );
+
+        const unsigned int numberOfComponents = this->m_Image->GetNumberOfComponentsPerPixel();
+        this->CheckNumberOfElements( values.size(), numberOfPixels * numberOfComponents, "values" );
+
+        // Indexes and values are checked before the first pixel is
+        // written, so that a call which throws leaves the image unchanged
+        std::vector<size_t> offsets( numberOfPixels );
+        for ( size_t p = 0; p < numberOfPixels; ++p )
+          {
+          offsets[p] = this->ComputeBufferOffset( &indexes[p * dimension] );
+          }
+        this->CheckValues<ComponentType>( values );
+
+        ComponentType *buffer = this->m_Image->GetPixelContainer()->GetBufferPointer();
+        for ( size_t p = 0; p < numberOfPixels; ++p )
+          {
+          ComponentType *pixel = buffer + offsets[p] * numberOfComponents;
+          for ( unsigned int c = 0; c < numberOfComponents; ++c )
+            {
+            ValueToComponent( values[p * numberOfComponents + c], pixel[c] );
+            }
+          }
+      }
+
+    template < typename TImage >
+    typename DisableIf<IsLabel<TImage>::Value, std::vector<double> >::Type
+    InternalEvaluateAtPhysicalPoints( const std::vector<double> &points, InterpolatorEnum interpolator, double defaultPixelValue ) const
+      {
+        typedef typename TImage::PixelContainer::Element ComponentType;
+
+        if ( interpolator != sitkNearestNeighbor && interpolator != sitkLinear )
+          {
+          sitkExceptionMacro( "Interpolator type " << interpolator << " is not supported, use sitkNearestNeighbor or sitkLinear!" );
+          }
+
+        const unsigned int dimension = TImage::ImageDimension;
+        const size_t numberOfPoints = points.size() / dimension;
+        this->CheckNumberOfElements( points.size(), numberOfPoints * dimension, "point coordinates" );
+
+        const unsigned int numberOfComponents = this->m_Image->GetNumberOfComponentsPerPixel();
+        const ComponentType *buffer = this->m_Image->GetPixelContainer()->GetBufferPointer();
+        const typename TImage::SizeType &size = this->m_Image->GetLargestPossibleRegion().GetSize();
+
+        std::vector<double> values( numberOfPoints * numberOfComponents, defaultPixelValue );
+
+        typename TImage::PointType point;
+        itk::ContinuousIndex<double, TImage::ImageDimension> continuousIndex;
+        double lower[TImage::ImageDimension];
+        double fraction[TImage::ImageDimension];
+        uint32_t index[TImage::ImageDimension];
+
+        for ( size_t p = 0; p < numberOfPoints; ++p )
+          {
+          for ( unsigned int d = 0; d < dimension; ++d )
+            {
+            point[d] = points[p * dimension + d];
+            }
+          this->m_Image->TransformPhysicalPointToContinuousIndex( point, continuousIndex );
+
+          // Inside the image as ITK's interpolators define it, up to half a
+          // pixel beyond the centers of the border pixels
+          bool isInside = true;
+          for ( unsigned int d = 0; d < dimension; ++d )
+            {
+            isInside = isInside && continuousIndex[d] >= -0.5 && continuousIndex[d] < size[d] - 0.5;
+            }
+          if ( !isInside )
+            {
+            continue;
+            }
+
+          double *value = &values[p * numberOfComponents];
+
+          if ( interpolator == sitkNearestNeighbor )
+            {
+            for ( unsigned int d = 0; d < dimension; ++d )
+              {
+              index[d] = static_cast<uint32_t>( std::floor( continuousIndex[d] + 0.5 ) );
+              }
+            const ComponentType *pixel = buffer + this->ComputeBufferOffset( index ) * numberOfComponents;
+            for ( unsigned int c = 0; c < numberOfComponents; ++c )
+              {
+              value[c] = ComponentToValue<double>( pixel[c] );
+              }
+            continue;
+            }
+
+          for ( unsigned int d = 0; d < dimension; ++d )
+            {
+            lower[d] = std::floor( continuousIndex[d] );
+            fraction[d] = continuousIndex[d] - lower[d];
+            }
+          std::fill( value, value + numberOfComponents, 0.0 );
+
+          // Neighbors beyond the border are clamped to it
+          for ( unsigned int corner = 0; corner < ( 1u << dimension ); ++corner )
+            {
+            double weight = 1.0;
+            for ( unsigned int d = 0; d < dimension; ++d )
+              {
+              int64_t i = static_cast<int64_t>( lower[d] );
+              if ( corner & ( 1u << d ) )
+                {
+                ++i;
+                weight *= fraction[d];
+                }
+              else
+                {
+                weight *= 1.0 - fraction[d];
+                }
+              index[d] = static_cast<uint32_t>( std::min<int64_t>( std::max<int64_t>( i, 0 ), size[d] - 1 ) );
+              }
+            if ( weight == 0.0 )
+              {
+              continue;
+              }
+            const ComponentType *pixel = buffer + this->ComputeBufferOffset( index ) * numberOfComponents;
+            for ( unsigned int c = 0; c < numberOfComponents; ++c )
+              {
+              value[c] += weight * ComponentToValue<double>( pixel[c] );
+              }
+            }
+          }
+        return values;
+      }
+
+    template < typename TImage, typename TValue >
+    typename DisableIf<IsLabel<TImage>::Value, std::vector<TValue> >::Type
+    InternalGetRegion( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const
+      {
+        typedef typename TImage::PixelContainer::Element ComponentType;
+
+        this->CheckBulkValueType<TImage, TValue>();
+
+        const std::vector<size_t> rows = this->ComputeRegionRowOffsets( index, size );
+
+        const unsigned int numberOfComponents = this->m_Image->GetNumberOfComponentsPerPixel();
+        const size_t rowLength = static_cast<size_t>( size[0] ) * numberOfComponents;
+        const ComponentType *buffer = this->m_Image->GetPixelContainer()->GetBufferPointer();
+
+        std::vector<TValue> values( rows.size() * rowLength );
+        for ( size_t r = 0; r < rows.size(); ++r )
+          {
+          const ComponentType *row = buffer + rows[r] * numberOfComponents;
+          for ( size_t i = 0; i < rowLength; ++i )
+            {
+            values[r * rowLength + i] = ComponentToValue<TValue>( row[i] );
+            }
+          }
+        return values;
+      }
+
+    template < typename TImage, typename TValue >
+    typename DisableIf<IsLabel<TImage>::Value >::Type
+    InternalSetRegion( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const std::vector<TValue> &values )
+      {
+        typedef typename TImage::PixelContainer::Element ComponentType;
+
+        this->CheckBulkValueType<TImage, TValue>();
+
+        const std::vector<size_t> rows = this->ComputeRegionRowOffsets( index, size );
+
+        const unsigned int numberOfComponents = this->m_Image->GetNumberOfComponentsPerPixel();
+        const size_t rowLength = static_cast<size_t>( size[0] ) * numberOfComponents;
+        this->CheckNumberOfElements( values.size(), rows.size() * rowLength, "values" );
+        this->CheckValues<ComponentType>( values );
+
+        ComponentType *buffer = this->m_Image->GetPixelContainer()->GetBufferPointer();
+        for ( size_t r = 0; r < rows.size(); ++r )
+          {
+          ComponentType *row = buffer + rows[r] * numberOfComponents;
+          for ( size_t i = 0; i < rowLength; ++i )
+            {
+            ValueToComponent( values[r * rowLength + i], row[i] );
+            }
+          }
+      }
+
+    template < typename TImage, typename TValue >
+    typename EnableIf<IsLabel<TImage>::Value, std::vector<TValue> >::Type
+    InternalGetPixels( const std::vector<uint32_t> & ) const
+      {
+        sitkExceptionMacro( "Bulk pixel access is not supported for label images!" );
+      }
+
+    template < typename TImage, typename TValue >
+    typename EnableIf<IsLabel<TImage>::Value >::Type
+    InternalSetPixels( const std::vector<uint32_t> &, const std::vector<TValue> & )
+      {
+        sitkExceptionMacro( "Bulk pixel access is not supported for label images!" );
+      }
+
+    template < typename TImage >
+    typename EnableIf<IsLabel<TImage>::Value, std::vector<double> >::Type
+    InternalEvaluateAtPhysicalPoints( const std::vector<double> &, InterpolatorEnum, double ) const
+      {
+        sitkExceptionMacro( "Bulk pixel access is not supported for label images!" );
+      }
+
+    template < typename TImage, typename TValue >
+    typename EnableIf<IsLabel<TImage>::Value, std::vector<TValue> >::Type
+    InternalGetRegion( const std::vector<uint32_t> &, const std::vector<uint32_t> & ) const
+      {
+        sitkExceptionMacro( "Bulk pixel access is not supported for label images!" );
+      }
+
+    template < typename TImage, typename TValue >
+    typename EnableIf<IsLabel<TImage>::Value >::Type
+    InternalSetRegion( const std::vector<uint32_t> &, const std::vector<uint32_t> &, const std::vector<TValue> & )
+      {
+        sitkExceptionMacro( "Bulk pixel access is not supported for label images!" );
+      }
+
   private:
     ImagePointer m_Image;
+
+    // The image whose buffer a region view refers to, kept so that
+    // writing to it copies its buffer first
+    typename ImageType::ConstPointer m_ViewedImage;
+
+    mutable ImagePointer             m_ContiguousImage;
+    mutable itk::SimpleFastMutexLock m_ContiguousImageMutex;
   };
 
   }
@@ -3,11 +3,15 @@
 
 #include "sitkCommon.h"
 #include "sitkImage.h"
+#include "sitkProcessObject.h"
 
 namespace itk { 
   namespace simple {
 
+class SimpleElastixFuture;
+
 class SITKCommon_EXPORT SimpleElastix
+  : public ProcessObject
 {
   public:
 
@@ -15,6 +19,7 @@ class SITKCommon_EXPORT SimpleElastix
     ~SimpleElastix( void );
 
     typedef SimpleElastix Self;                                
+    typedef ProcessObject Superclass;
 
     typedef std::vector< Image >                                    VectorOfImage;
 
@@ -27,7 +32,7 @@ class SITKCommon_EXPORT SimpleElastix
     typedef ParameterMapType::iterator                              ParameterMapIterator;
     typedef ParameterMapType::const_iterator                        ParameterMapConstIterator;
 
-    const std::string GetName( void );
+    std::string GetName( void ) const;
 
     Self& SetFixedImage( const Image& fixedImage );
     Self& SetFixedImage( const VectorOfImage& fixedImages );
@@ -38,6 +43,14 @@ class SITKCommon_EXPORT SimpleElastix
     Self& RemoveFixedImage( void );
     unsigned int GetNumberOfFixedImages();
 
+    // Session mode: fixed images are converted once and reused until they change
+    Self& SetCacheFixedImages( const bool cacheFixedImages );
+    bool GetCacheFixedImages( void );
+    Self& CacheFixedImagesOn( void );
+    Self& CacheFixedImagesOff( void );
+    uint64_t GetFixedImageCacheHits( void );
+    uint64_t GetFixedImageCacheMisses( void );
+
     Self& SetMovingImage( const Image& movingImages );
     Self& SetMovingImage( const VectorOfImage& movingImage );
     Self& AddMovingImage( const Image& movingImage );
@@ -47,6 +60,7 @@ class SITKCommon_EXPORT SimpleElastix
     Self& RemoveMovingImage( void );
     unsigned int GetNumberOfMovingImages();
 
+    // Integer or label map masks; without a mask label every non-zero voxel is inside
     Self& SetFixedMask( const Image& fixedMask );
     Self& SetFixedMask( const VectorOfImage& fixedMasks );
     Self& AddFixedMask( const Image& fixedMask );
@@ -55,6 +69,9 @@ class SITKCommon_EXPORT SimpleElastix
     Self& RemoveFixedMask( const unsigned long index );
     Self& RemoveFixedMask( void );
     unsigned int GetNumberOfFixedMasks();
+    Self& SetFixedMaskLabel( const int64_t fixedMaskLabel );
+    int64_t GetFixedMaskLabel( void );
+    Self& RemoveFixedMaskLabel( void );
 
     Self& SetMovingMask( const Image& movingMask );
     Self& SetMovingMask( const VectorOfImage& movingMasks );
@@ -64,6 +81,9 @@ class SITKCommon_EXPORT SimpleElastix
     Self& RemoveMovingMask( const unsigned long index );
     Self& RemoveMovingMask( void );
     unsigned int GetNumberOfMovingMasks();
+    Self& SetMovingMaskLabel( const int64_t movingMaskLabel );
+    int64_t GetMovingMaskLabel( void );
+    Self& RemoveMovingMaskLabel( void );
 
     Self& SetFixedPointSetFileName( const std::string movingPointSetFileName );
     std::string GetFixedPointSetFileName( void );
@@ -73,6 +93,17 @@ class SITKCommon_EXPORT SimpleElastix
     std::string GetMovingPointSetFileName( void );
     Self& RemoveMovingPointSetFileName( void );
 
+    // Point sets in memory, one point per vector or packed as x0, y0, z0, x1, ...
+    Self& SetFixedPointSet( const std::vector< std::vector< double > >& fixedPointSet );
+    Self& SetFixedPointSet( const std::vector< double >& fixedPointSet, const unsigned int dimension );
+    std::vector< std::vector< double > > GetFixedPointSet( void );
+    Self& RemoveFixedPointSet( void );
+
+    Self& SetMovingPointSet( const std::vector< std::vector< double > >& movingPointSet );
+    Self& SetMovingPointSet( const std::vector< double >& movingPointSet, const unsigned int dimension );
+    std::vector< std::vector< double > > GetMovingPointSet( void );
+    Self& RemoveMovingPointSet( void );
+
     Self& SetOutputDirectory( const std::string outputDirectory );
     std::string GetOutputDirectory( void );
     Self& RemoveOutputDirectory( void );
@@ -91,10 +122,39 @@ class SITKCommon_EXPORT SimpleElastix
     Self& LogToConsoleOn();
     Self& LogToConsoleOff();
 
+    // Keep the log and the iteration table of Execute() in memory
+    Self& SetLogToMemory( const bool logToMemory );
+    bool GetLogToMemory( void );
+    Self& LogToMemoryOn( void );
+    Self& LogToMemoryOff( void );
+    Self& SetMaximumLogSize( const unsigned int maximumLogSize );
+    unsigned int GetMaximumLogSize( void );
+    std::string GetLog( void );
+    std::vector< std::vector< double > > GetIterationTable( void );
+
+    // When off, only the transform is estimated and no result image is returned
+    Self& SetComputeResultImage( const bool computeResultImage );
+    bool GetComputeResultImage( void );
+    Self& ComputeResultImageOn( void );
+    Self& ComputeResultImageOff( void );
+
+    // Reuse results of earlier registrations with the same inputs, shared by all objects
+    Self& SetUseResultCache( const bool useResultCache );
+    bool GetUseResultCache( void );
+    Self& UseResultCacheOn( void );
+    Self& UseResultCacheOff( void );
+    static void SetResultCacheMaximumSize( const uint64_t maximumSize );
+    static uint64_t GetResultCacheMaximumSize( void );
+    static uint64_t GetResultCacheSize( void );
+    static uint64_t GetResultCacheHits( void );
+    static uint64_t GetResultCacheMisses( void );
+    static void ClearResultCache( void );
+    uint64_t GetNumberOfHashedImages( void );
+
     Self& SetParameterMap( const std::string transformName, const unsigned int numberOfResolutions = 4u, const double finalGridSpacingInPhysicalUnits = 10.0 );
-    Self& SetParameterMap( const std::vector< std::map< std::string, std::vector< std::string > > > parameterMapVector );
-    Self& SetParameterMap( const std::map< std::string, std::vector< std::string > > parameterMap );
-    Self& AddParameterMap( const std::map< std::string, std::vector< std::string > > parameterMap );
+    Self& SetParameterMap( const std::vector< std::map< std::string, std::vector< std::string > > >& parameterMapVector );
+    Self& SetParameterMap( const std::map< std::string, std::vector< std::string > >& parameterMap );
+    Self& AddParameterMap( const std::map< std::string, std::vector< std::string > >& parameterMap );
     std::vector< std::map< std::string, std::vector< std::string > > > GetParameterMap( void );
     std::map< std::string, std::vector< std::string > > GetDefaultParameterMap( const std::string transformName, const unsigned int numberOfResolutions = 4, const double finalGridSpacingInPhysicalUnits = 10.0 );
     unsigned int GetNumberOfParameterMaps( void );
@@ -116,14 +176,44 @@ class SITKCommon_EXPORT SimpleElastix
     std::string GetInitialTransformParameterFileName( void );
     Self& RemoveInitialTransformParameterFileName( void );
 
+    // Initial transform as parameter maps; it begins the transform parameter maps of the result
+    Self& SetInitialTransformParameterMap( const std::vector< std::map< std::string, std::vector< std::string > > >& initialTransformParameterMapVector );
+    std::vector< std::map< std::string, std::vector< std::string > > > GetInitialTransformParameterMap( void );
+    Self& RemoveInitialTransformParameterMap( void );
+
+    // Rigid candidates of which the one with the lowest coarse metric value starts the registration
+    Self& SetMultiStartCandidates( const std::vector< std::vector< double > >& candidates );
+    Self& AddMultiStartCandidate( const std::vector< double >& candidate );
+    std::vector< std::vector< double > > GetMultiStartCandidates( void );
+    Self& RemoveMultiStartCandidates( void );
+    std::vector< double > GetMultiStartMetricValues( void );
+    unsigned int GetBestMultiStartCandidate( void );
+
     std::map< std::string, std::vector< std::string > > ReadParameterFile( const std::string filename );
-    Self& WriteParameterFile( const std::map< std::string, std::vector< std::string > > parameterMap, const std::string filename );
+    Self& WriteParameterFile( const std::map< std::string, std::vector< std::string > >& parameterMap, const std::string filename );
     
     Image Execute( void );
+
+    // Measurements of the running registration, valid during iteration events
+    unsigned int GetCurrentLevel( void ) const;
+    unsigned int GetOptimizerIteration( void ) const;
+    double GetMetricValue( void ) const;
     std::vector< std::map< std::string, std::vector< std::string > > > GetTransformParameterMap( void );
     std::map< std::string, std::vector< std::string > > GetTransformParameterMap( const unsigned int index );
     Image GetResultImage( void );
 
+    // Register each moving image to the fixed images, one after the other
+    VectorOfImage ExecuteBatch( const VectorOfImage& movingImages );
+    std::vector< std::map< std::string, std::vector< std::string > > > GetBatchTransformParameterMap( const unsigned int index );
+    unsigned int GetNumberOfBatchTransformParameterMaps( void );
+
+    // Run the registration on a worker thread of the library and return a handle to it
+    SimpleElastixFuture ExecuteAsync( void );
+    static void SetNumberOfAsyncWorkers( const unsigned int numberOfAsyncWorkers );
+    static unsigned int GetNumberOfAsyncWorkers( void );
+    static unsigned int GetNumberOfQueuedAsyncRegistrations( void );
+    static void ShutdownAsyncWorkers( void );
+
     std::vector< std::map< std::string, std::vector< std::string > > > ExecuteInverse( void );
     std::vector< std::map< std::string, std::vector< std::string > > > ExecuteInverse( std::map< std::string, std::vector< std::string > > inverseParameterMap );
     std::vector< std::map< std::string, std::vector< std::string > > > ExecuteInverse( std::vector< std::map< std::string, std::vector< std::string > > > inverseParameterMapVector );
@@ -137,13 +227,49 @@ class SITKCommon_EXPORT SimpleElastix
 
     struct SimpleElastixImpl;
     SimpleElastixImpl* m_Pimple;
+
+    struct AsyncJob;
+    friend class SimpleElastixFuture;
     
 };
 
+// Handle to a registration started with SimpleElastix::ExecuteAsync()
+class SITKCommon_EXPORT SimpleElastixFuture
+{
+  public:
+
+    SimpleElastixFuture( void );
+    SimpleElastixFuture( const SimpleElastixFuture& future );
+    ~SimpleElastixFuture( void );
+    SimpleElastixFuture& operator=( const SimpleElastixFuture& future );
+
+    bool IsValid( void ) const;
+    bool IsDone( void );
+    bool IsCancelled( void );
+
+    void Wait( void );
+
+    // Returns true if the registration finished within the given number of seconds
+    bool WaitFor( const double seconds );
+
+    void Cancel( void );
+
+    Image GetResultImage( void );
+    std::vector< std::map< std::string, std::vector< std::string > > > GetTransformParameterMap( void );
+
+  private:
+
+    friend class SimpleElastix;
+    explicit SimpleElastixFuture( SimpleElastix::AsyncJob* job );
+
+    SimpleElastix::AsyncJob* m_Job;
+
+};
+
 // Procedural Interface 
 SITKCommon_EXPORT std::map< std::string, std::vector< std::string > > GetDefaultParameterMap( const std::string transform, const unsigned int numberOfResolutions = 4, const double finalGridSpacingInPhysicalUnits = 8.0 );
 SITKCommon_EXPORT std::map< std::string, std::vector< std::string > > ReadParameterFile( const std::string filename );
-SITKCommon_EXPORT void WriteParameterFile( const std::map< std::string, std::vector< std::string > > parameterMap, const std::string filename );
+SITKCommon_EXPORT void WriteParameterFile( const std::map< std::string, std::vector< std::string > >& parameterMap, const std::string filename );
 SITKCommon_EXPORT void PrintParameterMap( const std::map< std::string, std::vector< std::string > > parameterMap );
 SITKCommon_EXPORT void PrintParameterMap( const std::vector< std::map< std::string, std::vector< std::string > > > parameterMapVector );
 SITKCommon_EXPORT Image Elastix( const Image& fixedImage, const Image& movingImage, const bool logToConsole = false, const bool logToFile = false, const std::string outputDirectory = "." );
@@ -3,11 +3,14 @@
 
 #include "sitkCommon.h"
 #include "sitkImage.h"
+#include "sitkTransform.h"
+#include "sitkProcessObject.h"
 
 namespace itk { 
   namespace simple {
 
 class SITKCommon_EXPORT SimpleTransformix
+  : public ProcessObject
 {
   public:
 
@@ -15,6 +18,9 @@ class SITKCommon_EXPORT SimpleTransformix
     ~SimpleTransformix( void );
 
     typedef SimpleTransformix Self;                                
+    typedef ProcessObject Superclass;
+
+    typedef std::vector< Image >                                    VectorOfImage;
 
     typedef std::string                                             ParameterKeyType;
     typedef std::string                                             ParameterValueType;
@@ -25,7 +31,7 @@ class SITKCommon_EXPORT SimpleTransformix
     typedef ParameterMapType::iterator                              ParameterMapIterator;
     typedef ParameterMapType::const_iterator                        ParameterMapConstIterator;
 
-    const std::string GetName( void );
+    std::string GetName( void ) const;
 
     Self& SetMovingImage( const Image& movingImage );
     Image& GetMovingImage( void );
@@ -35,6 +41,12 @@ class SITKCommon_EXPORT SimpleTransformix
     std::string GetFixedPointSetFileName( void );
     Self& RemoveFixedPointSetFileName( void );
 
+    // Points in memory, one point per vector or packed as x0, y0, z0, x1, ...
+    Self& SetFixedPointSet( const std::vector< std::vector< double > >& fixedPointSet );
+    Self& SetFixedPointSet( const std::vector< double >& fixedPointSet, const unsigned int dimension );
+    std::vector< std::vector< double > > GetFixedPointSet( void );
+    Self& RemoveFixedPointSet( void );
+
     Self& SetComputeSpatialJacobian( const bool );
     bool GetComputeSpatialJacobian( void );
     Self& ComputeSpatialJacobianOn( void );
@@ -68,9 +80,18 @@ class SITKCommon_EXPORT SimpleTransformix
     Self& LogToConsoleOn();
     Self& LogToConsoleOff();
 
-    Self& SetTransformParameterMap( const std::vector< std::map< std::string, std::vector< std::string > > > parameterMapVector );
-    Self& SetTransformParameterMap( const std::map< std::string, std::vector< std::string > > parameterMap );
-    Self& AddTransformParameterMap( const std::map< std::string, std::vector< std::string > > parameterMap );
+    // Keep the log of Execute() in memory
+    Self& SetLogToMemory( const bool logToMemory );
+    bool GetLogToMemory( void );
+    Self& LogToMemoryOn( void );
+    Self& LogToMemoryOff( void );
+    Self& SetMaximumLogSize( const unsigned int maximumLogSize );
+    unsigned int GetMaximumLogSize( void );
+    std::string GetLog( void );
+
+    Self& SetTransformParameterMap( const std::vector< std::map< std::string, std::vector< std::string > > >& parameterMapVector );
+    Self& SetTransformParameterMap( const std::map< std::string, std::vector< std::string > >& parameterMap );
+    Self& AddTransformParameterMap( const std::map< std::string, std::vector< std::string > >& parameterMap );
     std::vector< std::map< std::string, std::vector< std::string > > > GetTransformParameterMap( void );
     unsigned int GetNumberOfTransformParameterMaps( void );
 
@@ -86,7 +107,7 @@ class SITKCommon_EXPORT SimpleTransformix
     Self& RemoveTransformParameter( const unsigned int index, const std::string key );
 
     std::map< std::string, std::vector< std::string > > ReadParameterFile( const std::string parameterFileName );
-    Self& WriteParameterFile( const std::map< std::string, std::vector< std::string > > parameterMap, const std::string parameterFileName );
+    Self& WriteParameterFile( const std::map< std::string, std::vector< std::string > >& parameterMap, const std::string parameterFileName );
 
     Self& PrintParameterMap( void );
     Self& PrintParameterMap( const std::map< std::string, std::vector< std::string > > parameterMap );
@@ -94,7 +115,23 @@ class SITKCommon_EXPORT SimpleTransformix
 
     Image Execute( void );
 
+    // Warp several images through one cached deformation field, each with its own interpolation order
+    VectorOfImage Execute( const VectorOfImage& movingImages );
+    VectorOfImage Execute( const VectorOfImage& movingImages, const std::vector< unsigned int >& finalBSplineInterpolationOrders, const std::vector< double >& defaultPixelValues );
+
+    // Warp a moving image from file to file in tiles, so that it need not fit in memory
+    Self& ExecuteToFile( const std::string movingImageFileName, const std::string resultImageFileName, const unsigned int numberOfTiles = 16u );
+
     Image GetResultImage( void );
+    std::vector< std::vector< double > > GetTransformedPoints( void );
+
+    // Output fields, computed in memory unless GetTransform() cannot convert the transform
+    Image GetDeformationField( void );
+    Image GetSpatialJacobian( void );
+    Image GetDeterminantOfSpatialJacobian( void );
+
+    // Convert the transform parameter maps into a Transform without running transformix
+    Transform GetTransform( void );
 
   private:
 
@@ -3,12 +3,13 @@
 
 #include "sitkSimpleElastix.h"
 #include "sitkSimpleElastixImpl.h"
+#include "sitkSimpleElastixUtilities.h"
 
 namespace itk {
   namespace simple {
 
 SimpleElastix
-::SimpleElastix( void ) : m_Pimple( new SimpleElastixImpl )
+::SimpleElastix( void ) : m_Pimple( new SimpleElastixImpl( this ) )
 {
 }
 
@@ -19,9 +20,9 @@ SimpleElastix
   m_Pimple = NULL;
 }
 
-const std::string 
+std::string 
 SimpleElastix
-::GetName( void )
+::GetName( void ) const
 { 
   return this->m_Pimple->GetName();
 }
@@ -87,6 +88,51 @@ SimpleElastix
   return this->m_Pimple->GetNumberOfFixedImages();
 }
 
+SimpleElastix::Self& 
+SimpleElastix
+::SetCacheFixedImages( const bool cacheFixedImages )
+{
+  this->m_Pimple->SetCacheFixedImages( cacheFixedImages );
+  return *this;
+}
+
+bool
+SimpleElastix
+::GetCacheFixedImages( void )
+{
+  return this->m_Pimple->GetCacheFixedImages();
+}
+
+SimpleElastix::Self& 
+SimpleElastix
+::CacheFixedImagesOn( void )
+{
+  this->m_Pimple->CacheFixedImagesOn();
+  return *this;
+}
+
+SimpleElastix::Self& 
+SimpleElastix
+::CacheFixedImagesOff( void )
+{
+  this->m_Pimple->CacheFixedImagesOff();
+  return *this;
+}
+
+uint64_t
+SimpleElastix
+::GetFixedImageCacheHits( void )
+{
+  return this->m_Pimple->GetFixedImageCacheHits();
+}
+
+uint64_t
+SimpleElastix
+::GetFixedImageCacheMisses( void )
+{
+  return this->m_Pimple->GetFixedImageCacheMisses();
+}
+
 SimpleElastix::Self& 
 SimpleElastix
 ::SetMovingImage( const Image& movingImage )
@@ -209,6 +255,29 @@ SimpleElastix
   return this->m_Pimple->GetNumberOfFixedMasks();
 }
 
+SimpleElastix::Self& 
+SimpleElastix
+::SetFixedMaskLabel( const int64_t fixedMaskLabel )
+{
+  this->m_Pimple->SetFixedMaskLabel( fixedMaskLabel );
+  return *this;
+}
+
+int64_t
+SimpleElastix
+::GetFixedMaskLabel( void )
+{
+  return this->m_Pimple->GetFixedMaskLabel();
+}
+
+SimpleElastix::Self& 
+SimpleElastix
+::RemoveFixedMaskLabel( void )
+{
+  this->m_Pimple->RemoveFixedMaskLabel();
+  return *this;
+}
+
 SimpleElastix::Self& 
 SimpleElastix
 ::SetMovingMask( const Image& movingMask )
@@ -270,6 +339,29 @@ SimpleElastix
   return this->m_Pimple->GetNumberOfMovingMasks();
 }
 
+SimpleElastix::Self& 
+SimpleElastix
+::SetMovingMaskLabel( const int64_t movingMaskLabel )
+{
+  this->m_Pimple->SetMovingMaskLabel( movingMaskLabel );
+  return *this;
+}
+
+int64_t
+SimpleElastix
+::GetMovingMaskLabel( void )
+{
+  return this->m_Pimple->GetMovingMaskLabel();
+}
+
+SimpleElastix::Self& 
+SimpleElastix
+::RemoveMovingMaskLabel( void )
+{
+  this->m_Pimple->RemoveMovingMaskLabel();
+  return *this;
+}
+
 SimpleElastix::Self& 
 SimpleElastix
 ::SetFixedPointSetFileName( const std::string fixedPointSetFileName )
@@ -316,6 +408,68 @@ SimpleElastix
   return *this;
 }
 
+SimpleElastix::Self&
+SimpleElastix
+::SetFixedPointSet( const std::vector< std::vector< double > >& fixedPointSet )
+{
+  this->m_Pimple->SetFixedPointSet( fixedPointSet );
+  return *this;
+}
+
+SimpleElastix::Self&
+SimpleElastix
+::SetFixedPointSet( const std::vector< double >& fixedPointSet, const unsigned int dimension )
+{
+  this->m_Pimple->SetFixedPointSet( MakeElastixPointSet( fixedPointSet, dimension ) );
+  return *this;
+}
+
+std::vector< std::vector< double > >
+SimpleElastix
+::GetFixedPointSet( void )
+{
+  return this->m_Pimple->GetFixedPointSet();
+}
+
+SimpleElastix::Self&
+SimpleElastix
+::RemoveFixedPointSet( void )
+{
+  this->m_Pimple->RemoveFixedPointSet();
+  return *this;
+}
+
+SimpleElastix::Self&
+SimpleElastix
+::SetMovingPointSet( const std::vector< std::vector< double > >& movingPointSet )
+{
+  this->m_Pimple->SetMovingPointSet( movingPointSet );
+  return *this;
+}
+
+SimpleElastix::Self&
+SimpleElastix
+::SetMovingPointSet( const std::vector< double >& movingPointSet, const unsigned int dimension )
+{
+  this->m_Pimple->SetMovingPointSet( MakeElastixPointSet( movingPointSet, dimension ) );
+  return *this;
+}
+
+std::vector< std::vector< double > >
+SimpleElastix
+::GetMovingPointSet( void )
+{
+  return this->m_Pimple->GetMovingPointSet();
+}
+
+SimpleElastix::Self&
+SimpleElastix
+::RemoveMovingPointSet( void )
+{
+  this->m_Pimple->RemoveMovingPointSet();
+  return *this;
+}
+
 SimpleElastix::Self& 
 SimpleElastix
 ::SetOutputDirectory( const std::string outputDirectory )
@@ -424,6 +578,177 @@ SimpleElastix
   return *this;
 }
 
+SimpleElastix::Self& 
+SimpleElastix
+::SetLogToMemory( const bool logToMemory )
+{
+  this->m_Pimple->SetLogToMemory( logToMemory );
+  return *this;
+}
+
+bool
+SimpleElastix
+::GetLogToMemory( void )
+{
+  return this->m_Pimple->GetLogToMemory();
+}
+
+SimpleElastix::Self& 
+SimpleElastix
+::LogToMemoryOn( void )
+{
+  this->m_Pimple->LogToMemoryOn();
+  return *this;
+}
+
+SimpleElastix::Self& 
+SimpleElastix
+::LogToMemoryOff( void )
+{
+  this->m_Pimple->LogToMemoryOff();
+  return *this;
+}
+
+SimpleElastix::Self& 
+SimpleElastix
+::SetMaximumLogSize( const unsigned int maximumLogSize )
+{
+  this->m_Pimple->SetMaximumLogSize( maximumLogSize );
+  return *this;
+}
+
+unsigned int
+SimpleElastix
+::GetMaximumLogSize( void )
+{
+  return this->m_Pimple->GetMaximumLogSize();
+}
+
+std::string
+SimpleElastix
+::GetLog( void )
+{
+  return this->m_Pimple->GetLog();
+}
+
+std::vector< std::vector< double > >
+SimpleElastix
+::GetIterationTable( void )
+{
+  return this->m_Pimple->GetIterationTable();
+}
+
+SimpleElastix::Self& 
+SimpleElastix
+::SetComputeResultImage( const bool computeResultImage )
+{
+  this->m_Pimple->SetComputeResultImage( computeResultImage );
+  return *this;
+}
+
+bool
+SimpleElastix
+::GetComputeResultImage( void )
+{
+  return this->m_Pimple->GetComputeResultImage();
+}
+
+SimpleElastix::Self& 
+SimpleElastix
+::ComputeResultImageOn( void )
+{
+  this->m_Pimple->ComputeResultImageOn();
+  return *this;
+}
+
+SimpleElastix::Self& 
+SimpleElastix
+::ComputeResultImageOff( void )
+{
+  this->m_Pimple->ComputeResultImageOff();
+  return *this;
+}
+
+SimpleElastix::Self& 
+SimpleElastix
+::SetUseResultCache( const bool useResultCache )
+{
+  this->m_Pimple->SetUseResultCache( useResultCache );
+  return *this;
+}
+
+bool
+SimpleElastix
+::GetUseResultCache( void )
+{
+  return this->m_Pimple->GetUseResultCache();
+}
+
+SimpleElastix::Self& 
+SimpleElastix
+::UseResultCacheOn( void )
+{
+  this->m_Pimple->UseResultCacheOn();
+  return *this;
+}
+
+SimpleElastix::Self& 
+SimpleElastix
+::UseResultCacheOff( void )
+{
+  this->m_Pimple->UseResultCacheOff();
+  return *this;
+}
+
+void
+SimpleElastix
+::SetResultCacheMaximumSize( const uint64_t maximumSize )
+{
+  SimpleElastixImpl::SetResultCacheMaximumSize( maximumSize );
+}
+
+uint64_t
+SimpleElastix
+::GetResultCacheMaximumSize( void )
+{
+  return SimpleElastixImpl::GetResultCacheMaximumSize();
+}
+
+uint64_t
+SimpleElastix
+::GetResultCacheSize( void )
+{
+  return SimpleElastixImpl::GetResultCacheSize();
+}
+
+uint64_t
+SimpleElastix
+::GetResultCacheHits( void )
+{
+  return SimpleElastixImpl::GetResultCacheHits();
+}
+
+uint64_t
+SimpleElastix
+::GetResultCacheMisses( void )
+{
+  return SimpleElastixImpl::GetResultCacheMisses();
+}
+
+void
+SimpleElastix
+::ClearResultCache( void )
+{
+  SimpleElastixImpl::ClearResultCache();
+}
+
+uint64_t
+SimpleElastix
+::GetNumberOfHashedImages( void )
+{
+  return this->m_Pimple->GetNumberOfHashedImages();
+}
+
 SimpleElastix::Self& 
 SimpleElastix
 ::SetParameterMap( const std::string transformName, const unsigned int numberOfResolutions, const double finalGridSpacingInPhysicalUnits )
@@ -434,7 +759,7 @@ SimpleElastix
 
 SimpleElastix::Self& 
 SimpleElastix
-::SetParameterMap( const ParameterMapType parameterMap )
+::SetParameterMap( const ParameterMapType& parameterMap )
 {
   this->m_Pimple->SetParameterMap( parameterMap );
   return *this;
@@ -442,7 +767,7 @@ SimpleElastix
 
 SimpleElastix::Self& 
 SimpleElastix
-::SetParameterMap( const ParameterMapVectorType parameterMapVector )
+::SetParameterMap( const ParameterMapVectorType& parameterMapVector )
 {
   this->m_Pimple->SetParameterMap( parameterMapVector );
   return *this;
@@ -450,7 +775,7 @@ SimpleElastix
 
 SimpleElastix::Self& 
 SimpleElastix
-::AddParameterMap( const ParameterMapType parameterMap )
+::AddParameterMap( const ParameterMapType& parameterMap )
 {
   this->m_Pimple->AddParameterMap( parameterMap );
   return *this;
@@ -493,6 +818,74 @@ SimpleElastix
   return *this;
 }
 
+SimpleElastix::Self&
+SimpleElastix
+::SetInitialTransformParameterMap( const std::vector< std::map< std::string, std::vector< std::string > > >& initialTransformParameterMapVector )
+{
+  this->m_Pimple->SetInitialTransformParameterMap( initialTransformParameterMapVector );
+  return *this;
+}
+
+std::vector< std::map< std::string, std::vector< std::string > > >
+SimpleElastix
+::GetInitialTransformParameterMap( void )
+{
+  return this->m_Pimple->GetInitialTransformParameterMap();
+}
+
+SimpleElastix::Self&
+SimpleElastix
+::RemoveInitialTransformParameterMap( void )
+{
+  this->m_Pimple->RemoveInitialTransformParameterMap();
+  return *this;
+}
+
+SimpleElastix::Self&
+SimpleElastix
+::SetMultiStartCandidates( const std::vector< std::vector< double > >& candidates )
+{
+  this->m_Pimple->SetMultiStartCandidates( candidates );
+  return *this;
+}
+
+SimpleElastix::Self&
+SimpleElastix
+::AddMultiStartCandidate( const std::vector< double >& candidate )
+{
+  this->m_Pimple->AddMultiStartCandidate( candidate );
+  return *this;
+}
+
+std::vector< std::vector< double > >
+SimpleElastix
+::GetMultiStartCandidates( void )
+{
+  return this->m_Pimple->GetMultiStartCandidates();
+}
+
+SimpleElastix::Self&
+SimpleElastix
+::RemoveMultiStartCandidates( void )
+{
+  this->m_Pimple->RemoveMultiStartCandidates();
+  return *this;
+}
+
+std::vector< double >
+SimpleElastix
+::GetMultiStartMetricValues( void )
+{
+  return this->m_Pimple->GetMultiStartMetricValues();
+}
+
+unsigned int
+SimpleElastix
+::GetBestMultiStartCandidate( void )
+{
+  return this->m_Pimple->GetBestMultiStartCandidate();
+}
+
 SimpleElastix::Self&
 SimpleElastix
 ::SetParameter( const ParameterKeyType key, const ParameterValueType value )
@@ -596,7 +989,7 @@ SimpleElastix
 
 SimpleElastix::Self&
 SimpleElastix
-::WriteParameterFile( ParameterMapType const parameterMap, const std::string parameterFileName )
+::WriteParameterFile( const ParameterMapType& parameterMap, const std::string parameterFileName )
 {
   this->m_Pimple->WriteParameterFile( parameterMap, parameterFileName);
   return *this;
@@ -616,6 +1009,27 @@ SimpleElastix
   return this->m_Pimple->Execute();
 }
 
+unsigned int
+SimpleElastix
+::GetCurrentLevel( void ) const
+{
+  return this->m_Pimple->GetCurrentLevel();
+}
+
+unsigned int
+SimpleElastix
+::GetOptimizerIteration( void ) const
+{
+  return this->m_Pimple->GetOptimizerIteration();
+}
+
+double
+SimpleElastix
+::GetMetricValue( void ) const
+{
+  return this->m_Pimple->GetMetricValue();
+}
+
 SimpleElastix::ParameterMapVectorType 
 SimpleElastix
 ::GetTransformParameterMap( void )
@@ -637,6 +1051,62 @@ SimpleElastix
   return this->m_Pimple->GetResultImage();
 }
 
+SimpleElastix::VectorOfImage
+SimpleElastix
+::ExecuteBatch( const VectorOfImage& movingImages )
+{
+  return this->m_Pimple->ExecuteBatch( movingImages );
+}
+
+SimpleElastix::ParameterMapVectorType
+SimpleElastix
+::GetBatchTransformParameterMap( const unsigned int index )
+{
+  return this->m_Pimple->GetBatchTransformParameterMap( index );
+}
+
+unsigned int
+SimpleElastix
+::GetNumberOfBatchTransformParameterMaps( void )
+{
+  return this->m_Pimple->GetNumberOfBatchTransformParameterMaps();
+}
+
+SimpleElastixFuture
+SimpleElastix
+::ExecuteAsync( void )
+{
+  return SimpleElastixFuture( this->m_Pimple->ExecuteAsync() );
+}
+
+void
+SimpleElastix
+::SetNumberOfAsyncWorkers( const unsigned int numberOfAsyncWorkers )
+{
+  AsyncJob::SetMaximumNumberOfWorkers( numberOfAsyncWorkers );
+}
+
+unsigned int
+SimpleElastix
+::GetNumberOfAsyncWorkers( void )
+{
+  return AsyncJob::GetMaximumNumberOfWorkers();
+}
+
+unsigned int
+SimpleElastix
+::GetNumberOfQueuedAsyncRegistrations( void )
+{
+  return AsyncJob::GetNumberOfQueuedJobs();
+}
+
+void
+SimpleElastix
+::ShutdownAsyncWorkers( void )
+{
+  AsyncJob::Shutdown();
+}
+
 SimpleElastix::ParameterMapVectorType
 SimpleElastix
 ::ExecuteInverse( void )
@@ -710,7 +1180,7 @@ ReadParameterFile( const std::string fileName )
 }
 
 void
-WriteParameterFile( const SimpleElastix::ParameterMapType parameterMap, const std::string filename )
+WriteParameterFile( const SimpleElastix::ParameterMapType& parameterMap, const std::string filename )
 {
   SimpleElastix selx;
   selx.WriteParameterFile( parameterMap, filename );
@@ -814,6 +1284,143 @@ Elastix( const Image& fixedImage, const Image& movingImage, SimpleElastix::Param
   return selx.Execute();
 }
 
+SimpleElastixFuture
+::SimpleElastixFuture( void ) : m_Job( NULL )
+{
+}
+
+SimpleElastixFuture
+::SimpleElastixFuture( SimpleElastix::AsyncJob* job ) : m_Job( job )
+{
+}
+
+SimpleElastixFuture
+::SimpleElastixFuture( const SimpleElastixFuture& future ) : m_Job( future.m_Job )
+{
+  if( this->m_Job )
+  {
+    this->m_Job->Register();
+  }
+}
+
+SimpleElastixFuture
+::~SimpleElastixFuture( void )
+{
+  if( this->m_Job )
+  {
+    this->m_Job->UnRegister();
+  }
+}
+
+SimpleElastixFuture&
+SimpleElastixFuture
+::operator=( const SimpleElastixFuture& future )
+{
+  if( future.m_Job )
+  {
+    future.m_Job->Register();
+  }
+
+  if( this->m_Job )
+  {
+    this->m_Job->UnRegister();
+  }
+
+  this->m_Job = future.m_Job;
+  return *this;
+}
+
+bool
+SimpleElastixFuture
+::IsValid( void ) const
+{
+  return this->m_Job != NULL;
+}
+
+bool
+SimpleElastixFuture
+::IsDone( void )
+{
+  if( !this->m_Job )
+  {
+    sitkExceptionMacro( "Future does not refer to a registration. Start one with SimpleElastix::ExecuteAsync()." );
+  }
+
+  return this->m_Job->IsDone();
+}
+
+bool
+SimpleElastixFuture
+::IsCancelled( void )
+{
+  if( !this->m_Job )
+  {
+    sitkExceptionMacro( "Future does not refer to a registration. Start one with SimpleElastix::ExecuteAsync()." );
+  }
+
+  return this->m_Job->IsCancelled();
+}
+
+void
+SimpleElastixFuture
+::Wait( void )
+{
+  if( !this->m_Job )
+  {
+    sitkExceptionMacro( "Future does not refer to a registration. Start one with SimpleElastix::ExecuteAsync()." );
+  }
+
+  this->m_Job->Wait();
+}
+
+bool
+SimpleElastixFuture
+::WaitFor( const double seconds )
+{
+  if( !this->m_Job )
+  {
+    sitkExceptionMacro( "Future does not refer to a registration. Start one with SimpleElastix::ExecuteAsync()." );
+  }
+
+  return this->m_Job->WaitFor( seconds );
+}
+
+void
+SimpleElastixFuture
+::Cancel( void )
+{
+  if( !this->m_Job )
+  {
+    sitkExceptionMacro( "Future does not refer to a registration. Start one with SimpleElastix::ExecuteAsync()." );
+  }
+
+  this->m_Job->Cancel();
+}
+
+Image
+SimpleElastixFuture
+::GetResultImage( void )
+{
+  if( !this->m_Job )
+  {
+    sitkExceptionMacro( "Future does not refer to a registration. Start one with SimpleElastix::ExecuteAsync()." );
+  }
+
+  return this->m_Job->GetResultImage();
+}
+
+SimpleElastix::ParameterMapVectorType
+SimpleElastixFuture
+::GetTransformParameterMap( void )
+{
+  if( !this->m_Job )
+  {
+    sitkExceptionMacro( "Future does not refer to a registration. Start one with SimpleElastix::ExecuteAsync()." );
+  }
+
+  return this->m_Job->GetTransformParameterMap();
+}
+
 } // end namespace simple
 } // end namespace itk
 
@@ -3,21 +3,90 @@
 
 #include "sitkSimpleElastix.h"
 #include "sitkSimpleElastixImpl.h"
+#include "sitkBinaryThresholdImageFilter.h"
 #include "sitkCastImageFilter.h"
+#include "sitkHashImageFilter.h"
+#include "sitkLabelMapToLabelImageFilter.h"
+#include "sitkSimpleElastixUtilities.h"
+
+#include "Ancillary/hl_sha1.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <sstream>
 
 namespace itk {
   namespace simple {
 
+namespace
+{
+static bool
+IsLabelMapPixelID( const PixelIDValueType pixelID )
+{
+  return pixelID == sitkLabelUInt8 || pixelID == sitkLabelUInt16 || pixelID == sitkLabelUInt32 || pixelID == sitkLabelUInt64;
+}
+
+// Masks may be given as any integer image or label map, and are converted to the unsigned char masks of elastix
+static bool
+IsMaskPixelID( const PixelIDValueType pixelID )
+{
+  return pixelID == sitkUInt8 || pixelID == sitkInt8 || pixelID == sitkUInt16 || pixelID == sitkInt16
+      || pixelID == sitkUInt32 || pixelID == sitkInt32 || pixelID == sitkUInt64 || pixelID == sitkInt64
+      || IsLabelMapPixelID( pixelID );
+}
+
+// Results of registrations that ran with UseResultCacheOn(), shared by all SimpleElastix objects
+// of the process. The most recently used entry is at the front.
+struct ResultCacheEntry
+{
+  std::string                   Key;
+  SimpleElastix::ParameterMapVectorType TransformParameterMapVector;
+  Image                         ResultImage;
+  std::vector< double >         MultiStartMetricValues;
+  unsigned int                  BestMultiStartCandidate;
+  uint64_t                      Size;
+};
+
+static std::list< ResultCacheEntry > ResultCache;
+static itk::SimpleFastMutexLock ResultCacheMutex;
+static uint64_t ResultCacheSize = 0;
+static uint64_t ResultCacheMaximumSize = 1024ul * 1024ul * 1024ul;
+static uint64_t ResultCacheHits = 0;
+static uint64_t ResultCacheMisses = 0;
+
+uint64_t GetSizeOfPixelComponent( const Image& image )
+{
+  switch( image.GetPixelID() )
+  {
+    case sitkUInt8: case sitkInt8: case sitkVectorUInt8: case sitkVectorInt8: case sitkLabelUInt8:
+      return 1;
+    case sitkUInt16: case sitkInt16: case sitkVectorUInt16: case sitkVectorInt16: case sitkLabelUInt16:
+      return 2;
+    case sitkUInt32: case sitkInt32: case sitkFloat32: case sitkVectorUInt32: case sitkVectorInt32: case sitkVectorFloat32: case sitkLabelUInt32:
+      return 4;
+    case sitkComplexFloat64:
+      return 16;
+    default:
+      return 8;
+  }
+}
+}
+
 SimpleElastix::SimpleElastixImpl
-::SimpleElastixImpl( void )
+::SimpleElastixImpl( SimpleElastix* processObject )
 {
   // Register this class with SimpleITK
   this->m_DualMemberFactory.reset( new detail::DualMemberFunctionFactory< MemberFunctionType >( this ) );
-  this->m_DualMemberFactory->RegisterMemberFunctions< FloatPixelIDTypeList, FloatPixelIDTypeList, 2 >();
-  this->m_DualMemberFactory->RegisterMemberFunctions< FloatPixelIDTypeList, FloatPixelIDTypeList, 3 >();
+  this->RegisterDualExecuteInternal< 2 >();
+  this->RegisterDualExecuteInternal< 3 >();
 
 #ifdef SITK_4D_IMAGES
-  this->m_DualMemberFactory->RegisterMemberFunctions< FloatPixelIDTypeList, FloatPixelIDTypeList, 4 >();
+  this->RegisterDualExecuteInternal< 4 >();
 #endif
  
   m_FixedImages                 = VectorOfImage();
@@ -31,12 +100,43 @@ SimpleElastix::SimpleElastixImpl
 
   m_FixedPointSetFileName       = "";
   m_MovingPointSetFileName      = "";
+  m_FixedPointSet               = PointSetType();
+  m_MovingPointSet              = PointSetType();
 
   m_OutputDirectory             = ".";
   m_LogFileName                 = "";
 
   this->m_LogToFile = false;
   this->m_LogToConsole = false;
+  this->m_LogToMemory = false;
+  this->m_ComputeResultImage = true;
+  this->m_CacheFixedImages = false;
+  this->m_FixedImageCacheHits = 0;
+  this->m_FixedImageCacheMisses = 0;
+  this->m_NumberOfHashedImages = 0;
+  this->m_BestMultiStartCandidate = 0;
+  this->m_HasFixedMaskLabel = false;
+  this->m_FixedMaskLabel = 0;
+  this->m_HasMovingMaskLabel = false;
+  this->m_MovingMaskLabel = 0;
+  this->m_UseResultCache = false;
+
+  this->m_NumberOfThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+
+  this->m_ProcessObject = processObject;
+  this->m_ActiveElastixFilter = NULL;
+  this->m_CurrentParameterMap = 0;
+  this->m_CurrentLevel = 0;
+  this->m_OptimizerIteration = 0;
+  this->m_MetricValue = 0.0;
+  this->m_HasStartedResolution = false;
+  this->m_IsInIterationTable = false;
+  this->m_MetricColumn = 1;
+  this->m_StepSizeColumn = -1;
+  this->m_ExactMetricColumn = -1;
+  this->m_ExactMetricValue = std::numeric_limits< double >::quiet_NaN();
+  this->m_Aborted = false;
+  this->m_AbortRequested = false;
 
   ParameterMapVectorType defaultParameterMap;
   defaultParameterMap.push_back( ParameterObjectType::GetDefaultParameterMap( "translation" ) );
@@ -65,912 +165,2962 @@ SimpleElastix::SimpleElastixImpl
     sitkExceptionMacro( "Moving image not set." );
   }
 
-  const PixelIDValueEnum FixedImagePixelID = this->GetFixedImage( 0 ).GetPixelID();
-  const unsigned int FixedImageDimension = this->GetFixedImage( 0 ).GetDimension();
-  const PixelIDValueEnum MovingImagePixelID = this->GetMovingImage( 0 ).GetPixelID();
-  const unsigned int MovingImageDimension = this->GetMovingImage( 0 ).GetDimension();
+  const PixelIDValueEnum FixedImagePixelID = this->m_FixedImages[ 0 ].GetPixelID();
+  const unsigned int FixedImageDimension = this->m_FixedImages[ 0 ].GetDimension();
+  const PixelIDValueEnum MovingImagePixelID = this->m_MovingImages[ 0 ].GetPixelID();
+  const unsigned int MovingImageDimension = this->m_MovingImages[ 0 ].GetDimension();
 
   for( unsigned int i = 1; i < this->GetNumberOfFixedImages(); ++i )
   {
-    if( this->GetFixedImage( i ).GetDimension() != FixedImageDimension )
+    if( this->m_FixedImages[ i ].GetDimension() != FixedImageDimension )
     {
       sitkExceptionMacro( "Fixed images must be of same dimension (fixed image at index 0 is of dimension " 
-                       << this->GetFixedImage( 0 ).GetDimension() << ", fixed image at index " << i
-                       << " is of dimension \"" << this->GetFixedImage( i ).GetDimension() << "\")." );
+                       << this->m_FixedImages[ 0 ].GetDimension() << ", fixed image at index " << i
+                       << " is of dimension \"" << this->m_FixedImages[ i ].GetDimension() << "\")." );
     }
   }
 
   for( unsigned int i = 1; i < this->GetNumberOfMovingImages(); ++i )
   {
-    if( this->GetMovingImage( i ).GetDimension() != MovingImageDimension )
+    if( this->m_MovingImages[ i ].GetDimension() != MovingImageDimension )
     {
       sitkExceptionMacro( "Moving images must be of same dimension as fixed images (fixed image at index 0 is of dimension " 
-                       << this->GetFixedImage( 0 ).GetDimension() << ", moving image at index " << i
-                       << " is of dimension \"" << this->GetMovingImage( i ).GetDimension() << "\")." );
+                       << this->m_FixedImages[ 0 ].GetDimension() << ", moving image at index " << i
+                       << " is of dimension \"" << this->m_MovingImages[ i ].GetDimension() << "\")." );
     }
   }
 
   for( unsigned int i = 1; i < this->GetNumberOfFixedMasks(); ++i )
   {
-    if( this->GetFixedMask( i ).GetDimension() != FixedImageDimension )
+    if( this->m_FixedMasks[ i ].GetDimension() != FixedImageDimension )
     {
       sitkExceptionMacro( "Fixed masks must be of same dimension as fixed images (fixed images are of dimension " 
-                       << this->GetFixedImage( 0 ).GetDimension() << ", fixed mask at index " << i
-                       << " is of dimension \"" << this->GetFixedMask( i ).GetDimension() << "\")." );
+                       << this->m_FixedImages[ 0 ].GetDimension() << ", fixed mask at index " << i
+                       << " is of dimension \"" << this->m_FixedMasks[ i ].GetDimension() << "\")." );
     }
   }
 
   for( unsigned int i = 1; i < this->GetNumberOfMovingMasks(); ++i )
   {
-    if( this->GetMovingMask( i ).GetDimension() != MovingImageDimension )
+    if( this->m_MovingMasks[ i ].GetDimension() != MovingImageDimension )
     {
       sitkExceptionMacro( "Moving masks must be of same dimension as moving images (moving images are of dimension " 
-                       << this->GetMovingImage( 0 ).GetDimension() << ", moving mask at index " << i
-                       << " is of dimension \"" << this->GetMovingMask( i ).GetDimension() << "\")." );
+                       << this->m_MovingImages[ 0 ].GetDimension() << ", moving mask at index " << i
+                       << " is of dimension \"" << this->m_MovingMasks[ i ].GetDimension() << "\")." );
     }
   }
 
   for( unsigned int i = 0; i < this->GetNumberOfFixedMasks(); ++i )
   {
-    if( this->GetFixedMask( i ).GetPixelID() != sitkUInt8 )
+    if( !IsMaskPixelID( this->m_FixedMasks[ i ].GetPixelID() ) )
     {
-      sitkExceptionMacro( "Fixed mask must be of pixel type unsigned char (fixed mask at index " 
-                       << i << " is of type \"" << GetPixelIDValueAsElastixParameter( this->GetFixedMask( i ).GetPixelID() ) << "\")." );
+      sitkExceptionMacro( "Fixed mask must be of an integer or label pixel type (fixed mask at index " 
+                       << i << " is of type \"" << GetPixelIDValueAsString( this->m_FixedMasks[ i ].GetPixelID() ) << "\")." );
     }
   }
 
   for( unsigned int i = 0; i < this->GetNumberOfMovingMasks(); ++i )
   {
-    if( this->GetMovingMask( i ).GetPixelID() != sitkUInt8 )
+    if( !IsMaskPixelID( this->m_MovingMasks[ i ].GetPixelID() ) )
     {
-      sitkExceptionMacro( "Moving mask must be of pixel type unsigned char (moving mask at index " 
-                       << i << " is of type \"" << GetPixelIDValueAsElastixParameter( this->GetMovingMask( i ).GetPixelID() ) << "\")." );
+      sitkExceptionMacro( "Moving mask must be of an integer or label pixel type (moving mask at index " 
+                       << i << " is of type \"" << GetPixelIDValueAsString( this->m_MovingMasks[ i ].GetPixelID() ) << "\")." );
     }
   }
 
-  if( this->m_DualMemberFactory->HasMemberFunction( sitkFloat32, sitkFloat32, FixedImageDimension ) )
+  const PixelIDValueEnum FixedInternalImagePixelID = this->GetInternalImagePixelID( "FixedInternalImagePixelType", FixedImageDimension );
+  const PixelIDValueEnum MovingInternalImagePixelID = this->GetInternalImagePixelID( "MovingInternalImagePixelType", FixedImageDimension );
+  if( FixedInternalImagePixelID != MovingInternalImagePixelID )
   {
-    return this->m_DualMemberFactory->GetMemberFunction( sitkFloat32, sitkFloat32, FixedImageDimension )();
+    sitkExceptionMacro( "FixedInternalImagePixelType (\"" << GetPixelIDValueAsElastixParameter( FixedInternalImagePixelID )
+                     << "\") and MovingInternalImagePixelType (\"" << GetPixelIDValueAsElastixParameter( MovingInternalImagePixelID )
+                     << "\") must be equal." );
   }
 
-  sitkExceptionMacro( << "SimpleElastix does not support the combination of "
-                      << FixedImageDimension << "-dimensional "
-                      << GetPixelIDValueAsElastixParameter( FixedImagePixelID ) << " fixed image and a "
-                      << MovingImageDimension << "-dimensional " 
-                      << GetPixelIDValueAsElastixParameter( MovingImagePixelID ) << " moving image. "
-                      << "This a serious error. Contact developers at https://github.com/kaspermarstal/SimpleElastix/issues." )
-}
-
-template< typename TFixedImage, typename TMovingImage >
-Image
-SimpleElastix::SimpleElastixImpl
-::DualExecuteInternal( void )
-{
-  typedef elastix::ElastixFilter< TFixedImage, TMovingImage >   ElastixFilterType;
-  typedef typename ElastixFilterType::Pointer                   ElastixFilterPointer;
-  typedef typename ElastixFilterType::FixedMaskType             FixedMaskType;
-  typedef typename ElastixFilterType::MovingMaskType            MovingMaskType;
-
-  try
+  if( this->m_DualMemberFactory->HasMemberFunction( FixedInternalImagePixelID, MovingInternalImagePixelID, FixedImageDimension ) )
   {
-    ElastixFilterPointer elastixFilter = ElastixFilterType::New();
-
-    for( unsigned int i = 0; i < this->GetNumberOfFixedImages(); ++i )
+    // A cached result also stands for the multi-start candidates that led to it
+    std::string resultCacheKey;
+    if( this->m_UseResultCache )
     {
-      elastixFilter->AddFixedImage( itkDynamicCastInDebugMode< TFixedImage* >( Cast( this->GetFixedImage( i ), sitkFloat32 ).GetITKBase() ) );
+      resultCacheKey = this->GetResultCacheKey();
+      if( this->FindInResultCache( resultCacheKey ) )
+      {
+        // elastix did not run, so there is nothing to log
+        this->m_Log.Clear();
+        this->m_IterationTable.clear();
+        return this->m_ResultImage;
+      }
     }
 
-    for( unsigned int i = 0; i < this->GetNumberOfMovingImages(); ++i )
+    // The best multi-start candidate and its coarse registration initialize the registration. The
+    // user's initial transform is swapped out meanwhile rather than copied.
+    ParameterMapVectorType initialTransformParameterMapVector;
+    if( this->m_MultiStartCandidates.size() > 0 )
     {
-      elastixFilter->AddMovingImage( itkDynamicCastInDebugMode< TMovingImage* >( Cast( this->GetMovingImage( i ), sitkFloat32 ).GetITKBase() ) );
+      ParameterMapVectorType multiStartTransformParameterMapVector = this->ExecuteMultiStart();
+      initialTransformParameterMapVector.swap( this->m_InitialTransformParameterMapVector );
+      this->m_InitialTransformParameterMapVector.swap( multiStartTransformParameterMapVector );
     }
-
-    for( unsigned int i = 0; i < this->GetNumberOfFixedMasks(); ++i )
+    else
     {
-      elastixFilter->AddFixedMask( itkDynamicCastInDebugMode< FixedMaskType* >( this->GetFixedMask( i ).GetITKBase() ) );
+      this->m_MultiStartMetricValues.clear();
     }
 
-    for( unsigned int i = 0; i < this->GetNumberOfMovingMasks(); ++i )
+    Image resultImage;
+    try
     {
-      elastixFilter->AddMovingMask( itkDynamicCastInDebugMode< MovingMaskType* >( this->GetMovingMask( i ).GetITKBase() ) );
+      resultImage = this->m_DualMemberFactory->GetMemberFunction( FixedInternalImagePixelID, MovingInternalImagePixelID, FixedImageDimension )();
     }
+    catch( ... )
+    {
+      if( this->m_MultiStartCandidates.size() > 0 )
+      {
+        this->m_InitialTransformParameterMapVector.swap( initialTransformParameterMapVector );
+      }
 
-    elastixFilter->SetInitialTransformParameterFileName( this->GetInitialTransformParameterFileName() );
-    elastixFilter->SetFixedPointSetFileName( this->GetFixedPointSetFileName() );
-    elastixFilter->SetMovingPointSetFileName( this->GetMovingPointSetFileName() );
-
-    elastixFilter->SetOutputDirectory( this->GetOutputDirectory() );
-    elastixFilter->SetLogFileName( this->GetLogFileName() );
-    elastixFilter->SetLogToFile( this->GetLogToFile() );
-    elastixFilter->SetLogToConsole( this->GetLogToConsole() );
+      throw;
+    }
 
-    ParameterMapVectorType parameterMapVector = this->m_ParameterMapVector;
-    for( unsigned int i = 0; i < parameterMapVector.size(); i++ )
+    if( this->m_MultiStartCandidates.size() > 0 )
     {
-      parameterMapVector[ i ][ "FixedInternalImagePixelType" ] 
-        = ParameterValueVectorType( 1, "float" );
-      parameterMapVector[ i ][ "MovingInternalImagePixelType" ]
-        = ParameterValueVectorType( 1, "float" );
+      this->m_InitialTransformParameterMapVector.swap( initialTransformParameterMapVector );
     }
 
-    ParameterObjectPointer parameterObject = ParameterObjectType::New();
-    parameterObject->SetParameterMap( parameterMapVector );
-    elastixFilter->SetParameterObject( parameterObject );
-    
-    elastixFilter->Update();
+    // Aborted registrations have no transform parameter maps and are not cached
+    if( this->m_UseResultCache && this->m_TransformParameterMapVector.size() > 0 )
+    {
+      this->AddToResultCache( resultCacheKey );
+    }
 
-    this->m_ResultImage = Image( itkDynamicCastInDebugMode< TFixedImage * >( elastixFilter->GetOutput() ) );
-    this->m_ResultImage.MakeUnique();
-    this->m_TransformParameterMapVector = elastixFilter->GetTransformParameterObject()->GetParameterMap();
-  }
-  catch( itk::ExceptionObject &e )
-  {
-    sitkExceptionMacro( << e );
+    return resultImage;
   }
 
-  return this->m_ResultImage;
+  sitkExceptionMacro( << "SimpleElastix does not support the combination of "
+                      << FixedImageDimension << "-dimensional "
+                      << GetPixelIDValueAsElastixParameter( FixedImagePixelID ) << " fixed image and a "
+                      << MovingImageDimension << "-dimensional " 
+                      << GetPixelIDValueAsElastixParameter( MovingImagePixelID ) << " moving image. "
+                      << "This a serious error. Contact developers at https://github.com/kaspermarstal/SimpleElastix/issues." )
 }
 
-const std::string 
+void
 SimpleElastix::SimpleElastixImpl
-::GetName( void )
-{ 
-  const std::string name = "SimpleElastix";
-  return name;
+::SetUseResultCache( const bool useResultCache )
+{
+  this->m_UseResultCache = useResultCache;
 }
 
-void
+bool
 SimpleElastix::SimpleElastixImpl
-::SetFixedImage( const Image& fixedImage )
+::GetUseResultCache( void )
 {
-  if( this->IsEmpty( fixedImage ) )
-  {
-    sitkExceptionMacro( "Image is empty." )
-  }
-
-  this->RemoveFixedImage();
-  this->m_FixedImages.push_back( fixedImage );
+  return this->m_UseResultCache;
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::SetFixedImage( const VectorOfImage& fixedImages )
+::UseResultCacheOn( void )
 {
-  if( fixedImages.size() == 0u )
-  {
-    sitkExceptionMacro( "Cannot set fixed images from empty vector" );
-  }
-
-  this->RemoveFixedImage();
-  this->m_FixedImages = fixedImages;
+  this->SetUseResultCache( true );
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::AddFixedImage( const Image& fixedImage )
+::UseResultCacheOff( void )
 {
-  if( this->IsEmpty( fixedImage ) )
-  {
-    sitkExceptionMacro( "Image is empty." )
-  }
-
-  this->m_FixedImages.push_back( fixedImage );
+  this->SetUseResultCache( false );
 }
 
-Image&
+void
 SimpleElastix::SimpleElastixImpl
-::GetFixedImage( const unsigned long index )
+::SetResultCacheMaximumSize( const uint64_t maximumSize )
 {
-  if( index < this->m_FixedImages.size() )
+  ResultCacheMutex.Lock();
+  ResultCacheMaximumSize = maximumSize;
+  while( ResultCacheSize > ResultCacheMaximumSize )
   {
-    return this->m_FixedImages[ index ];
+    ResultCacheSize -= ResultCache.back().Size;
+    ResultCache.pop_back();
   }
+  ResultCacheMutex.Unlock();
+}
 
-  sitkExceptionMacro( "Index out of range (index: " << index << ", number of fixed images: " << this->m_FixedImages.size() << ")" );
+uint64_t
+SimpleElastix::SimpleElastixImpl
+::GetResultCacheMaximumSize( void )
+{
+  ResultCacheMutex.Lock();
+  const uint64_t value = ResultCacheMaximumSize;
+  ResultCacheMutex.Unlock();
+  return value;
 }
 
-SimpleElastix::SimpleElastixImpl::VectorOfImage&
+uint64_t
 SimpleElastix::SimpleElastixImpl
-::GetFixedImage( void )
+::GetResultCacheSize( void )
 {
-  return this->m_FixedImages;
+  ResultCacheMutex.Lock();
+  const uint64_t value = ResultCacheSize;
+  ResultCacheMutex.Unlock();
+  return value;
 }
 
-void
+uint64_t
 SimpleElastix::SimpleElastixImpl
-::RemoveFixedImage( const unsigned long index )
+::GetResultCacheHits( void )
 {
-  if( index < this->m_FixedImages.size() )
-  {
-    this->m_FixedImages.erase( this->m_FixedImages.begin() + index );
-  }
+  ResultCacheMutex.Lock();
+  const uint64_t value = ResultCacheHits;
+  ResultCacheMutex.Unlock();
+  return value;
+}
 
-  sitkExceptionMacro( "Index out of range (index: " << index << ", number of fixed images: " << this->m_FixedImages.size() << ")" );
+uint64_t
+SimpleElastix::SimpleElastixImpl
+::GetResultCacheMisses( void )
+{
+  ResultCacheMutex.Lock();
+  const uint64_t value = ResultCacheMisses;
+  ResultCacheMutex.Unlock();
+  return value;
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::RemoveFixedImage( void )
+::ClearResultCache( void )
 {
-  this->m_FixedImages.clear();
+  ResultCacheMutex.Lock();
+  ResultCache.clear();
+  ResultCacheSize = 0;
+  ResultCacheMutex.Unlock();
 }
 
-unsigned int
+uint64_t
 SimpleElastix::SimpleElastixImpl
-::GetNumberOfFixedImages( void )
+::GetNumberOfHashedImages( void )
 {
-  return this->m_FixedImages.size();
+  return this->m_NumberOfHashedImages;
 }
 
-void
+std::string
 SimpleElastix::SimpleElastixImpl
-::SetMovingImage( const Image& movingImage )
+::GetImageDigest( const Image& image, ImageDigestMapType& usedImageDigests )
 {
-  if( this->IsEmpty( movingImage ) )
+  // Hashing the pixels dominates the key. An image that is still the same object, with the same
+  // modified time, as when it was last hashed by this object is not hashed again.
+  const CachedImageKeyType imageKey = GetCachedImageKey( image );
+  ImageDigestMapType::const_iterator it = this->m_ImageDigests.find( imageKey );
+  std::string digest;
+  if( it != this->m_ImageDigests.end() )
   {
-    sitkExceptionMacro( "Image is empty." )
+    digest = it->second;
+  }
+  else
+  {
+    digest = Hash( image );
+    ++this->m_NumberOfHashedImages;
   }
 
-  this->RemoveMovingImage();
-  this->m_MovingImages.push_back( movingImage );
+  usedImageDigests[ imageKey ] = digest;
+  return digest;
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::SetMovingImage( const VectorOfImage& movingImages )
+::DescribeImage( std::ostream& description, const Image& image, const std::string& digest )
 {
-  if( movingImages.size() == 0u )
+  // The hash covers the pixel buffer only, so the geometry is described as well
+  description << digest << " " << image.GetPixelID() << " " << image.GetNumberOfComponentsPerPixel();
+  const std::vector< unsigned int > size = image.GetSize();
+  const std::vector< double > origin = image.GetOrigin();
+  const std::vector< double > spacing = image.GetSpacing();
+  const std::vector< double > direction = image.GetDirection();
+  for( unsigned int i = 0; i < size.size(); ++i )
   {
-    sitkExceptionMacro( "Cannot set moving images from empty vector" );
+    description << " " << size[ i ] << " " << origin[ i ] << " " << spacing[ i ];
   }
 
-  this->RemoveMovingImage();
-  this->m_MovingImages = movingImages;
+  for( unsigned int i = 0; i < direction.size(); ++i )
+  {
+    description << " " << direction[ i ];
+  }
+
+  description << "\n";
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::AddMovingImage( const Image& movingImage )
+::DescribeParameterMaps( std::ostream& description, const ParameterMapVectorType& parameterMapVector )
 {
-  if( this->IsEmpty( movingImage ) )
+  // Keys of a map are sorted, and lengths are written so that no two different maps read the same
+  description << parameterMapVector.size() << "\n";
+  for( unsigned int i = 0; i < parameterMapVector.size(); ++i )
   {
-    sitkExceptionMacro( "Image is empty." )
+    description << parameterMapVector[ i ].size() << "\n";
+    for( ParameterMapConstIterator it = parameterMapVector[ i ].begin(); it != parameterMapVector[ i ].end(); ++it )
+    {
+      description << it->first.size() << ":" << it->first << " " << it->second.size();
+      for( unsigned int j = 0; j < it->second.size(); ++j )
+      {
+        description << " " << it->second[ j ].size() << ":" << it->second[ j ];
+      }
+      description << "\n";
+    }
   }
-
-  this->m_MovingImages.push_back( movingImage );
 }
 
-Image&
+std::string
 SimpleElastix::SimpleElastixImpl
-::GetMovingImage( const unsigned long index )
+::GetResultCacheKey( void )
 {
-  if( index < this->m_MovingImages.size() )
+  std::ostringstream description;
+  description.precision( 17 );
+
+  ImageDigestMapType usedImageDigests;
+  const VectorOfImage* images[] = { &this->m_FixedImages, &this->m_MovingImages, &this->m_FixedMasks, &this->m_MovingMasks };
+  for( unsigned int i = 0; i < 4; ++i )
   {
-    return this->m_MovingImages[ index ];
+    description << images[ i ]->size() << "\n";
+    for( unsigned int j = 0; j < images[ i ]->size(); ++j )
+    {
+      const Image& image = ( *images[ i ] )[ j ];
+      this->DescribeImage( description, image, this->GetImageDigest( image, usedImageDigests ) );
+    }
   }
-  
-  sitkExceptionMacro( "Index out of range (index: " << index << ", number of moving images: " << this->m_MovingImages.size() << ")" );
-}
 
-SimpleElastix::SimpleElastixImpl::VectorOfImage&
-SimpleElastix::SimpleElastixImpl
-::GetMovingImage( void )
-{
-  return this->m_MovingImages;
-}
+  // Digests of images that are no longer inputs are dropped
+  this->m_ImageDigests.swap( usedImageDigests );
 
-void
-SimpleElastix::SimpleElastixImpl
-::RemoveMovingImage( const unsigned long index )
-{
-  if( index < this->m_MovingImages.size() )
+  description << this->m_HasFixedMaskLabel << " " << this->m_FixedMaskLabel << " "
+              << this->m_HasMovingMaskLabel << " " << this->m_MovingMaskLabel << "\n";
+
+  const PointSetType* pointSets[] = { &this->m_FixedPointSet, &this->m_MovingPointSet };
+  for( unsigned int i = 0; i < 2; ++i )
   {
-    this->m_MovingImages.erase( this->m_MovingImages.begin() + index );
+    description << pointSets[ i ]->size() << "\n";
+    for( unsigned int j = 0; j < pointSets[ i ]->size(); ++j )
+    {
+      for( unsigned int k = 0; k < ( *pointSets[ i ] )[ j ].size(); ++k )
+      {
+        description << ( *pointSets[ i ] )[ j ][ k ] << " ";
+      }
+      description << "\n";
+    }
   }
 
-  sitkExceptionMacro( "Index out of range (index: " << index << ", number of moving images: " << this->m_MovingImages.size() << ")" );
-}
+  // Files are described by their content
+  const std::string fileNames[] = { this->m_FixedPointSetFileName, this->m_MovingPointSetFileName, this->m_InitialTransformParameterMapFileName };
+  for( unsigned int i = 0; i < 3; ++i )
+  {
+    std::ifstream file( fileNames[ i ].c_str(), std::ifstream::in | std::ifstream::binary );
+    const std::string content = fileNames[ i ].empty() ? std::string() : std::string( std::istreambuf_iterator< char >( file ), std::istreambuf_iterator< char >() );
+    description << fileNames[ i ].size() << ":" << fileNames[ i ] << " " << content.size() << ":" << content << "\n";
+  }
 
-void
-SimpleElastix::SimpleElastixImpl
-::RemoveMovingImage( void )
-{
-  this->m_MovingImages.clear();
-}
+  this->DescribeParameterMaps( description, this->m_InitialTransformParameterMapVector );
+  this->DescribeParameterMaps( description, this->m_ParameterMapVector );
 
-unsigned int
-SimpleElastix::SimpleElastixImpl
-::GetNumberOfMovingImages( void )
-{
-  return this->m_MovingImages.size();
-}
+  description << this->m_MultiStartCandidates.size() << "\n";
+  for( unsigned int i = 0; i < this->m_MultiStartCandidates.size(); ++i )
+  {
+    for( unsigned int j = 0; j < this->m_MultiStartCandidates[ i ].size(); ++j )
+    {
+      description << this->m_MultiStartCandidates[ i ][ j ] << " ";
+    }
+    description << "\n";
+  }
 
-void
-SimpleElastix::SimpleElastixImpl
-::SetFixedMask( const Image& fixedMask )
-{
-  if( this->IsEmpty( fixedMask ) )
+  const std::string content = description.str();
+  ::SHA1 sha1;
+  ::HL_SHA1_CTX sha1Context;
+  unsigned char digest[ SHA1HashSize ];
+  sha1.SHA1Reset( &sha1Context );
+  sha1.SHA1Input( &sha1Context, reinterpret_cast< const unsigned char* >( content.data() ), content.size() );
+  sha1.SHA1Result( &sha1Context, digest );
+
+  std::ostringstream key;
+  key << std::hex << std::setfill( '0' );
+  for( unsigned int i = 0; i < SHA1HashSize; ++i )
   {
-    sitkExceptionMacro( "Image is empty." )
+    key << std::setw( 2 ) << static_cast< unsigned int >( digest[ i ] );
   }
 
-  this->RemoveFixedMask();
-  this->m_FixedMasks.push_back( fixedMask );
+  return key.str();
 }
 
-void
+bool
 SimpleElastix::SimpleElastixImpl
-::SetFixedMask( const VectorOfImage& fixedMasks )
+::FindInResultCache( const std::string& key )
 {
-  if( fixedMasks.size() == 0u )
+  ResultCacheMutex.Lock();
+  for( std::list< ResultCacheEntry >::iterator it = ResultCache.begin(); it != ResultCache.end(); ++it )
   {
-    sitkExceptionMacro( "Cannot set fixed images from empty vector" );
+    // An entry without result image only serves transform-only registrations
+    if( it->Key == key && ( !this->m_ComputeResultImage || !this->IsEmpty( it->ResultImage ) ) )
+    {
+      ResultCache.splice( ResultCache.begin(), ResultCache, it );
+      this->m_TransformParameterMapVector = ResultCache.front().TransformParameterMapVector;
+      this->m_ResultImage = this->m_ComputeResultImage ? ResultCache.front().ResultImage : Image();
+      this->m_MultiStartMetricValues = ResultCache.front().MultiStartMetricValues;
+      this->m_BestMultiStartCandidate = ResultCache.front().BestMultiStartCandidate;
+      ++ResultCacheHits;
+      ResultCacheMutex.Unlock();
+      return true;
+    }
   }
 
-  this->RemoveFixedMask();
-  this->m_FixedMasks = fixedMasks;
+  ++ResultCacheMisses;
+  ResultCacheMutex.Unlock();
+  return false;
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::AddFixedMask( const Image& fixedMask )
-{
-  if( this->IsEmpty( fixedMask ) )
+::AddToResultCache( const std::string& key )
+{
+  // The entry is filled in a list of its own and spliced into the cache, so the maps are copied once
+  std::list< ResultCacheEntry > entries( 1 );
+  ResultCacheEntry& entry = entries.front();
+  entry.Key = key;
+  entry.TransformParameterMapVector = this->m_TransformParameterMapVector;
+  entry.ResultImage = this->m_ResultImage;
+  entry.MultiStartMetricValues = this->m_MultiStartMetricValues;
+  entry.BestMultiStartCandidate = this->m_BestMultiStartCandidate;
+  entry.Size = key.size() + entry.MultiStartMetricValues.size() * sizeof( double );
+  for( unsigned int i = 0; i < entry.TransformParameterMapVector.size(); ++i )
   {
-    sitkExceptionMacro( "Image is empty." )
+    for( ParameterMapConstIterator it = entry.TransformParameterMapVector[ i ].begin(); it != entry.TransformParameterMapVector[ i ].end(); ++it )
+    {
+      entry.Size += it->first.size();
+      for( unsigned int j = 0; j < it->second.size(); ++j )
+      {
+        entry.Size += it->second[ j ].size();
+      }
+    }
   }
 
-  this->m_FixedMasks.push_back( fixedMask );
-}
+  if( !this->IsEmpty( entry.ResultImage ) )
+  {
+    uint64_t numberOfPixels = 1;
+    for( unsigned int i = 0; i < entry.ResultImage.GetDimension(); ++i )
+    {
+      numberOfPixels *= entry.ResultImage.GetSize()[ i ];
+    }
 
-Image&
-SimpleElastix::SimpleElastixImpl
-::GetFixedMask( const unsigned long index )
-{
-  if( index < this->m_FixedMasks.size() )
+    entry.Size += numberOfPixels * entry.ResultImage.GetNumberOfComponentsPerPixel() * GetSizeOfPixelComponent( entry.ResultImage );
+  }
+
+  ResultCacheMutex.Lock();
+  for( std::list< ResultCacheEntry >::iterator it = ResultCache.begin(); it != ResultCache.end(); ++it )
   {
-    return this->m_FixedMasks[ index ];
+    if( it->Key == key )
+    {
+      ResultCacheSize -= it->Size;
+      ResultCache.erase( it );
+      break;
+    }
   }
 
-  sitkExceptionMacro( "Index out of range (index: " << index << ", number of fixed masks: " << this->m_FixedMasks.size() << ")" );
+  if( entry.Size <= ResultCacheMaximumSize )
+  {
+    ResultCacheSize += entry.Size;
+    ResultCache.splice( ResultCache.begin(), entries );
+    while( ResultCacheSize > ResultCacheMaximumSize )
+    {
+      ResultCacheSize -= ResultCache.back().Size;
+      ResultCache.pop_back();
+    }
+  }
+  ResultCacheMutex.Unlock();
 }
 
-SimpleElastix::VectorOfImage&
+PixelIDValueEnum
 SimpleElastix::SimpleElastixImpl
-::GetFixedMask( void )
+::GetInternalImagePixelID( const ParameterKeyType key, const unsigned int dimension )
 {
-  return this->m_FixedMasks;
-}
+  // Images are registered as float unless the parameter maps ask for another internal pixel type.
+  // elastix runs all parameter maps with the same images, so the maps that set it must agree.
+  ParameterValueType internalPixelType;
+  for( unsigned int i = 0; i < this->m_ParameterMapVector.size(); ++i )
+  {
+    ParameterMapConstIterator it = this->m_ParameterMapVector[ i ].find( key );
+    if( it == this->m_ParameterMapVector[ i ].end() || it->second.size() == 0 )
+    {
+      continue;
+    }
+
+    if( !internalPixelType.empty() && it->second[ 0 ] != internalPixelType )
+    {
+      sitkExceptionMacro( "Parameter maps ask for different " << key << " (\"" << internalPixelType << "\" and \"" << it->second[ 0 ] << "\")." );
+    }
+
+    internalPixelType = it->second[ 0 ];
+  }
+
+  if( internalPixelType.empty() )
+  {
+    return sitkFloat32;
+  }
+
+  const PixelIDValueType pixelID = GetPixelIDValueFromElastixString( internalPixelType );
+  if( !this->m_DualMemberFactory->HasMemberFunction( pixelID, pixelID, dimension ) )
+  {
+    sitkExceptionMacro( "Unsupported " << key << " \"" << internalPixelType << "\" for images of dimension " << dimension << ". "
+                     << "Choose \"float\", or for 2D and 3D images \"short\", \"unsigned short\" or \"unsigned char\"." );
+  }
+
+  return static_cast< PixelIDValueEnum >( pixelID );
+}
+
+std::vector< std::string >
+SimpleElastix::SimpleElastixImpl
+::LinkTransformParameterChain( ParameterMapVectorType& transformParameterMapVector, const std::string& directory )
+{
+  // Each transform is initialized by the one before it, as written to TransformParameters.<i>.txt
+  // in the directory, or in the working directory when the directory is empty
+  std::vector< std::string > transformParameterFileNames;
+  for( unsigned int i = 0; i < transformParameterMapVector.size(); ++i )
+  {
+    transformParameterFileNames.push_back( ( directory.empty() ? std::string() : directory + "/" ) + "TransformParameters." + ParameterObjectType::ToString( i ) + ".txt" );
+    transformParameterMapVector[ i ][ "InitialTransformParametersFileName" ]
+      = ParameterValueVectorType( 1, i == 0 ? std::string( "NoInitialTransform" ) : transformParameterFileNames[ i - 1 ] );
+  }
+
+  return transformParameterFileNames;
+}
+
+std::string
+SimpleElastix::SimpleElastixImpl
+::WriteTransformParameterChain( const ParameterMapVectorType& transformParameterMapVector, const std::string& directory )
+{
+  // elastix follows the chain backwards from the file of the last transform, which is returned
+  ParameterMapVectorType transformParameterMaps = transformParameterMapVector;
+  const std::vector< std::string > transformParameterFileNames = LinkTransformParameterChain( transformParameterMaps, directory );
+
+  ParameterObjectPointer transformParameterObject = ParameterObjectType::New();
+  transformParameterObject->SetParameterMap( transformParameterMaps );
+  transformParameterObject->WriteParameterFile( transformParameterFileNames );
+
+  return transformParameterFileNames.back();
+}
+
+Image
+SimpleElastix::SimpleElastixImpl
+::CastToInternalImage( const Image& image, const PixelIDValueEnum internalPixelID )
+{
+  // Images that already have the internal pixel type are passed to elastix without a copy
+  if( image.GetPixelID() == internalPixelID )
+  {
+    return image;
+  }
+
+  return Cast( image, internalPixelID );
+}
+
+Image
+SimpleElastix::SimpleElastixImpl
+::CastToInternalMask( const Image& mask, const bool hasLabel, const int64_t label )
+{
+  // Unsigned char masks without a label selector are passed to elastix without a copy
+  if( mask.GetPixelID() == sitkUInt8 && !hasLabel )
+  {
+    return mask;
+  }
+
+  const Image labelImage = IsLabelMapPixelID( mask.GetPixelID() ) ? LabelMapToLabel( mask ) : mask;
+
+  // One pass over the mask: voxels with the selected label, or any non-zero voxel, become 1
+  if( hasLabel )
+  {
+    // The threshold is a double, which holds integers up to 2^53 exactly
+    const int64_t maximumExactLabel = static_cast< int64_t >( 1 ) << 53;
+    if( label > maximumExactLabel || label < -maximumExactLabel )
+    {
+      sitkExceptionMacro( "Mask label " << label << " is out of range. Labels must be within +/-2^53." );
+    }
+
+    int64_t minimumLabel = -maximumExactLabel;
+    int64_t maximumLabel = maximumExactLabel;
+    switch( labelImage.GetPixelID() )
+    {
+      case sitkUInt8: minimumLabel = 0; maximumLabel = std::numeric_limits< uint8_t >::max(); break;
+      case sitkInt8: minimumLabel = std::numeric_limits< int8_t >::min(); maximumLabel = std::numeric_limits< int8_t >::max(); break;
+      case sitkUInt16: minimumLabel = 0; maximumLabel = std::numeric_limits< uint16_t >::max(); break;
+      case sitkInt16: minimumLabel = std::numeric_limits< int16_t >::min(); maximumLabel = std::numeric_limits< int16_t >::max(); break;
+      case sitkUInt32: minimumLabel = 0; maximumLabel = std::numeric_limits< uint32_t >::max(); break;
+      case sitkInt32: minimumLabel = std::numeric_limits< int32_t >::min(); maximumLabel = std::numeric_limits< int32_t >::max(); break;
+      case sitkUInt64: minimumLabel = 0; break;
+      default: break;
+    }
+
+    if( label < minimumLabel || label > maximumLabel )
+    {
+      sitkExceptionMacro( "Mask label " << label << " is out of range for masks of pixel type " << GetPixelIDValueAsString( labelImage.GetPixelID() ) << " ([" << minimumLabel << ", " << maximumLabel << "])." );
+    }
+
+    return BinaryThreshold( labelImage, static_cast< double >( label ), static_cast< double >( label ), 1u, 0u );
+  }
+
+  return BinaryThreshold( labelImage, 0.0, 0.0, 0u, 1u );
+}
+
+template< typename TFixedImage, typename TMovingImage >
+Image
+SimpleElastix::SimpleElastixImpl
+::DualExecuteInternal( void )
+{
+  typedef elastix::ElastixFilter< TFixedImage, TMovingImage >   ElastixFilterType;
+  typedef typename ElastixFilterType::Pointer                   ElastixFilterPointer;
+  typedef typename ElastixFilterType::FixedMaskType             FixedMaskType;
+  typedef typename ElastixFilterType::MovingMaskType            MovingMaskType;
+
+  const PixelIDValueEnum FixedInternalImagePixelID = static_cast< PixelIDValueEnum >( ImageTypeToPixelIDValue< TFixedImage >::Result );
+  const PixelIDValueEnum MovingInternalImagePixelID = static_cast< PixelIDValueEnum >( ImageTypeToPixelIDValue< TMovingImage >::Result );
+
+  try
+  {
+    ElastixFilterPointer elastixFilter = ElastixFilterType::New();
+
+    // Images are accessed through the const interface so that shared buffers are not made unique. The
+    // filter holds smart pointers to the images, so casted copies stay alive until registration is done.
+    for( unsigned int i = 0; i < this->GetNumberOfFixedImages(); ++i )
+    {
+      const Image fixedImage = this->GetInternalFixedImage( i, FixedInternalImagePixelID );
+      elastixFilter->AddFixedImage( ShareImageBuffer( itkDynamicCastInDebugMode< const TFixedImage* >( fixedImage.GetITKBase() ) ) );
+    }
+
+    for( unsigned int i = 0; i < this->GetNumberOfMovingImages(); ++i )
+    {
+      const Image movingImage = this->CastToInternalImage( this->m_MovingImages[ i ], MovingInternalImagePixelID );
+      elastixFilter->AddMovingImage( ShareImageBuffer( itkDynamicCastInDebugMode< const TMovingImage* >( movingImage.GetITKBase() ) ) );
+    }
+
+    for( unsigned int i = 0; i < this->GetNumberOfFixedMasks(); ++i )
+    {
+      const Image fixedMask = this->GetInternalFixedMask( i );
+      elastixFilter->AddFixedMask( ShareImageBuffer( itkDynamicCastInDebugMode< const FixedMaskType* >( fixedMask.GetITKBase() ) ) );
+    }
+
+    for( unsigned int i = 0; i < this->GetNumberOfMovingMasks(); ++i )
+    {
+      const Image movingMask = this->CastToInternalMask( this->m_MovingMasks[ i ], this->m_HasMovingMaskLabel, this->m_MovingMaskLabel );
+      elastixFilter->AddMovingMask( ShareImageBuffer( itkDynamicCastInDebugMode< const MovingMaskType* >( movingMask.GetITKBase() ) ) );
+    }
+
+    elastixFilter->SetInitialTransformParameterFileName( this->GetInitialTransformParameterFileName() );
+    elastixFilter->SetFixedPointSetFileName( this->GetFixedPointSetFileName() );
+    elastixFilter->SetMovingPointSetFileName( this->GetMovingPointSetFileName() );
+
+    // In-memory point sets and initial transforms are passed as files
+    nsstd::auto_ptr< ElastixScratchDirectory > scratchDirectory;
+    if( this->m_FixedPointSet.size() > 0 || this->m_MovingPointSet.size() > 0 || this->m_InitialTransformParameterMapVector.size() > 0 )
+    {
+      scratchDirectory.reset( new ElastixScratchDirectory() );
+    }
+
+    if( this->m_InitialTransformParameterMapVector.size() > 0 )
+    {
+      elastixFilter->SetInitialTransformParameterFileName( this->WriteTransformParameterChain( this->m_InitialTransformParameterMapVector, scratchDirectory->GetPath() ) );
+    }
+
+    if( this->m_FixedPointSet.size() > 0 )
+    {
+      WriteElastixPointSetFile( this->m_FixedPointSet, scratchDirectory->GetFile( "fixedPointSet.pts" ) );
+      elastixFilter->SetFixedPointSetFileName( scratchDirectory->GetFile( "fixedPointSet.pts" ) );
+    }
+
+    if( this->m_MovingPointSet.size() > 0 )
+    {
+      WriteElastixPointSetFile( this->m_MovingPointSet, scratchDirectory->GetFile( "movingPointSet.pts" ) );
+      elastixFilter->SetMovingPointSetFileName( scratchDirectory->GetFile( "movingPointSet.pts" ) );
+    }
+
+    elastixFilter->SetOutputDirectory( this->GetOutputDirectory() );
+    elastixFilter->SetLogFileName( this->GetLogFileName() );
+    elastixFilter->SetLogToFile( this->GetLogToFile() );
+    elastixFilter->SetLogToConsole( this->GetLogToConsole() );
+
+    // elastix must be instantiated with the pixel type of the images it receives. This is float, or
+    // the type that the caller asked for in the parameter maps.
+    ParameterMapVectorType parameterMapVector = this->m_ParameterMapVector;
+    for( unsigned int i = 0; i < parameterMapVector.size(); i++ )
+    {
+      parameterMapVector[ i ][ "FixedInternalImagePixelType" ] 
+        = ParameterValueVectorType( 1, GetPixelIDValueAsElastixParameter( FixedInternalImagePixelID ) );
+      parameterMapVector[ i ][ "MovingInternalImagePixelType" ]
+        = ParameterValueVectorType( 1, GetPixelIDValueAsElastixParameter( MovingInternalImagePixelID ) );
+
+      if( !this->m_ComputeResultImage )
+      {
+        parameterMapVector[ i ][ "WriteResultImage" ] = ParameterValueVectorType( 1, "false" );
+      }
+    }
+
+    ParameterObjectPointer parameterObject = ParameterObjectType::New();
+    parameterObject->SetParameterMap( parameterMapVector );
+    elastixFilter->SetParameterObject( parameterObject );
+
+    // The elastix at our pin has no observer or abort hooks. Observers of iteration and progress
+    // events therefore follow the registration through the log of elastix (see OnElastixLogLine()),
+    // as do registrations without an owner, which RequestAbort() stops. Otherwise the in-memory
+    // log is read back from the log file of this run.
+    nsstd::auto_ptr< ElastixLogTarget > logTarget;
+    nsstd::auto_ptr< ElastixLogFile > memoryLogFile;
+    const bool followLog = this->HasLogObservers() || !this->m_ProcessObject;
+    if( this->m_LogToMemory && !followLog )
+    {
+      memoryLogFile.reset( new ElastixLogFile( this->GetOutputDirectory(), this->GetLogToFile(), this->GetLogFileName(), "elastix.log" ) );
+      elastixFilter->SetOutputDirectory( memoryLogFile->GetOutputDirectory() );
+      elastixFilter->SetLogFileName( memoryLogFile->GetLogFileName() );
+      elastixFilter->SetLogToFile( true );
+    }
+
+    this->m_Log.Clear();
+    this->m_IterationTable.clear();
+    this->m_Aborted = false;
+    this->m_CurrentParameterMap = 0;
+    this->m_CurrentLevel = 0;
+    this->m_OptimizerIteration = 0;
+    this->m_MetricValue = 0.0;
+    this->m_ExactMetricValue = std::numeric_limits< double >::quiet_NaN();
+    this->m_HasStartedResolution = false;
+    this->m_IsInIterationTable = false;
+    elastixFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
+
+    if( this->m_ProcessObject )
+    {
+      this->m_MaximumNumberOfIterations.clear();
+      for( unsigned int i = 0; i < parameterMapVector.size(); ++i )
+      {
+        const ParameterMapType& parameterMap = parameterMapVector[ i ];
+        ParameterMapConstIterator numberOfResolutionsIterator = parameterMap.find( "NumberOfResolutions" );
+        ParameterMapConstIterator maximumNumberOfIterationsIterator = parameterMap.find( "MaximumNumberOfIterations" );
+        const ParameterValueVectorType numberOfResolutions = numberOfResolutionsIterator != parameterMap.end() ? numberOfResolutionsIterator->second : ParameterValueVectorType();
+        const ParameterValueVectorType maximumNumberOfIterations = maximumNumberOfIterationsIterator != parameterMap.end() ? maximumNumberOfIterationsIterator->second : ParameterValueVectorType();
+        this->m_MaximumNumberOfIterations.push_back( std::vector< unsigned int >( numberOfResolutions.size() > 0 ? std::atoi( numberOfResolutions[ 0 ].c_str() ) : 3, 500 ) );
+        for( unsigned int j = 0; j < this->m_MaximumNumberOfIterations[ i ].size() && maximumNumberOfIterations.size() > 0; ++j )
+        {
+          this->m_MaximumNumberOfIterations[ i ][ j ] = std::atoi( maximumNumberOfIterations[ std::min< size_t >( j, maximumNumberOfIterations.size() - 1 ) ].c_str() );
+        }
+      }
+
+      this->m_ProcessObject->PreUpdate( elastixFilter.GetPointer() );
+    }
+
+    // Registrations in other threads wait here until elastix is done (see ElastixProcessLock)
+    ElastixProcessLock processLock;
+
+    // A job that was cancelled while it waited does not start
+    if( this->IsAbortRequested() )
+    {
+      this->m_Aborted = true;
+      this->m_ResultImage = Image();
+      this->m_TransformParameterMapVector = ParameterMapVectorType();
+      return this->m_ResultImage;
+    }
+
+    if( followLog )
+    {
+      this->m_ActiveElastixFilter = elastixFilter.GetPointer();
+      logTarget.reset( new ElastixLogTarget( this ) );
+    }
+
+    // An abort unwinds elastix from the iteration it logged last. The exception may reach us as it
+    // was thrown, or replaced by the error that elastix raises while it propagates.
+    try
+    {
+      elastixFilter->Update();
+    }
+    catch( ProcessAborted & )
+    {
+      this->m_ActiveElastixFilter = NULL;
+      if( !this->m_Aborted )
+      {
+        throw;
+      }
+    }
+    catch( ... )
+    {
+      this->m_ActiveElastixFilter = NULL;
+      if( !this->m_Aborted )
+      {
+        throw;
+      }
+
+      // The filter reports AbortEvent itself only when it sees the ProcessAborted exception
+      elastixFilter->InvokeEvent( itk::AbortEvent() );
+    }
+
+    this->m_ActiveElastixFilter = NULL;
+    logTarget.reset();
+
+    if( memoryLogFile.get() )
+    {
+      memoryLogFile->Replay( this );
+    }
+
+    // An aborted registration has no result
+    if( this->m_Aborted )
+    {
+      this->m_ResultImage = Image();
+      this->m_TransformParameterMapVector = ParameterMapVectorType();
+      return this->m_ResultImage;
+    }
+
+    this->m_TransformParameterMapVector = elastixFilter->GetTransformParameterObject()->GetParameterMap();
+
+    if( !this->m_ComputeResultImage )
+    {
+      // Hand back the user's setting so that transformix still writes images with these maps
+      for( unsigned int i = 0; i < this->m_TransformParameterMapVector.size() && i < this->m_ParameterMapVector.size(); ++i )
+      {
+        ParameterMapConstIterator writeResultImage = this->m_ParameterMapVector[ i ].find( "WriteResultImage" );
+        if( writeResultImage != this->m_ParameterMapVector[ i ].end() )
+        {
+          this->m_TransformParameterMapVector[ i ][ "WriteResultImage" ] = writeResultImage->second;
+        }
+        else
+        {
+          this->m_TransformParameterMapVector[ i ].erase( "WriteResultImage" );
+        }
+      }
+    }
+
+    // The maps refer to the initial transform in the scratch directory, which is removed on return.
+    // The result begins with the initial transform instead, so that it stands on its own.
+    if( this->m_InitialTransformParameterMapVector.size() > 0 )
+    {
+      const size_t numberOfInitialTransforms = this->m_InitialTransformParameterMapVector.size();
+      ParameterMapVectorType transformParameterMapVector = this->m_InitialTransformParameterMapVector;
+      transformParameterMapVector.resize( numberOfInitialTransforms + this->m_TransformParameterMapVector.size() );
+      for( unsigned int i = 0; i < this->m_TransformParameterMapVector.size(); ++i )
+      {
+        transformParameterMapVector[ numberOfInitialTransforms + i ].swap( this->m_TransformParameterMapVector[ i ] );
+      }
+
+      LinkTransformParameterChain( transformParameterMapVector, "" );
+      this->m_TransformParameterMapVector.swap( transformParameterMapVector );
+    }
+
+    if( !this->m_ComputeResultImage )
+    {
+      this->m_ResultImage = Image();
+      return this->m_ResultImage;
+    }
+
+    // Take ownership of the output instead of copying it. Disconnecting replaces the output of the
+    // filter with a new, empty image, so this image is no longer referenced by the pipeline.
+    typename TFixedImage::Pointer resultImage = itkDynamicCastInDebugMode< TFixedImage * >( elastixFilter->GetOutput() );
+    resultImage->DisconnectPipeline();
+    this->m_ResultImage = Image( resultImage );
+  }
+  catch( itk::ExceptionObject &e )
+  {
+    sitkExceptionMacro( << e );
+  }
+
+  return this->m_ResultImage;
+}
+
+unsigned int
+SimpleElastix::SimpleElastixImpl
+::GetCurrentLevel( void )
+{
+  return this->m_CurrentLevel;
+}
+
+unsigned int
+SimpleElastix::SimpleElastixImpl
+::GetOptimizerIteration( void )
+{
+  return this->m_OptimizerIteration;
+}
+
+double
+SimpleElastix::SimpleElastixImpl
+::GetMetricValue( void )
+{
+  return this->m_MetricValue;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::OnElastixLogLine( const std::string& line )
+{
+  // Lines come from the log target while elastix runs and observers follow it, or from the log
+  // file when elastix is done. Events are only sent and aborts only honoured while it runs.
+  if( this->m_Aborted )
+  {
+    return;
+  }
+
+  const bool isRunning = this->m_ActiveElastixFilter != NULL;
+  if( this->m_LogToMemory )
+  {
+    this->m_Log.AddLine( line );
+  }
+
+  // elastix announces each resolution with "Resolution: <level>" and logs the optimizer in a tab
+  // separated table whose header starts with "1:ItNr". Resolutions restart at 0 for every parameter map.
+  const std::string resolutionKey = "Resolution: ";
+  if( line.compare( 0, resolutionKey.size(), resolutionKey ) == 0 )
+  {
+    const unsigned int level = std::atoi( line.c_str() + resolutionKey.size() );
+    if( this->m_HasStartedResolution && level <= this->m_CurrentLevel )
+    {
+      ++this->m_CurrentParameterMap;
+    }
+
+    this->m_HasStartedResolution = true;
+    this->m_IsInIterationTable = false;
+    this->m_CurrentLevel = level;
+    this->m_OptimizerIteration = 0;
+    if( this->m_ProcessObject && isRunning )
+    {
+      this->m_ActiveElastixFilter->InvokeEvent( itk::MultiResolutionIterationEvent() );
+    }
+  }
+  else if( line.compare( 0, 6, "1:ItNr" ) == 0 )
+  {
+    this->m_IsInIterationTable = true;
+    this->m_MetricColumn = 1;
+    this->m_StepSizeColumn = -1;
+    this->m_ExactMetricColumn = -1;
+    std::istringstream columns( line );
+    std::string column;
+    for( unsigned int i = 0; std::getline( columns, column, '\t' ); ++i )
+    {
+      if( column.find( ":Metric" ) != std::string::npos )
+      {
+        this->m_MetricColumn = i;
+      }
+      else if( column.find( "ExactMetric" ) != std::string::npos )
+      {
+        this->m_ExactMetricColumn = static_cast< int >( i );
+      }
+      else if( column.find( ":StepSize" ) != std::string::npos )
+      {
+        this->m_StepSizeColumn = static_cast< int >( i );
+      }
+    }
+  }
+  else if( this->m_IsInIterationTable )
+  {
+    std::vector< std::string > fields;
+    std::istringstream row( line );
+    std::string field;
+    while( std::getline( row, field, '\t' ) )
+    {
+      fields.push_back( field );
+    }
+
+    char* end = NULL;
+    const long iteration = fields.size() > this->m_MetricColumn ? std::strtol( fields[ 0 ].c_str(), &end, 10 ) : 0;
+    if( end == NULL || end == fields[ 0 ].c_str() || *end != '\0' )
+    {
+      this->m_IsInIterationTable = false;
+    }
+    else
+    {
+      this->m_OptimizerIteration = static_cast< unsigned int >( iteration );
+      this->m_MetricValue = std::atof( fields[ this->m_MetricColumn ].c_str() );
+      this->m_ExactMetricValue = this->m_ExactMetricColumn >= 0 && fields.size() > static_cast< size_t >( this->m_ExactMetricColumn )
+                               ? std::atof( fields[ this->m_ExactMetricColumn ].c_str() )
+                               : std::numeric_limits< double >::quiet_NaN();
+
+      if( this->m_LogToMemory )
+      {
+        std::vector< double > row( 5 );
+        row[ 0 ] = this->m_CurrentParameterMap;
+        row[ 1 ] = this->m_CurrentLevel;
+        row[ 2 ] = this->m_OptimizerIteration;
+        row[ 3 ] = this->m_MetricValue;
+        row[ 4 ] = this->m_StepSizeColumn >= 0 && fields.size() > static_cast< size_t >( this->m_StepSizeColumn )
+                 ? std::atof( fields[ this->m_StepSizeColumn ].c_str() )
+                 : std::numeric_limits< double >::quiet_NaN();
+        this->m_IterationTable.push_back( row );
+      }
+
+      if( this->m_ProcessObject && isRunning )
+      {
+        this->m_ActiveElastixFilter->UpdateProgress( this->GetRegistrationProgress() );
+        this->m_ActiveElastixFilter->InvokeEvent( itk::IterationEvent() );
+      }
+
+      // Abort() sets the flag on the active filter and RequestAbort() the flag of this object,
+      // which are polled once per iteration. elastix cannot be told to stop, so the optimizer is
+      // unwound from the row it just logged.
+      if( isRunning && ( this->m_ActiveElastixFilter->GetAbortGenerateData() || this->IsAbortRequested() ) )
+      {
+        this->m_Aborted = true;
+        ProcessAborted e( __FILE__, __LINE__ );
+        e.SetDescription( "Registration aborted." );
+        throw e;
+      }
+    }
+  }
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::RequestAbort( void )
+{
+  this->m_AbortRequestedMutex.Lock();
+  this->m_AbortRequested = true;
+  this->m_AbortRequestedMutex.Unlock();
+}
+
+bool
+SimpleElastix::SimpleElastixImpl
+::IsAbortRequested( void )
+{
+  this->m_AbortRequestedMutex.Lock();
+  const bool abortRequested = this->m_AbortRequested;
+  this->m_AbortRequestedMutex.Unlock();
+  return abortRequested;
+}
+
+bool
+SimpleElastix::SimpleElastixImpl
+::HasLogObservers( void )
+{
+  // Start, end and abort events are sent by the filter itself
+  return this->m_ProcessObject
+      && ( this->m_ProcessObject->HasCommand( sitkAnyEvent )
+        || this->m_ProcessObject->HasCommand( sitkIterationEvent )
+        || this->m_ProcessObject->HasCommand( sitkMultiResolutionIterationEvent )
+        || this->m_ProcessObject->HasCommand( sitkProgressEvent ) );
+}
+
+float
+SimpleElastix::SimpleElastixImpl
+::GetRegistrationProgress( void )
+{
+  // Fraction of the maximum number of iterations over all parameter maps and resolutions
+  unsigned int totalNumberOfIterations = 0;
+  unsigned int numberOfIterationsDone = 0;
+  for( unsigned int i = 0; i < this->m_MaximumNumberOfIterations.size(); ++i )
+  {
+    for( unsigned int j = 0; j < this->m_MaximumNumberOfIterations[ i ].size(); ++j )
+    {
+      totalNumberOfIterations += this->m_MaximumNumberOfIterations[ i ][ j ];
+      if( i < this->m_CurrentParameterMap || ( i == this->m_CurrentParameterMap && j < this->m_CurrentLevel ) )
+      {
+        numberOfIterationsDone += this->m_MaximumNumberOfIterations[ i ][ j ];
+      }
+      else if( i == this->m_CurrentParameterMap && j == this->m_CurrentLevel )
+      {
+        numberOfIterationsDone += std::min( this->m_OptimizerIteration + 1, this->m_MaximumNumberOfIterations[ i ][ j ] );
+      }
+    }
+  }
+
+  if( totalNumberOfIterations == 0 )
+  {
+    return 0.0f;
+  }
+
+  return std::min( 1.0f, static_cast< float >( numberOfIterationsDone ) / static_cast< float >( totalNumberOfIterations ) );
+}
+
+const std::string 
+SimpleElastix::SimpleElastixImpl
+::GetName( void ) const
+{ 
+  const std::string name = "SimpleElastix";
+  return name;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetFixedImage( const Image& fixedImage )
+{
+  if( this->IsEmpty( fixedImage ) )
+  {
+    sitkExceptionMacro( "Image is empty." )
+  }
+
+  this->RemoveFixedImage();
+  this->m_FixedImages.push_back( fixedImage );
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetFixedImage( const VectorOfImage& fixedImages )
+{
+  if( fixedImages.size() == 0u )
+  {
+    sitkExceptionMacro( "Cannot set fixed images from empty vector" );
+  }
+
+  this->RemoveFixedImage();
+  this->m_FixedImages = fixedImages;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::AddFixedImage( const Image& fixedImage )
+{
+  if( this->IsEmpty( fixedImage ) )
+  {
+    sitkExceptionMacro( "Image is empty." )
+  }
+
+  this->m_FixedImages.push_back( fixedImage );
+}
+
+Image&
+SimpleElastix::SimpleElastixImpl
+::GetFixedImage( const unsigned long index )
+{
+  // The image may be modified through the reference, without a new modified time
+  this->m_ImageDigests.clear();
+  if( index < this->m_FixedImages.size() )
+  {
+    // The image may be modified through the reference
+    this->m_CachedFixedImages.clear();
+    this->m_CachedFixedImageObjects.clear();
+    return this->m_FixedImages[ index ];
+  }
+
+  sitkExceptionMacro( "Index out of range (index: " << index << ", number of fixed images: " << this->m_FixedImages.size() << ")" );
+}
+
+SimpleElastix::SimpleElastixImpl::VectorOfImage&
+SimpleElastix::SimpleElastixImpl
+::GetFixedImage( void )
+{
+  // The image may be modified through the reference, without a new modified time
+  this->m_ImageDigests.clear();
+  this->m_CachedFixedImages.clear();
+  this->m_CachedFixedImageObjects.clear();
+  return this->m_FixedImages;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::RemoveFixedImage( const unsigned long index )
+{
+  if( index < this->m_FixedImages.size() )
+  {
+    this->m_FixedImages.erase( this->m_FixedImages.begin() + index );
+  }
+
+  sitkExceptionMacro( "Index out of range (index: " << index << ", number of fixed images: " << this->m_FixedImages.size() << ")" );
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::RemoveFixedImage( void )
+{
+  this->m_FixedImages.clear();
+  this->m_CachedFixedImages.clear();
+  this->m_CachedFixedImageObjects.clear();
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetCacheFixedImages( const bool cacheFixedImages )
+{
+  this->m_CacheFixedImages = cacheFixedImages;
+  this->m_CachedFixedImages.clear();
+  this->m_CachedFixedImageObjects.clear();
+  this->m_CachedFixedMasks.clear();
+  this->m_CachedFixedMaskObjects.clear();
+}
+
+bool
+SimpleElastix::SimpleElastixImpl
+::GetCacheFixedImages( void )
+{
+  return this->m_CacheFixedImages;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::CacheFixedImagesOn( void )
+{
+  this->SetCacheFixedImages( true );
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::CacheFixedImagesOff( void )
+{
+  this->SetCacheFixedImages( false );
+}
+
+uint64_t
+SimpleElastix::SimpleElastixImpl
+::GetFixedImageCacheHits( void )
+{
+  return this->m_FixedImageCacheHits;
+}
+
+uint64_t
+SimpleElastix::SimpleElastixImpl
+::GetFixedImageCacheMisses( void )
+{
+  return this->m_FixedImageCacheMisses;
+}
+
+SimpleElastix::SimpleElastixImpl::CachedImageKeyType
+SimpleElastix::SimpleElastixImpl
+::GetCachedImageKey( const Image& image )
+{
+  const itk::DataObject* dataObject = image.GetITKBase();
+  return CachedImageKeyType( dataObject, dataObject->GetMTime() );
+}
+
+Image
+SimpleElastix::SimpleElastixImpl
+::GetInternalFixedImage( const unsigned int index, const PixelIDValueEnum internalPixelID )
+{
+  const Image& fixedImage = this->m_FixedImages[ index ];
+  if( !this->m_CacheFixedImages )
+  {
+    return this->CastToInternalImage( fixedImage, internalPixelID );
+  }
+
+  // An entry is valid for the image it was made from, in the requested pixel type
+  if( this->m_CachedFixedImages.size() != this->m_FixedImages.size() )
+  {
+    this->m_CachedFixedImages = VectorOfImage( this->m_FixedImages.size() );
+    this->m_CachedFixedImageObjects = std::vector< CachedImageKeyType >( this->m_FixedImages.size(), CachedImageKeyType( static_cast< const itk::DataObject* >( NULL ), 0 ) );
+  }
+
+  const CachedImageKeyType key = GetCachedImageKey( fixedImage );
+  if( this->m_CachedFixedImageObjects[ index ] != key || this->m_CachedFixedImages[ index ].GetPixelID() != internalPixelID )
+  {
+    this->m_CachedFixedImages[ index ] = this->CastToInternalImage( fixedImage, internalPixelID );
+    this->m_CachedFixedImageObjects[ index ] = key;
+    ++this->m_FixedImageCacheMisses;
+  }
+  else
+  {
+    ++this->m_FixedImageCacheHits;
+  }
+
+  return this->m_CachedFixedImages[ index ];
+}
+
+Image
+SimpleElastix::SimpleElastixImpl
+::GetInternalFixedMask( const unsigned int index )
+{
+  const Image& fixedMask = this->m_FixedMasks[ index ];
+  if( !this->m_CacheFixedImages )
+  {
+    return this->CastToInternalMask( fixedMask, this->m_HasFixedMaskLabel, this->m_FixedMaskLabel );
+  }
+
+  if( this->m_CachedFixedMasks.size() != this->m_FixedMasks.size() )
+  {
+    this->m_CachedFixedMasks = VectorOfImage( this->m_FixedMasks.size() );
+    this->m_CachedFixedMaskObjects = std::vector< CachedImageKeyType >( this->m_FixedMasks.size(), CachedImageKeyType( static_cast< const itk::DataObject* >( NULL ), 0 ) );
+  }
+
+  const CachedImageKeyType key = GetCachedImageKey( fixedMask );
+  if( this->m_CachedFixedMaskObjects[ index ] != key )
+  {
+    this->m_CachedFixedMasks[ index ] = this->CastToInternalMask( fixedMask, this->m_HasFixedMaskLabel, this->m_FixedMaskLabel );
+    this->m_CachedFixedMaskObjects[ index ] = key;
+  }
+
+  return this->m_CachedFixedMasks[ index ];
+}
+
+unsigned int
+SimpleElastix::SimpleElastixImpl
+::GetNumberOfFixedImages( void )
+{
+  return this->m_FixedImages.size();
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetMovingImage( const Image& movingImage )
+{
+  if( this->IsEmpty( movingImage ) )
+  {
+    sitkExceptionMacro( "Image is empty." )
+  }
+
+  this->RemoveMovingImage();
+  this->m_MovingImages.push_back( movingImage );
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetMovingImage( const VectorOfImage& movingImages )
+{
+  if( movingImages.size() == 0u )
+  {
+    sitkExceptionMacro( "Cannot set moving images from empty vector" );
+  }
+
+  this->RemoveMovingImage();
+  this->m_MovingImages = movingImages;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::AddMovingImage( const Image& movingImage )
+{
+  if( this->IsEmpty( movingImage ) )
+  {
+    sitkExceptionMacro( "Image is empty." )
+  }
+
+  this->m_MovingImages.push_back( movingImage );
+}
+
+Image&
+SimpleElastix::SimpleElastixImpl
+::GetMovingImage( const unsigned long index )
+{
+  // The image may be modified through the reference, without a new modified time
+  this->m_ImageDigests.clear();
+  if( index < this->m_MovingImages.size() )
+  {
+    return this->m_MovingImages[ index ];
+  }
+  
+  sitkExceptionMacro( "Index out of range (index: " << index << ", number of moving images: " << this->m_MovingImages.size() << ")" );
+}
+
+SimpleElastix::SimpleElastixImpl::VectorOfImage&
+SimpleElastix::SimpleElastixImpl
+::GetMovingImage( void )
+{
+  // The image may be modified through the reference, without a new modified time
+  this->m_ImageDigests.clear();
+  return this->m_MovingImages;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::RemoveMovingImage( const unsigned long index )
+{
+  if( index < this->m_MovingImages.size() )
+  {
+    this->m_MovingImages.erase( this->m_MovingImages.begin() + index );
+  }
+
+  sitkExceptionMacro( "Index out of range (index: " << index << ", number of moving images: " << this->m_MovingImages.size() << ")" );
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::RemoveMovingImage( void )
+{
+  this->m_MovingImages.clear();
+}
+
+unsigned int
+SimpleElastix::SimpleElastixImpl
+::GetNumberOfMovingImages( void )
+{
+  return this->m_MovingImages.size();
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetFixedMask( const Image& fixedMask )
+{
+  if( this->IsEmpty( fixedMask ) )
+  {
+    sitkExceptionMacro( "Image is empty." )
+  }
+
+  this->RemoveFixedMask();
+  this->m_FixedMasks.push_back( fixedMask );
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetFixedMask( const VectorOfImage& fixedMasks )
+{
+  if( fixedMasks.size() == 0u )
+  {
+    sitkExceptionMacro( "Cannot set fixed images from empty vector" );
+  }
+
+  this->RemoveFixedMask();
+  this->m_FixedMasks = fixedMasks;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::AddFixedMask( const Image& fixedMask )
+{
+  if( this->IsEmpty( fixedMask ) )
+  {
+    sitkExceptionMacro( "Image is empty." )
+  }
+
+  this->m_FixedMasks.push_back( fixedMask );
+}
+
+Image&
+SimpleElastix::SimpleElastixImpl
+::GetFixedMask( const unsigned long index )
+{
+  // The image may be modified through the reference, without a new modified time
+  this->m_ImageDigests.clear();
+  if( index < this->m_FixedMasks.size() )
+  {
+    // The mask may be modified through the reference
+    this->m_CachedFixedMasks.clear();
+    this->m_CachedFixedMaskObjects.clear();
+    return this->m_FixedMasks[ index ];
+  }
+
+  sitkExceptionMacro( "Index out of range (index: " << index << ", number of fixed masks: " << this->m_FixedMasks.size() << ")" );
+}
+
+SimpleElastix::VectorOfImage&
+SimpleElastix::SimpleElastixImpl
+::GetFixedMask( void )
+{
+  // The image may be modified through the reference, without a new modified time
+  this->m_ImageDigests.clear();
+  this->m_CachedFixedMasks.clear();
+  this->m_CachedFixedMaskObjects.clear();
+  return this->m_FixedMasks;
+}
 
 void
 SimpleElastix::SimpleElastixImpl
 ::RemoveFixedMask( const unsigned long index )
 {
-  if( index < this->m_FixedMasks.size()  )
+  if( index < this->m_FixedMasks.size()  )
+  {
+    this->m_FixedMasks.erase( this->m_FixedMasks.begin() + index );
+    this->m_CachedFixedMasks.clear();
+    this->m_CachedFixedMaskObjects.clear();
+  }
+
+  sitkExceptionMacro( "Index out of range (index: " << index << ", number of fixed masks: " << this->m_FixedMasks.size() << ")" );
+}
+
+void 
+SimpleElastix::SimpleElastixImpl
+::RemoveFixedMask( void )
+{
+  this->m_FixedMasks.clear();
+  this->m_CachedFixedMasks.clear();
+  this->m_CachedFixedMaskObjects.clear();
+}
+
+unsigned int
+SimpleElastix::SimpleElastixImpl
+::GetNumberOfFixedMasks( void )
+{
+  return this->m_FixedMasks.size();
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetFixedMaskLabel( const int64_t fixedMaskLabel )
+{
+  this->m_HasFixedMaskLabel = true;
+  this->m_FixedMaskLabel = fixedMaskLabel;
+  this->m_CachedFixedMasks.clear();
+  this->m_CachedFixedMaskObjects.clear();
+}
+
+int64_t
+SimpleElastix::SimpleElastixImpl
+::GetFixedMaskLabel( void )
+{
+  if( !this->m_HasFixedMaskLabel )
+  {
+    sitkExceptionMacro( "No fixed mask label has been set. Any non-zero voxel of the fixed masks is inside the mask." );
+  }
+
+  return this->m_FixedMaskLabel;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::RemoveFixedMaskLabel( void )
+{
+  this->m_HasFixedMaskLabel = false;
+  this->m_FixedMaskLabel = 0;
+  this->m_CachedFixedMasks.clear();
+  this->m_CachedFixedMaskObjects.clear();
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetMovingMask( const Image& movingMask )
+{
+  if( this->IsEmpty( movingMask ) )
+  {
+    sitkExceptionMacro( "Image is empty." )
+  }
+
+  this->RemoveMovingMask();
+  this->m_MovingMasks.push_back( movingMask );
+}
+
+void 
+SimpleElastix::SimpleElastixImpl
+::SetMovingMask( const VectorOfImage& movingMasks )
+{
+  if( movingMasks.size() == 0u )
+  {
+    sitkExceptionMacro( "Cannot set moving masks from empty vector" );
+  }
+
+  this->RemoveMovingMask();
+  this->m_MovingMasks = movingMasks;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::AddMovingMask( const Image& movingMask )
+{
+  if( this->IsEmpty( movingMask ) )
+  {
+    sitkExceptionMacro( "Image is empty." )
+  }
+
+  this->m_MovingMasks.push_back( movingMask );
+}
+
+Image&
+SimpleElastix::SimpleElastixImpl
+::GetMovingMask( const unsigned long index )
+{
+  // The image may be modified through the reference, without a new modified time
+  this->m_ImageDigests.clear();
+  if( index < this->m_MovingMasks.size()  )
+  {
+    return this->m_MovingMasks[ index ];
+  }
+
+  sitkExceptionMacro( "Index out of range (index: " << index << ", number of moving masks: " << this->m_MovingMasks.size() << ")" );
+}
+
+SimpleElastix::SimpleElastixImpl::VectorOfImage&
+SimpleElastix::SimpleElastixImpl
+::GetMovingMask( void )
+{
+  // The image may be modified through the reference, without a new modified time
+  this->m_ImageDigests.clear();
+  return this->m_MovingMasks;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::RemoveMovingMask( const unsigned long index )
+{
+  if( index < this->m_MovingMasks.size()  )
+  {
+    this->m_MovingMasks.erase( this->m_MovingMasks.begin() + index );
+  }
+
+  sitkExceptionMacro( "Index out of range (index: " << index << ", number of moving masks: " << this->m_MovingMasks.size() << ")" );
+}
+
+void 
+SimpleElastix::SimpleElastixImpl
+::RemoveMovingMask( void )
+{
+  this->m_MovingMasks.clear();
+}
+
+unsigned int
+SimpleElastix::SimpleElastixImpl
+::GetNumberOfMovingMasks( void )
+{
+  return this->m_MovingMasks.size();
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetMovingMaskLabel( const int64_t movingMaskLabel )
+{
+  this->m_HasMovingMaskLabel = true;
+  this->m_MovingMaskLabel = movingMaskLabel;
+}
+
+int64_t
+SimpleElastix::SimpleElastixImpl
+::GetMovingMaskLabel( void )
+{
+  if( !this->m_HasMovingMaskLabel )
+  {
+    sitkExceptionMacro( "No moving mask label has been set. Any non-zero voxel of the moving masks is inside the mask." );
+  }
+
+  return this->m_MovingMaskLabel;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::RemoveMovingMaskLabel( void )
+{
+  this->m_HasMovingMaskLabel = false;
+  this->m_MovingMaskLabel = 0;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetFixedPointSetFileName( const std::string fixedPointSetFileName )
+{
+  this->RemoveFixedPointSet();
+  this->m_FixedPointSetFileName = fixedPointSetFileName;
+}
+
+std::string
+SimpleElastix::SimpleElastixImpl
+::GetFixedPointSetFileName( void )
+{
+  return this->m_FixedPointSetFileName;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::RemoveFixedPointSetFileName( void )
+{
+  this->m_FixedPointSetFileName = "";
+}
+
+void 
+SimpleElastix::SimpleElastixImpl
+::SetMovingPointSetFileName( const std::string movingPointSetFileName )
+{
+  this->RemoveMovingPointSet();
+  this->m_MovingPointSetFileName = movingPointSetFileName;
+}
+
+std::string
+SimpleElastix::SimpleElastixImpl
+::GetMovingPointSetFileName( void )
+{
+  return this->m_MovingPointSetFileName;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::RemoveMovingPointSetFileName( void )
+{
+  this->m_MovingPointSetFileName = "";
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetFixedPointSet( const PointSetType& fixedPointSet )
+{
+  for( unsigned int i = 1; i < fixedPointSet.size(); ++i )
+  {
+    if( fixedPointSet[ i ].size() != fixedPointSet[ 0 ].size() )
+    {
+      sitkExceptionMacro( "Fixed points must be of same dimension (fixed point at index 0 is of dimension "
+                       << fixedPointSet[ 0 ].size() << ", fixed point at index " << i
+                       << " is of dimension " << fixedPointSet[ i ].size() << ")." );
+    }
+  }
+
+  this->RemoveFixedPointSetFileName();
+  this->m_FixedPointSet = fixedPointSet;
+}
+
+SimpleElastix::SimpleElastixImpl::PointSetType
+SimpleElastix::SimpleElastixImpl
+::GetFixedPointSet( void )
+{
+  return this->m_FixedPointSet;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::RemoveFixedPointSet( void )
+{
+  this->m_FixedPointSet.clear();
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetMovingPointSet( const PointSetType& movingPointSet )
+{
+  for( unsigned int i = 1; i < movingPointSet.size(); ++i )
   {
-    this->m_FixedMasks.erase( this->m_FixedMasks.begin() + index );
+    if( movingPointSet[ i ].size() != movingPointSet[ 0 ].size() )
+    {
+      sitkExceptionMacro( "Moving points must be of same dimension (moving point at index 0 is of dimension "
+                       << movingPointSet[ 0 ].size() << ", moving point at index " << i
+                       << " is of dimension " << movingPointSet[ i ].size() << ")." );
+    }
   }
 
-  sitkExceptionMacro( "Index out of range (index: " << index << ", number of fixed masks: " << this->m_FixedMasks.size() << ")" );
+  this->RemoveMovingPointSetFileName();
+  this->m_MovingPointSet = movingPointSet;
 }
 
-void 
+SimpleElastix::SimpleElastixImpl::PointSetType
 SimpleElastix::SimpleElastixImpl
-::RemoveFixedMask( void )
+::GetMovingPointSet( void )
 {
-  this->m_FixedMasks.clear();
+  return this->m_MovingPointSet;
 }
 
-unsigned int
+void
 SimpleElastix::SimpleElastixImpl
-::GetNumberOfFixedMasks( void )
+::RemoveMovingPointSet( void )
 {
-  return this->m_FixedMasks.size();
+  this->m_MovingPointSet.clear();
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::SetMovingMask( const Image& movingMask )
+::SetOutputDirectory( const std::string outputDirectory )
 {
-  if( this->IsEmpty( movingMask ) )
-  {
-    sitkExceptionMacro( "Image is empty." )
-  }
+  this->m_OutputDirectory = outputDirectory;
+}
 
-  this->RemoveMovingMask();
-  this->m_MovingMasks.push_back( movingMask );
+std::string
+SimpleElastix::SimpleElastixImpl
+::GetOutputDirectory( void )
+{
+  return this->m_OutputDirectory;
 }
 
-void 
+void
 SimpleElastix::SimpleElastixImpl
-::SetMovingMask( const VectorOfImage& movingMasks )
+::RemoveOutputDirectory( void )
 {
-  if( movingMasks.size() == 0u )
-  {
-    sitkExceptionMacro( "Cannot set moving masks from empty vector" );
-  }
+  this->m_OutputDirectory = "";
+}
 
-  this->RemoveMovingMask();
-  this->m_MovingMasks = movingMasks;
+void
+SimpleElastix::SimpleElastixImpl
+::SetLogFileName( std::string logFileName )
+{
+  this->m_LogFileName = logFileName;
+}
+
+std::string
+SimpleElastix::SimpleElastixImpl
+::GetLogFileName( void )
+{
+  return this->m_LogFileName;
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::AddMovingMask( const Image& movingMask )
+::RemoveLogFileName( void )
 {
-  if( this->IsEmpty( movingMask ) )
-  {
-    sitkExceptionMacro( "Image is empty." )
-  }
+  this->m_LogFileName = "";
+}
 
-  this->m_MovingMasks.push_back( movingMask );
+void
+SimpleElastix::SimpleElastixImpl
+::SetLogToFile( bool logToFile )
+{
+  this->m_LogToFile = logToFile;
 }
 
-Image&
+bool
 SimpleElastix::SimpleElastixImpl
-::GetMovingMask( const unsigned long index )
+::GetLogToFile( void )
 {
-  if( index < this->m_MovingMasks.size()  )
-  {
-    return this->m_MovingMasks[ index ];
-  }
+  return this->m_LogToFile;
+}
 
-  sitkExceptionMacro( "Index out of range (index: " << index << ", number of moving masks: " << this->m_MovingMasks.size() << ")" );
+void
+SimpleElastix::SimpleElastixImpl
+::LogToFileOn()
+{
+  this->SetLogToFile( true );
 }
 
-SimpleElastix::SimpleElastixImpl::VectorOfImage&
+void
 SimpleElastix::SimpleElastixImpl
-::GetMovingMask( void )
+::LogToFileOff()
 {
-  return this->m_MovingMasks;
+  this->SetLogToFile( false );
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::RemoveMovingMask( const unsigned long index )
+::SetLogToConsole( bool logToConsole )
 {
-  if( index < this->m_MovingMasks.size()  )
-  {
-    this->m_MovingMasks.erase( this->m_MovingMasks.begin() + index );
-  }
+  this->m_LogToConsole = logToConsole;
+}
 
-  sitkExceptionMacro( "Index out of range (index: " << index << ", number of moving masks: " << this->m_MovingMasks.size() << ")" );
+bool
+SimpleElastix::SimpleElastixImpl
+::GetLogToConsole( void )
+{
+  return this->m_LogToConsole;
 }
 
-void 
+void
 SimpleElastix::SimpleElastixImpl
-::RemoveMovingMask( void )
+::LogToConsoleOn()
 {
-  this->m_MovingMasks.clear();
+  this->SetLogToConsole( true );
 }
 
-unsigned int
+void
 SimpleElastix::SimpleElastixImpl
-::GetNumberOfMovingMasks( void )
+::LogToConsoleOff()
 {
-  return this->m_MovingMasks.size();
+  this->SetLogToConsole( false );
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::SetFixedPointSetFileName( const std::string fixedPointSetFileName )
+::SetLogToMemory( const bool logToMemory )
 {
-  this->m_FixedPointSetFileName = fixedPointSetFileName;
+  this->m_LogToMemory = logToMemory;
+}
+
+bool
+SimpleElastix::SimpleElastixImpl
+::GetLogToMemory( void )
+{
+  return this->m_LogToMemory;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::LogToMemoryOn( void )
+{
+  this->SetLogToMemory( true );
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::LogToMemoryOff( void )
+{
+  this->SetLogToMemory( false );
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetMaximumLogSize( const unsigned int maximumLogSize )
+{
+  this->m_Log.SetMaximumSize( maximumLogSize );
+}
+
+unsigned int
+SimpleElastix::SimpleElastixImpl
+::GetMaximumLogSize( void )
+{
+  return static_cast< unsigned int >( this->m_Log.GetMaximumSize() );
 }
 
 std::string
 SimpleElastix::SimpleElastixImpl
-::GetFixedPointSetFileName( void )
+::GetLog( void )
 {
-  return this->m_FixedPointSetFileName;
+  return this->m_Log.GetLog();
+}
+
+std::vector< std::vector< double > >
+SimpleElastix::SimpleElastixImpl
+::GetIterationTable( void )
+{
+  return this->m_IterationTable;
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::RemoveFixedPointSetFileName( void )
+::SetComputeResultImage( const bool computeResultImage )
 {
-  this->m_FixedPointSetFileName = "";
+  this->m_ComputeResultImage = computeResultImage;
 }
 
-void 
+bool
 SimpleElastix::SimpleElastixImpl
-::SetMovingPointSetFileName( const std::string movingPointSetFileName )
+::GetComputeResultImage( void )
 {
-  this->m_MovingPointSetFileName = movingPointSetFileName;
+  return this->m_ComputeResultImage;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::ComputeResultImageOn( void )
+{
+  this->SetComputeResultImage( true );
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::ComputeResultImageOff( void )
+{
+  this->SetComputeResultImage( false );
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetParameterMap( const std::string transformName, const unsigned int numberOfResolutions, const double finalGridSpacingInPhysicalUnits )
+{
+  ParameterMapType parameterMap = ParameterObjectType::GetDefaultParameterMap( transformName, numberOfResolutions, finalGridSpacingInPhysicalUnits );
+  this->SetParameterMap( parameterMap );
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetParameterMap( const ParameterMapType& parameterMap )
+{
+  ParameterMapVectorType parameterMapVector = ParameterMapVectorType( 1, parameterMap );
+  this->SetParameterMap( parameterMapVector );
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetParameterMap( const ParameterMapVectorType& parameterMapVector )
+{
+  this->m_ParameterMapVector = parameterMapVector;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::AddParameterMap( const ParameterMapType& parameterMap )
+{
+  this->m_ParameterMapVector.push_back( parameterMap );
+}
+
+SimpleElastix::SimpleElastixImpl::ParameterMapVectorType 
+SimpleElastix::SimpleElastixImpl
+::GetParameterMap( void )
+{
+  return this->m_ParameterMapVector;
+}
+
+unsigned int 
+SimpleElastix::SimpleElastixImpl
+::GetNumberOfParameterMaps( void )
+{
+  return this->m_ParameterMapVector.size();
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetInitialTransformParameterFileName( const std::string initialTransformParameterFileName )
+{
+  this->RemoveInitialTransformParameterMap();
+  this->m_InitialTransformParameterMapFileName = initialTransformParameterFileName;
 }
 
 std::string
 SimpleElastix::SimpleElastixImpl
-::GetMovingPointSetFileName( void )
+::GetInitialTransformParameterFileName( void )
 {
-  return this->m_MovingPointSetFileName;
+  return m_InitialTransformParameterMapFileName ;
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::RemoveMovingPointSetFileName( void )
+::RemoveInitialTransformParameterFileName( void )
 {
-  this->m_MovingPointSetFileName = "";
+  this->m_InitialTransformParameterMapFileName = "";
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::SetOutputDirectory( const std::string outputDirectory )
+::SetInitialTransformParameterMap( const ParameterMapVectorType& initialTransformParameterMapVector )
 {
-  this->m_OutputDirectory = outputDirectory;
+  this->RemoveInitialTransformParameterFileName();
+  this->m_InitialTransformParameterMapVector = initialTransformParameterMapVector;
+}
+
+SimpleElastix::SimpleElastixImpl::ParameterMapVectorType
+SimpleElastix::SimpleElastixImpl
+::GetInitialTransformParameterMap( void )
+{
+  return this->m_InitialTransformParameterMapVector;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::RemoveInitialTransformParameterMap( void )
+{
+  this->m_InitialTransformParameterMapVector.clear();
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::SetMultiStartCandidates( const std::vector< std::vector< double > >& candidates )
+{
+  this->m_MultiStartCandidates = candidates;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::AddMultiStartCandidate( const std::vector< double >& candidate )
+{
+  this->m_MultiStartCandidates.push_back( candidate );
+}
+
+std::vector< std::vector< double > >
+SimpleElastix::SimpleElastixImpl
+::GetMultiStartCandidates( void )
+{
+  return this->m_MultiStartCandidates;
+}
+
+void
+SimpleElastix::SimpleElastixImpl
+::RemoveMultiStartCandidates( void )
+{
+  this->m_MultiStartCandidates.clear();
+}
+
+std::vector< double >
+SimpleElastix::SimpleElastixImpl
+::GetMultiStartMetricValues( void )
+{
+  if( this->m_MultiStartMetricValues.size() == 0 )
+  {
+    sitkExceptionMacro( "No multi-start metric values. Add multi-start candidates and run registration with Execute()." );
+  }
+
+  return this->m_MultiStartMetricValues;
 }
 
-std::string
+unsigned int
 SimpleElastix::SimpleElastixImpl
-::GetOutputDirectory( void )
+::GetBestMultiStartCandidate( void )
 {
-  return this->m_OutputDirectory;
+  if( this->m_MultiStartMetricValues.size() == 0 )
+  {
+    sitkExceptionMacro( "No multi-start candidate was chosen. Add multi-start candidates and run registration with Execute()." );
+  }
+
+  return this->m_BestMultiStartCandidate;
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::RemoveOutputDirectory( void )
+::SetParameter( const ParameterKeyType key, const ParameterValueType value )
 {
-  this->m_OutputDirectory = "";
+  for( unsigned int i = 0; i < this->m_ParameterMapVector.size(); i++ )
+  {
+    this->SetParameter( i, key, value );
+  }
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::SetLogFileName( std::string logFileName )
+::SetParameter( const ParameterKeyType key, const ParameterValueVectorType value )
 {
-  this->m_LogFileName = logFileName;
+  for( unsigned int i = 0; i < this->m_ParameterMapVector.size(); i++ )
+  {
+    this->SetParameter( i, key, value );
+  }
 }
 
-std::string
+void
 SimpleElastix::SimpleElastixImpl
-::GetLogFileName( void )
+::SetParameter( const unsigned int index, const ParameterKeyType key, const ParameterValueType value )
 {
-  return this->m_LogFileName;
+  if( index >= this->m_ParameterMapVector.size() )
+  {
+    sitkExceptionMacro( "Parameter map index is out of range (index: " << index << "; number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
+  }
+
+  this->m_ParameterMapVector[ index ][ key ] = ParameterValueVectorType( 1, value );
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::RemoveLogFileName( void )
+::SetParameter( const unsigned int index, const ParameterKeyType key, const ParameterValueVectorType value )
 {
-  this->m_LogFileName = "";
+  if( index >= this->m_ParameterMapVector.size() )
+  {
+    sitkExceptionMacro( "Parameter map index is out of range (index: " << index << ", number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
+  }
+
+  this->m_ParameterMapVector[ index ][ key ] = value;
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::SetLogToFile( bool logToFile )
+::AddParameter( const ParameterKeyType key, const ParameterValueType value )
 {
-  this->m_LogToFile = logToFile;
+  for( unsigned int i = 0; i < this->m_ParameterMapVector.size(); i++ )
+  {
+    this->AddParameter( i, key, value );
+  }
 }
 
-bool
+void
 SimpleElastix::SimpleElastixImpl
-::GetLogToFile( void )
+::AddParameter( const ParameterKeyType key, const ParameterValueVectorType value )
 {
-  return this->m_LogToFile;
+  for( unsigned int i = 0; i < this->m_ParameterMapVector.size(); i++ )
+  {
+    this->AddParameter( i, key, value );
+  }
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::LogToFileOn()
+::AddParameter( const unsigned int index, const ParameterKeyType key, const ParameterValueType value )
 {
-  this->SetLogToFile( true );
+  if( index >= this->m_ParameterMapVector.size() )
+  {
+    sitkExceptionMacro( "Parameter map index is out of range (index: " << index << ", number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
+  }
+
+  if( this->m_ParameterMapVector[ index ].find( key ) == this->m_ParameterMapVector[ index ].end() )
+  {
+    this->SetParameter( index, key, value );
+  }
+  else
+  {
+    this->m_ParameterMapVector[ index ][ key ].push_back( value );
+  }
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::LogToFileOff()
+::AddParameter( const unsigned int index, const ParameterKeyType key, const ParameterValueVectorType value )
 {
-  this->SetLogToFile( false );
+  if( index >= this->m_ParameterMapVector.size() )
+  {
+    sitkExceptionMacro( "Parameter map index is out of range (index: " << index << ", number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
+  }
+
+  if( this->m_ParameterMapVector[ index ].find( key ) == this->m_ParameterMapVector[ index ].end() )
+  {
+    this->SetParameter( index, key, value );
+  }
+  else
+  {
+    for( unsigned int i = 0; i < value.size(); i++ )
+    {
+      this->m_ParameterMapVector[ index ][ key ].push_back( value[ i ] );
+    }
+  }
 }
 
-void
+SimpleElastix::SimpleElastixImpl::ParameterValueVectorType
 SimpleElastix::SimpleElastixImpl
-::SetLogToConsole( bool logToConsole )
+::GetParameter( const ParameterKeyType key )
 {
-  this->m_LogToConsole = logToConsole;
+  if( this->m_ParameterMapVector.size() > 0 )
+  {
+    sitkExceptionMacro( "An index is needed when more than one parameter map is present. Please specify the parameter map number as the first argument." );
+  }
+
+  return this->GetParameter( 0, key );
 }
 
-bool
+SimpleElastix::SimpleElastixImpl::ParameterValueVectorType
 SimpleElastix::SimpleElastixImpl
-::GetLogToConsole( void )
+::GetParameter( const unsigned int index, const ParameterKeyType key )
 {
-  return this->m_LogToConsole;
+  if( index >= this->m_ParameterMapVector.size() )
+  {
+    sitkExceptionMacro( "Parameter map index is out of range (index: " << index << ", number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
+  }
+
+  return this->m_ParameterMapVector[ index ][ key ];
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::LogToConsoleOn()
+::RemoveParameter( const ParameterKeyType key )
 {
-  this->SetLogToConsole( true );
+  for( unsigned int i = 0; i < this->m_ParameterMapVector.size(); i++ )
+  {
+    this->RemoveParameter( i, key );
+  }
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::LogToConsoleOff()
+::RemoveParameter( const unsigned int index, const ParameterKeyType key )
 {
-  this->SetLogToConsole( false );
+  if( index >= this->m_ParameterMapVector.size() )
+  {
+    sitkExceptionMacro( "Parameter map index is out of range (index: " << index << ", number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
+  }
+
+  this->m_ParameterMapVector[ index ].erase( key );
 }
 
-void
+SimpleElastix::SimpleElastixImpl::ParameterMapType
 SimpleElastix::SimpleElastixImpl
-::SetParameterMap( const std::string transformName, const unsigned int numberOfResolutions, const double finalGridSpacingInPhysicalUnits )
+::ReadParameterFile( const std::string fileName )
 {
-  ParameterMapType parameterMap = ParameterObjectType::GetDefaultParameterMap( transformName, numberOfResolutions, finalGridSpacingInPhysicalUnits );
-  this->SetParameterMap( parameterMap );
+  ParameterObjectPointer parameterObject = ParameterObjectType::New();
+  parameterObject->ReadParameterFile( fileName );
+  return parameterObject->GetParameterMap( 0 );
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::SetParameterMap( const ParameterMapType parameterMap )
+::WriteParameterFile( const ParameterMapType& parameterMap, const std::string parameterFileName )
 {
-  ParameterMapVectorType parameterMapVector = ParameterMapVectorType( 1, parameterMap );
-  this->SetParameterMap( parameterMapVector );
+  ParameterObjectPointer parameterObject = ParameterObjectType::New();
+  parameterObject->WriteParameterFile( parameterMap, parameterFileName );
 }
 
-void
+SimpleElastix::SimpleElastixImpl::ParameterMapType
 SimpleElastix::SimpleElastixImpl
-::SetParameterMap( const ParameterMapVectorType parameterMapVector )
-{
-  this->m_ParameterMapVector = parameterMapVector;
+::GetDefaultParameterMap( const std::string transformName, const unsigned int numberOfResolutions, const double finalGridSpacingInPhysicalUnits )
+{ 
+  return ParameterObjectType::GetDefaultParameterMap( transformName, numberOfResolutions, finalGridSpacingInPhysicalUnits );
 }
 
-void
+SimpleElastix::SimpleElastixImpl::ParameterMapVectorType 
 SimpleElastix::SimpleElastixImpl
-::AddParameterMap( const ParameterMapType parameterMap )
+::GetTransformParameterMap( void )
 {
-  this->m_ParameterMapVector.push_back( parameterMap );
+  if( this->m_TransformParameterMapVector.size() == 0 )
+  {
+    sitkExceptionMacro( "Number of transform parameter maps: 0. Run registration with Execute()." );
+  }
+
+  return this->m_TransformParameterMapVector;
 }
 
-SimpleElastix::SimpleElastixImpl::ParameterMapVectorType 
+SimpleElastix::SimpleElastixImpl::ParameterMapType 
 SimpleElastix::SimpleElastixImpl
-::GetParameterMap( void )
+::GetTransformParameterMap( const unsigned int index )
 {
-  return this->m_ParameterMapVector;
+  if( this->GetNumberOfParameterMaps() == 0 )
+  {
+    sitkExceptionMacro( "Number of transform parameter maps: 0. Run registration with Execute()." );
+  }
+
+  if( this->GetNumberOfParameterMaps() <= index )
+  {
+    sitkExceptionMacro( "Index exceeds number of transform parameter maps (index: " << index
+                     << ", number of parameter maps: " << this->GetNumberOfParameterMaps() << ")." );
+  }
+
+  return this->m_TransformParameterMapVector[ index ];
 }
 
-unsigned int 
+Image
 SimpleElastix::SimpleElastixImpl
-::GetNumberOfParameterMaps( void )
+::GetResultImage( void )
 {
-  return this->m_ParameterMapVector.size();
+  if( this->IsEmpty( this->m_ResultImage ) && !this->m_ComputeResultImage )
+  {
+    sitkExceptionMacro( "No result image was computed because ComputeResultImage is off. Warp the moving image with SimpleTransformix and GetTransformParameterMap()." )
+  }
+
+  if( this->IsEmpty( this->m_ResultImage ) )
+  {
+    sitkExceptionMacro( "No result image found. Run registration with Execute()." )
+  }
+
+  return this->m_ResultImage;
 }
 
-void
+unsigned int
 SimpleElastix::SimpleElastixImpl
-::SetInitialTransformParameterFileName( const std::string initialTransformParameterFileName )
+::GetNumberOfThreads( void )
 {
-  this->m_InitialTransformParameterMapFileName = initialTransformParameterFileName;
+  if( this->m_ProcessObject )
+  {
+    return this->m_ProcessObject->GetNumberOfThreads();
+  }
+
+  return this->m_NumberOfThreads;
 }
 
-std::string
+SimpleElastix::SimpleElastixImpl::VectorOfImage
 SimpleElastix::SimpleElastixImpl
-::GetInitialTransformParameterFileName( void )
+::ExecuteBatch( const VectorOfImage& movingImages )
 {
-  return m_InitialTransformParameterMapFileName ;
+  if( this->GetNumberOfFixedImages() == 0 )
+  {
+    sitkExceptionMacro( "Fixed image not set." );
+  }
+
+  if( movingImages.size() == 0 )
+  {
+    sitkExceptionMacro( "Cannot execute batch registration from empty vector of moving images." );
+  }
+
+  // Cast the fixed images once so that all jobs share the same buffers
+  const PixelIDValueEnum fixedInternalImagePixelID = this->GetInternalImagePixelID( "FixedInternalImagePixelType", this->m_FixedImages[ 0 ].GetDimension() );
+  VectorOfImage fixedImages;
+  for( unsigned int i = 0; i < this->GetNumberOfFixedImages(); ++i )
+  {
+    fixedImages.push_back( this->GetInternalFixedImage( i, fixedInternalImagePixelID ) );
+  }
+
+  BatchData batchData;
+  for( unsigned int i = 0; i < movingImages.size(); ++i )
+  {
+    nsstd::auto_ptr< Self > job( this->NewJob() );
+    job->m_FixedImages = fixedImages;
+    job->m_MovingImages = VectorOfImage( 1, movingImages[ i ] );
+
+    // Jobs share the output directory, so each job gets its own log file
+    const std::string logFileName = this->m_LogFileName.empty() ? std::string( "elastix.log" ) : this->m_LogFileName;
+    job->m_LogFileName = logFileName + "." + ParameterObjectType::ToString( i );
+
+    batchData.Jobs.push_back( job.get() );
+    job.release();
+  }
+
+  this->ExecuteBatchJobs( batchData );
+
+  std::ostringstream errorMessages;
+  this->m_BatchTransformParameterMapVectors = std::vector< ParameterMapVectorType >( movingImages.size() );
+  for( unsigned int i = 0; i < batchData.Jobs.size(); ++i )
+  {
+    this->m_BatchTransformParameterMapVectors[ i ].swap( batchData.Jobs[ i ]->m_TransformParameterMapVector );
+    if( !batchData.ErrorMessages[ i ].empty() )
+    {
+      errorMessages << "Registration of moving image " << i << " failed: " << batchData.ErrorMessages[ i ] << std::endl;
+    }
+  }
+
+  if( !errorMessages.str().empty() )
+  {
+    sitkExceptionMacro( << errorMessages.str() );
+  }
+
+  return batchData.ResultImages;
 }
 
 void
 SimpleElastix::SimpleElastixImpl
-::RemoveInitialTransformParameterFileName( void )
+::ExecuteBatchJobs( BatchData& batchData )
 {
-  this->m_InitialTransformParameterMapFileName = "";
+  // elastix runs one registration at a time in the process (see ElastixProcessLock), so the jobs
+  // run one after the other. Only the NumberOfThreads threads of each registration run in parallel.
+  batchData.ResultImages = VectorOfImage( batchData.Jobs.size() );
+  batchData.ErrorMessages = std::vector< std::string >( batchData.Jobs.size() );
+  for( unsigned int i = 0; i < batchData.Jobs.size(); ++i )
+  {
+    // A failed job does not stop the others and is reported by the caller
+    try
+    {
+      batchData.ResultImages[ i ] = batchData.Jobs[ i ]->Execute();
+    }
+    catch( std::exception &e )
+    {
+      batchData.ErrorMessages[ i ] = e.what();
+    }
+    catch( ... )
+    {
+      batchData.ErrorMessages[ i ] = "Unknown error.";
+    }
+  }
 }
 
-void
-SimpleElastix::SimpleElastixImpl
-::SetParameter( const ParameterKeyType key, const ParameterValueType value )
-{
-  for( unsigned int i = 0; i < this->m_ParameterMapVector.size(); i++ )
+SimpleElastix::SimpleElastixImpl::ParameterMapVectorType
+SimpleElastix::SimpleElastixImpl
+::ExecuteMultiStart( void )
+{
+  const unsigned int dimension = this->m_FixedImages[ 0 ].GetDimension();
+  const unsigned int numberOfParameters = dimension == 2 ? 3u : 6u;
+  if( dimension != 2 && dimension != 3 )
+  {
+    sitkExceptionMacro( "Multi-start initialization supports 2D and 3D images (fixed images are of dimension " << dimension << ")." );
+  }
+
+  if( this->m_ParameterMapVector.size() == 0 )
+  {
+    sitkExceptionMacro( "Number of parameter maps: 0. Set parameter maps with SetParameterMap()." );
+  }
+
+  if( !this->m_InitialTransformParameterMapFileName.empty() )
+  {
+    sitkExceptionMacro( "Multi-start initialization cannot follow an initial transform parameter file. "
+                     << "Pass the initial transform with SetInitialTransformParameterMap( ReadParameterFile( ... ) ) instead." );
+  }
+
+  for( unsigned int i = 0; i < this->m_MultiStartCandidates.size(); ++i )
+  {
+    if( this->m_MultiStartCandidates[ i ].size() != numberOfParameters )
+    {
+      sitkExceptionMacro( "Multi-start candidates of " << dimension << "D registrations must have " << numberOfParameters
+                       << " EulerTransform parameters (candidate " << i << " has " << this->m_MultiStartCandidates[ i ].size() << ")." );
+    }
+  }
+
+  // Candidates are registered on the coarsest resolution only
+  const ParameterMapType coarsestResolutionParameterMap = GetCoarsestResolutionParameterMap( this->m_ParameterMapVector[ 0 ], dimension );
+
+  BatchData batchData;
+  for( unsigned int i = 0; i < this->m_MultiStartCandidates.size(); ++i )
   {
-    this->SetParameter( i, key, value );
+    nsstd::auto_ptr< Self > job( this->NewJob() );
+    job->m_MultiStartCandidates.clear();
+    job->m_ParameterMapVector = ParameterMapVectorType( 1, coarsestResolutionParameterMap );
+    job->m_InitialTransformParameterMapVector.push_back( this->GetMultiStartCandidateParameterMap( this->m_MultiStartCandidates[ i ] ) );
+    job->m_ComputeResultImage = false;
+    job->m_UseResultCache = false;
+    job->m_LogToMemory = true;
+    job->m_LogToFile = false;
+    job->m_LogToConsole = false;
+    batchData.Jobs.push_back( job.get() );
+    job.release();
   }
-}
 
-void
-SimpleElastix::SimpleElastixImpl
-::SetParameter( const ParameterKeyType key, const ParameterValueVectorType value )
-{
-  for( unsigned int i = 0; i < this->m_ParameterMapVector.size(); i++ )
+  this->ExecuteBatchJobs( batchData );
+
+  ParameterMapVectorType bestInitialTransformParameterMapVector;
+  std::ostringstream errorMessages;
+  this->m_MultiStartMetricValues = std::vector< double >( batchData.Jobs.size(), std::numeric_limits< double >::quiet_NaN() );
+  this->m_BestMultiStartCandidate = 0;
+  for( unsigned int i = 0; i < batchData.Jobs.size(); ++i )
   {
-    this->SetParameter( i, key, value );
+    Self* job = batchData.Jobs[ i ];
+    if( !batchData.ErrorMessages[ i ].empty() )
+    {
+      errorMessages << "Registration from multi-start candidate " << i << " failed: " << batchData.ErrorMessages[ i ] << std::endl;
+    }
+    else if( job->m_IterationTable.size() > 0 && job->m_TransformParameterMapVector.size() > 0 )
+    {
+      // The final metric value of the optimizer is estimated from its samples. The exact value is
+      // only logged when the first parameter map sets ShowExactMetricValue.
+      const double metricValue = job->m_ExactMetricValue == job->m_ExactMetricValue ? job->m_ExactMetricValue : job->m_IterationTable.back()[ 3 ];
+      this->m_MultiStartMetricValues[ i ] = metricValue;
+
+      // elastix minimizes the metric. NaN values never compare less and are not chosen.
+      if( bestInitialTransformParameterMapVector.size() == 0 || metricValue < this->m_MultiStartMetricValues[ this->m_BestMultiStartCandidate ] )
+      {
+        if( metricValue == metricValue )
+        {
+          this->m_BestMultiStartCandidate = i;
+          // The job is discarded, so its maps are taken over instead of copied
+          bestInitialTransformParameterMapVector.swap( job->m_TransformParameterMapVector );
+        }
+      }
+    }
   }
-}
 
-void
-SimpleElastix::SimpleElastixImpl
-::SetParameter( const unsigned int index, const ParameterKeyType key, const ParameterValueType value )
-{
-  if( index >= this->m_ParameterMapVector.size() )
+  if( bestInitialTransformParameterMapVector.size() == 0 )
   {
-    sitkExceptionMacro( "Parameter map index is out of range (index: " << index << "; number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
+    this->m_MultiStartMetricValues.clear();
+    sitkExceptionMacro( "No multi-start candidate could be registered." << std::endl << errorMessages.str() );
   }
 
-  this->m_ParameterMapVector[ index ][ key ] = ParameterValueVectorType( 1, value );
+  return bestInitialTransformParameterMapVector;
 }
 
-void
+SimpleElastix::SimpleElastixImpl::ParameterMapType
 SimpleElastix::SimpleElastixImpl
-::SetParameter( const unsigned int index, const ParameterKeyType key, const ParameterValueVectorType value )
+::GetMultiStartCandidateParameterMap( const std::vector< double >& candidate )
 {
-  if( index >= this->m_ParameterMapVector.size() )
+  // A rigid transform about the center of the first fixed image, on its grid
+  const Image& fixedImage = this->m_FixedImages[ 0 ];
+  const unsigned int dimension = fixedImage.GetDimension();
+  const std::vector< unsigned int > size = fixedImage.GetSize();
+  const std::vector< double > spacing = fixedImage.GetSpacing();
+  const std::vector< double > origin = fixedImage.GetOrigin();
+  const std::vector< double > direction = fixedImage.GetDirection();
+
+  std::vector< double > centerIndex( dimension );
+  for( unsigned int i = 0; i < dimension; ++i )
   {
-    sitkExceptionMacro( "Parameter map index is out of range (index: " << index << ", number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
+    centerIndex[ i ] = 0.5 * ( static_cast< double >( size[ i ] ) - 1.0 );
   }
 
-  this->m_ParameterMapVector[ index ][ key ] = value;
-}
+  const std::vector< double > center = fixedImage.TransformContinuousIndexToPhysicalPoint( centerIndex );
+
+  ParameterMapType parameterMap;
+  parameterMap[ "Transform" ] = ParameterValueVectorType( 1, "EulerTransform" );
+  parameterMap[ "NumberOfParameters" ] = ParameterValueVectorType( 1, ParameterObjectType::ToString( static_cast< unsigned int >( candidate.size() ) ) );
+  parameterMap[ "InitialTransformParametersFileName" ] = ParameterValueVectorType( 1, "NoInitialTransform" );
+  parameterMap[ "HowToCombineTransforms" ] = ParameterValueVectorType( 1, "Compose" );
+  parameterMap[ "FixedImageDimension" ] = ParameterValueVectorType( 1, ParameterObjectType::ToString( dimension ) );
+  parameterMap[ "MovingImageDimension" ] = ParameterValueVectorType( 1, ParameterObjectType::ToString( dimension ) );
+  parameterMap[ "FixedInternalImagePixelType" ] = ParameterValueVectorType( 1, "float" );
+  parameterMap[ "MovingInternalImagePixelType" ] = ParameterValueVectorType( 1, "float" );
+  parameterMap[ "UseDirectionCosines" ] = ParameterValueVectorType( 1, "true" );
+  parameterMap[ "ResampleInterpolator" ] = ParameterValueVectorType( 1, "FinalBSplineInterpolator" );
+  parameterMap[ "FinalBSplineInterpolationOrder" ] = ParameterValueVectorType( 1, "3" );
+  parameterMap[ "Resampler" ] = ParameterValueVectorType( 1, "DefaultResampler" );
+  parameterMap[ "DefaultPixelValue" ] = ParameterValueVectorType( 1, "0" );
+  parameterMap[ "ResultImagePixelType" ] = ParameterValueVectorType( 1, "float" );
+  parameterMap[ "ResultImageFormat" ] = ParameterValueVectorType( 1, "nii" );
+  parameterMap[ "CompressResultImage" ] = ParameterValueVectorType( 1, "false" );
+
+  for( unsigned int i = 0; i < candidate.size(); ++i )
+  {
+    parameterMap[ "TransformParameters" ].push_back( FormatElastixParameterValue( candidate[ i ] ) );
+  }
 
-void
-SimpleElastix::SimpleElastixImpl
-::AddParameter( const ParameterKeyType key, const ParameterValueType value )
-{
-  for( unsigned int i = 0; i < this->m_ParameterMapVector.size(); i++ )
+  for( unsigned int i = 0; i < dimension; ++i )
   {
-    this->AddParameter( i, key, value );
+    parameterMap[ "Size" ].push_back( ParameterObjectType::ToString( size[ i ] ) );
+    parameterMap[ "Index" ].push_back( "0" );
+    parameterMap[ "Spacing" ].push_back( FormatElastixParameterValue( spacing[ i ] ) );
+    parameterMap[ "Origin" ].push_back( FormatElastixParameterValue( origin[ i ] ) );
+    parameterMap[ "CenterOfRotationPoint" ].push_back( FormatElastixParameterValue( center[ i ] ) );
   }
-}
 
-void
-SimpleElastix::SimpleElastixImpl
-::AddParameter( const ParameterKeyType key, const ParameterValueVectorType value )
-{
-  for( unsigned int i = 0; i < this->m_ParameterMapVector.size(); i++ )
+  // elastix writes direction cosines column by column
+  for( unsigned int i = 0; i < dimension; ++i )
   {
-    this->AddParameter( i, key, value );
+    for( unsigned int j = 0; j < dimension; ++j )
+    {
+      parameterMap[ "Direction" ].push_back( FormatElastixParameterValue( direction[ j * dimension + i ] ) );
+    }
   }
+
+  return parameterMap;
 }
 
-void
+SimpleElastix::SimpleElastixImpl::ParameterMapType
 SimpleElastix::SimpleElastixImpl
-::AddParameter( const unsigned int index, const ParameterKeyType key, const ParameterValueType value )
+::GetCoarsestResolutionParameterMap( const ParameterMapType& parameterMap, const unsigned int dimension )
 {
-  if( index >= this->m_ParameterMapVector.size() )
+  // Per-resolution parameters are indexed by level, so a single resolution takes the values of the
+  // coarsest one. Only the pyramid schedules must be cut down to that level, as elastix would
+  // otherwise fall back to the full resolution.
+  ParameterMapType coarsestResolutionParameterMap = parameterMap;
+  ParameterMapConstIterator numberOfResolutionsIterator = parameterMap.find( "NumberOfResolutions" );
+  const unsigned int numberOfResolutions = numberOfResolutionsIterator != parameterMap.end() && numberOfResolutionsIterator->second.size() > 0
+                                         ? std::max( std::atoi( numberOfResolutionsIterator->second[ 0 ].c_str() ), 1 )
+                                         : 3u;
+
+  const std::string pyramids[] = { "Fixed", "Moving" };
+  for( unsigned int i = 0; i < 2; ++i )
   {
-    sitkExceptionMacro( "Parameter map index is out of range (index: " << index << ", number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
+    ParameterMapConstIterator schedule = parameterMap.find( pyramids[ i ] + "ImagePyramidSchedule" );
+    if( schedule == parameterMap.end() )
+    {
+      schedule = parameterMap.find( "ImagePyramidSchedule" );
+    }
+
+    ParameterValueVectorType coarsestSchedule( dimension, ParameterObjectType::ToString( 1u << ( numberOfResolutions - 1 ) ) );
+    if( schedule != parameterMap.end() && schedule->second.size() >= dimension )
+    {
+      coarsestSchedule = ParameterValueVectorType( schedule->second.begin(), schedule->second.begin() + dimension );
+    }
+
+    coarsestResolutionParameterMap[ pyramids[ i ] + "ImagePyramidSchedule" ] = coarsestSchedule;
   }
 
-  if( this->m_ParameterMapVector[ index ].find( key ) == this->m_ParameterMapVector[ index ].end() )
+  coarsestResolutionParameterMap.erase( "ImagePyramidSchedule" );
+  coarsestResolutionParameterMap[ "NumberOfResolutions" ] = ParameterValueVectorType( 1, "1" );
+  return coarsestResolutionParameterMap;
+}
+
+SimpleElastix::SimpleElastixImpl*
+SimpleElastix::SimpleElastixImpl
+::NewJob( void )
+{
+  nsstd::auto_ptr< Self > job( new Self() );
+  job->m_FixedImages = this->m_FixedImages;
+  job->m_MovingImages = this->m_MovingImages;
+  job->m_FixedMasks = this->m_FixedMasks;
+  job->m_MovingMasks = this->m_MovingMasks;
+  job->m_HasFixedMaskLabel = this->m_HasFixedMaskLabel;
+  job->m_FixedMaskLabel = this->m_FixedMaskLabel;
+  job->m_HasMovingMaskLabel = this->m_HasMovingMaskLabel;
+  job->m_MovingMaskLabel = this->m_MovingMaskLabel;
+  job->m_InitialTransformParameterMapFileName = this->m_InitialTransformParameterMapFileName;
+  job->m_InitialTransformParameterMapVector = this->m_InitialTransformParameterMapVector;
+  job->m_FixedPointSetFileName = this->m_FixedPointSetFileName;
+  job->m_MovingPointSetFileName = this->m_MovingPointSetFileName;
+  job->m_FixedPointSet = this->m_FixedPointSet;
+  job->m_MovingPointSet = this->m_MovingPointSet;
+  job->m_ParameterMapVector = this->m_ParameterMapVector;
+  job->m_MultiStartCandidates = this->m_MultiStartCandidates;
+  job->m_OutputDirectory = this->m_OutputDirectory;
+  job->m_LogFileName = this->m_LogFileName;
+  job->m_LogToFile = this->m_LogToFile;
+  job->m_LogToConsole = this->m_LogToConsole;
+  job->m_ComputeResultImage = this->m_ComputeResultImage;
+  job->m_UseResultCache = this->m_UseResultCache;
+  job->m_NumberOfThreads = this->GetNumberOfThreads();
+  return job.release();
+}
+
+SimpleElastix::AsyncJob*
+SimpleElastix::SimpleElastixImpl
+::ExecuteAsync( void )
+{
+  if( this->GetNumberOfFixedImages() == 0 )
   {
-    this->SetParameter( index, key, value );
+    sitkExceptionMacro( "Fixed image not set." );
   }
-  else
+
+  if( this->GetNumberOfMovingImages() == 0 )
   {
-    this->m_ParameterMapVector[ index ][ key ].push_back( value );
+    sitkExceptionMacro( "Moving image not set." );
   }
+
+  nsstd::auto_ptr< Self > registration( this->NewJob() );
+
+  AsyncJob* job = new AsyncJob( registration.get() );
+  registration.release();
+  AsyncJob::Submit( job );
+  return job;
 }
 
-void
-SimpleElastix::SimpleElastixImpl
-::AddParameter( const unsigned int index, const ParameterKeyType key, const ParameterValueVectorType value )
+SimpleElastix::AsyncJob
+::AsyncJob( RegistrationType* registration )
 {
-  if( index >= this->m_ParameterMapVector.size() )
+  this->Registration = registration;
+  this->Status = Queued;
+}
+
+SimpleElastix::AsyncJob
+::~AsyncJob( void )
+{
+  delete this->Registration;
+  this->Registration = NULL;
+}
+
+struct SimpleElastix::AsyncJob::Executor
+{
+  Executor( void )
   {
-    sitkExceptionMacro( "Parameter map index is out of range (index: " << index << ", number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
+    this->Threader = itk::MultiThreader::New();
+    this->NumberOfWorkers = 0;
+    this->MaximumNumberOfWorkers = 1;
   }
 
-  if( this->m_ParameterMapVector[ index ].find( key ) == this->m_ParameterMapVector[ index ].end() )
+  // Shutdown() may not have been called, and no thread may outlive the library
+  ~Executor( void )
   {
-    this->SetParameter( index, key, value );
+    this->Condition.Lock();
+    this->CancelAndJoin();
+    this->Condition.Unlock();
   }
-  else
+
+  // Must be called with the mutex held. Queued jobs are cancelled and running ones are waited for.
+  void CancelAndJoin( void )
   {
-    for( unsigned int i = 0; i < value.size(); i++ )
+    while( !this->QueuedJobs.empty() )
     {
-      this->m_ParameterMapVector[ index ][ key ].push_back( value[ i ] );
+      this->QueuedJobs.front()->Status = Cancelled;
+      this->QueuedJobs.front()->UnRegister();
+      this->QueuedJobs.pop_front();
+    }
+
+    for( unsigned int i = 0; i < this->RunningJobs.size(); ++i )
+    {
+      this->RunningJobs[ i ]->Registration->RequestAbort();
     }
+
+    this->Condition.Broadcast();
+    while( this->NumberOfWorkers > 0 )
+    {
+      this->Condition.Wait();
+    }
+
+    this->JoinFinishedWorkers();
   }
-}
 
-SimpleElastix::SimpleElastixImpl::ParameterValueVectorType
-SimpleElastix::SimpleElastixImpl
-::GetParameter( const ParameterKeyType key )
-{
-  if( this->m_ParameterMapVector.size() > 0 )
+  // Must be called with the mutex held
+  void JoinFinishedWorkers( void )
   {
-    sitkExceptionMacro( "An index is needed when more than one parameter map is present. Please specify the parameter map number as the first argument." );
+    for( unsigned int i = 0; i < this->FinishedWorkers.size(); ++i )
+    {
+      this->Threader->TerminateThread( this->FinishedWorkers[ i ] );
+    }
+
+    this->FinishedWorkers.clear();
   }
 
-  return this->GetParameter( 0, key );
+  // Must be called with the mutex held
+  void SpawnWorkers( void )
+  {
+    while( this->NumberOfWorkers < std::min( this->MaximumNumberOfWorkers, static_cast< unsigned int >( this->QueuedJobs.size() ) ) )
+    {
+      ++this->NumberOfWorkers;
+      this->Threader->SpawnThread( WorkerThreadCallback, NULL );
+    }
+  }
+
+  // Guards everything below and is signalled whenever a job or a worker finishes
+  ElastixConditionVariable          Condition;
+  itk::MultiThreader::Pointer       Threader;
+  std::list< AsyncJob* >            QueuedJobs;
+  std::vector< AsyncJob* >          RunningJobs;
+  std::vector< itk::ThreadIdType >  FinishedWorkers;
+  unsigned int                      NumberOfWorkers;
+  unsigned int                      MaximumNumberOfWorkers;
+};
+
+SimpleElastix::AsyncJob::Executor&
+SimpleElastix::AsyncJob
+::GetExecutor( void )
+{
+  static Executor executor;
+  return executor;
 }
 
-SimpleElastix::SimpleElastixImpl::ParameterValueVectorType
-SimpleElastix::SimpleElastixImpl
-::GetParameter( const unsigned int index, const ParameterKeyType key )
+void
+SimpleElastix::AsyncJob
+::Submit( AsyncJob* job )
 {
-  if( index >= this->m_ParameterMapVector.size() )
-  {
-    sitkExceptionMacro( "Parameter map index is out of range (index: " << index << ", number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
-  }
+  Executor& executor = GetExecutor();
+  executor.Condition.Lock();
+  executor.JoinFinishedWorkers();
 
-  return this->m_ParameterMapVector[ index ][ key ];
+  // The queue holds a reference until the job has run
+  job->Register();
+  executor.QueuedJobs.push_back( job );
+  executor.SpawnWorkers();
+  executor.Condition.Unlock();
 }
 
 void
-SimpleElastix::SimpleElastixImpl
-::RemoveParameter( const ParameterKeyType key )
+SimpleElastix::AsyncJob
+::Shutdown( void )
 {
-  for( unsigned int i = 0; i < this->m_ParameterMapVector.size(); i++ )
+  Executor& executor = GetExecutor();
+  executor.Condition.Lock();
+  executor.CancelAndJoin();
+  executor.Condition.Unlock();
+}
+
+void
+SimpleElastix::AsyncJob
+::SetMaximumNumberOfWorkers( const unsigned int maximumNumberOfWorkers )
+{
+  // Workers are spawned threads of a single threader, of which there can be ITK_MAX_THREADS.
+  // Without workers, jobs wait in the queue until workers are allowed again.
+  Executor& executor = GetExecutor();
+  executor.Condition.Lock();
+  executor.MaximumNumberOfWorkers = std::min( maximumNumberOfWorkers, static_cast< unsigned int >( ITK_MAX_THREADS ) );
+  executor.SpawnWorkers();
+  executor.Condition.Unlock();
+}
+
+unsigned int
+SimpleElastix::AsyncJob
+::GetMaximumNumberOfWorkers( void )
+{
+  Executor& executor = GetExecutor();
+  executor.Condition.Lock();
+  const unsigned int maximumNumberOfWorkers = executor.MaximumNumberOfWorkers;
+  executor.Condition.Unlock();
+  return maximumNumberOfWorkers;
+}
+
+unsigned int
+SimpleElastix::AsyncJob
+::GetNumberOfQueuedJobs( void )
+{
+  Executor& executor = GetExecutor();
+  executor.Condition.Lock();
+  const unsigned int numberOfQueuedJobs = executor.QueuedJobs.size();
+  executor.Condition.Unlock();
+  return numberOfQueuedJobs;
+}
+
+ITK_THREAD_RETURN_TYPE
+SimpleElastix::AsyncJob
+::WorkerThreadCallback( void* arg )
+{
+  itk::MultiThreader::ThreadInfoStruct* threadInfo = static_cast< itk::MultiThreader::ThreadInfoStruct* >( arg );
+  Executor& executor = GetExecutor();
+
+  executor.Condition.Lock();
+  while( !executor.QueuedJobs.empty() && executor.NumberOfWorkers <= executor.MaximumNumberOfWorkers )
   {
-    this->RemoveParameter( i, key );
+    AsyncJob* job = executor.QueuedJobs.front();
+    executor.QueuedJobs.pop_front();
+    executor.RunningJobs.push_back( job );
+    job->Status = Running;
+    executor.Condition.Unlock();
+
+    // Exceptions cannot cross thread boundaries and are rethrown by the result accessors
+    Image resultImage;
+    std::string errorMessage;
+    try
+    {
+      resultImage = job->Registration->Execute();
+    }
+    catch( std::exception &e )
+    {
+      errorMessage = e.what();
+    }
+    catch( ... )
+    {
+      errorMessage = "Unknown error.";
+    }
+
+    executor.Condition.Lock();
+    executor.RunningJobs.erase( std::find( executor.RunningJobs.begin(), executor.RunningJobs.end(), job ) );
+    if( job->Registration->m_Aborted || job->Registration->IsAbortRequested() )
+    {
+      job->Status = Cancelled;
+    }
+    else
+    {
+      job->Status = Finished;
+      job->ResultImage = resultImage;
+      job->TransformParameterMapVector = job->Registration->m_TransformParameterMapVector;
+      job->ErrorMessage = errorMessage;
+    }
+
+    // Release the inputs as soon as the registration has run
+    delete job->Registration;
+    job->Registration = NULL;
+    job->UnRegister();
+    executor.Condition.Broadcast();
   }
+
+  --executor.NumberOfWorkers;
+  executor.FinishedWorkers.push_back( threadInfo->ThreadID );
+  executor.Condition.Broadcast();
+  executor.Condition.Unlock();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+bool
+SimpleElastix::AsyncJob
+::IsDone( void )
+{
+  Executor& executor = GetExecutor();
+  executor.Condition.Lock();
+  const bool isDone = this->Status == Finished || this->Status == Cancelled;
+  executor.Condition.Unlock();
+  return isDone;
+}
+
+bool
+SimpleElastix::AsyncJob
+::IsCancelled( void )
+{
+  Executor& executor = GetExecutor();
+  executor.Condition.Lock();
+  const bool isCancelled = this->Status == Cancelled;
+  executor.Condition.Unlock();
+  return isCancelled;
 }
 
 void
-SimpleElastix::SimpleElastixImpl
-::RemoveParameter( const unsigned int index, const ParameterKeyType key )
+SimpleElastix::AsyncJob
+::Wait( void )
 {
-  if( index >= this->m_ParameterMapVector.size() )
+  Executor& executor = GetExecutor();
+  executor.Condition.Lock();
+  while( this->Status == Queued || this->Status == Running )
   {
-    sitkExceptionMacro( "Parameter map index is out of range (index: " << index << ", number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
+    executor.Condition.Wait();
   }
 
-  this->m_ParameterMapVector[ index ].erase( key );
+  executor.Condition.Unlock();
 }
 
-SimpleElastix::SimpleElastixImpl::ParameterMapType
-SimpleElastix::SimpleElastixImpl
-::ReadParameterFile( const std::string fileName )
+bool
+SimpleElastix::AsyncJob
+::WaitFor( const double seconds )
 {
-  ParameterObjectPointer parameterObject = ParameterObjectType::New();
-  parameterObject->ReadParameterFile( fileName );
-  return parameterObject->GetParameterMap( 0 );
+  const double endTime = itksys::SystemTools::GetTime() + seconds;
+  Executor& executor = GetExecutor();
+  executor.Condition.Lock();
+  while( this->Status == Queued || this->Status == Running )
+  {
+    const double remainingTime = endTime - itksys::SystemTools::GetTime();
+    if( remainingTime <= 0.0 )
+    {
+      executor.Condition.Unlock();
+      return false;
+    }
+
+    executor.Condition.WaitFor( remainingTime );
+  }
+
+  executor.Condition.Unlock();
+  return true;
 }
 
 void
-SimpleElastix::SimpleElastixImpl
-::WriteParameterFile( ParameterMapType const parameterMap, const std::string parameterFileName )
+SimpleElastix::AsyncJob
+::Cancel( void )
 {
-  ParameterObjectPointer parameterObject = ParameterObjectType::New();
-  parameterObject->WriteParameterFile( parameterMap, parameterFileName );
-}
+  Executor& executor = GetExecutor();
+  executor.Condition.Lock();
+  if( this->Status == Queued )
+  {
+    executor.QueuedJobs.remove( this );
+    this->Status = Cancelled;
+    delete this->Registration;
+    this->Registration = NULL;
+    executor.Condition.Broadcast();
+    executor.Condition.Unlock();
+
+    // Reference of the queue. The caller holds another one.
+    this->UnRegister();
+    return;
+  }
 
-SimpleElastix::SimpleElastixImpl::ParameterMapType
-SimpleElastix::SimpleElastixImpl
-::GetDefaultParameterMap( const std::string transformName, const unsigned int numberOfResolutions, const double finalGridSpacingInPhysicalUnits )
-{ 
-  return ParameterObjectType::GetDefaultParameterMap( transformName, numberOfResolutions, finalGridSpacingInPhysicalUnits );
+  // A registration that waits for elastix does not start, and one that runs elastix stops after
+  // its current iteration
+  if( this->Status == Running )
+  {
+    this->Registration->RequestAbort();
+  }
+
+  executor.Condition.Unlock();
 }
 
-SimpleElastix::SimpleElastixImpl::ParameterMapVectorType 
-SimpleElastix::SimpleElastixImpl
-::GetTransformParameterMap( void )
+Image
+SimpleElastix::AsyncJob
+::GetResultImage( void )
 {
-  if( this->m_TransformParameterMapVector.size() == 0 )
+  this->Wait();
+
+  if( this->Status == Cancelled )
   {
-    sitkExceptionMacro( "Number of transform parameter maps: 0. Run registration with Execute()." );
+    sitkExceptionMacro( "Registration was cancelled." );
   }
 
-  return this->m_TransformParameterMapVector;
+  if( !this->ErrorMessage.empty() )
+  {
+    sitkExceptionMacro( << this->ErrorMessage );
+  }
+
+  return this->ResultImage;
 }
 
-SimpleElastix::SimpleElastixImpl::ParameterMapType 
-SimpleElastix::SimpleElastixImpl
-::GetTransformParameterMap( const unsigned int index )
+SimpleElastix::AsyncJob::ParameterMapVectorType
+SimpleElastix::AsyncJob
+::GetTransformParameterMap( void )
 {
-  if( this->GetNumberOfParameterMaps() == 0 )
+  this->Wait();
+
+  if( this->Status == Cancelled )
   {
-    sitkExceptionMacro( "Number of transform parameter maps: 0. Run registration with Execute()." );
+    sitkExceptionMacro( "Registration was cancelled." );
   }
 
-  if( this->GetNumberOfParameterMaps() <= index )
+  if( !this->ErrorMessage.empty() )
   {
-    sitkExceptionMacro( "Index exceeds number of transform parameter maps (index: " << index
-                     << ", number of parameter maps: " << this->GetNumberOfParameterMaps() << ")." );
+    sitkExceptionMacro( << this->ErrorMessage );
   }
 
-  return this->m_TransformParameterMapVector[ index ];
+  return this->TransformParameterMapVector;
 }
 
-Image
+SimpleElastix::SimpleElastixImpl::ParameterMapVectorType
 SimpleElastix::SimpleElastixImpl
-::GetResultImage( void )
+::GetBatchTransformParameterMap( const unsigned int index )
 {
-  if( this->IsEmpty( this->m_ResultImage ) )
+  if( index >= this->m_BatchTransformParameterMapVectors.size() )
   {
-    sitkExceptionMacro( "No result image found. Run registration with Execute()." )
+    sitkExceptionMacro( "Index exceeds number of batch registrations (index: " << index
+                     << ", number of batch registrations: " << this->m_BatchTransformParameterMapVectors.size() << "). Run batch registration with ExecuteBatch()." );
   }
 
-  return this->m_ResultImage;
+  return this->m_BatchTransformParameterMapVectors[ index ];
+}
+
+unsigned int
+SimpleElastix::SimpleElastixImpl
+::GetNumberOfBatchTransformParameterMaps( void )
+{
+  return this->m_BatchTransformParameterMapVectors.size();
 }
 
 SimpleElastix::SimpleElastixImpl::ParameterMapVectorType
@@ -1006,22 +3156,6 @@ SimpleElastix::SimpleElastixImpl
     sitkExceptionMacro( "No forward transform parameter map found. Run forward registration before computing the inverse.")
   }
 
-  // Write forward transform parameter file to disk
-  // Head of chain
-  std::vector< std::string > forwardTransformParameterFileNames;
-  forwardTransformParameterFileNames.push_back( this->GetOutputDirectory() + "/forwardTransformParameterFile.0.txt" );
-  ParameterMapVectorType forwardTransformParameterMaps = this->m_TransformParameterMapVector;
-  forwardTransformParameterMaps[ 0 ][ "InitialTransformParametersFileName" ] = ParameterValueVectorType( 1, "NoInitialTransform" );
-  for( unsigned int i = 1; i < forwardTransformParameterMaps.size(); i++ )
-  {
-      // Chain transform parameter file
-      forwardTransformParameterFileNames.push_back( this->GetOutputDirectory() + "/forwardTransformParameterFile." + ParameterObjectType::ToString( i ) + ".txt" );
-      forwardTransformParameterMaps[ i ][ "InitialTransformParametersFileName" ] = ParameterValueVectorType( 1, forwardTransformParameterFileNames[ forwardTransformParameterFileNames.size()-1 ] );
-  }
-  ParameterObjectPointer forwardTransformParameterMapObject = ParameterObjectType::New();
-  forwardTransformParameterMapObject->SetParameterMap( forwardTransformParameterMaps );
-  forwardTransformParameterMapObject->WriteParameterFile( forwardTransformParameterFileNames );
-
   // Setup inverse transform parameter map
   for( unsigned int i = 0; i < inverseParameterMapVector.size(); i++ )
   {
@@ -1035,39 +3169,48 @@ SimpleElastix::SimpleElastixImpl
     }
   }
 
-  // Setup inverse registration
-  SimpleElastix selx;
-  selx.SetInitialTransformParameterFileName( forwardTransformParameterFileNames[ 0 ] );
-  selx.SetParameterMap( inverseParameterMapVector );  
+  // Setup inverse registration. The forward transform is handed over in memory and the output
+  // directory is only used for the log, so concurrent inversions never share any files.
+  Self selx;
+  selx.m_NumberOfThreads = this->GetNumberOfThreads();
+  selx.SetInitialTransformParameterMap( this->m_TransformParameterMapVector );
+  selx.SetParameterMap( inverseParameterMapVector );
 
   // Pass options from this SimpleElastix
-  selx.SetFixedImage( this->GetFixedImage( 0 ) ); 
-  selx.SetMovingImage( this->GetFixedImage( 0 ) ); // <-- The fixed image is also used as the moving image. This is not a bug.
-  selx.SetOutputDirectory( this->GetOutputDirectory() );
+  selx.SetFixedImage( this->m_FixedImages[ 0 ] );
+  selx.SetMovingImage( this->m_FixedImages[ 0 ] ); // <-- The fixed image is also used as the moving image. This is not a bug.
+  if( this->GetLogToFile() )
+  {
+    selx.SetOutputDirectory( this->GetOutputDirectory() );
+  }
+  else
+  {
+    selx.RemoveOutputDirectory();
+  }
   selx.SetLogFileName( this->GetLogFileName() );
   selx.SetLogToFile( this->GetLogToFile() );
   selx.SetLogToConsole( this->GetLogToConsole() );
 
+  // Only the transform is used
+  selx.ComputeResultImageOff();
   selx.Execute();
 
-  for( unsigned int i = 0; i < forwardTransformParameterFileNames.size(); i++ )
+  // TODO: Change direction/origin/spacing to match moving image
+
+  // The result begins with the forward transform that initialized it, which is dropped
+  if( selx.m_TransformParameterMapVector.size() <= this->m_TransformParameterMapVector.size() )
   {
-    try
-    {
-      std::remove( forwardTransformParameterFileNames[ i ].c_str() );
-    }
-    catch( ... )
-    {
-      std::cout << "Error removing file " << forwardTransformParameterFileNames[ i ] << ". Continuing ... " << std::endl;
-    }
+    sitkExceptionMacro( "Inverse registration did not return a transform parameter map." );
   }
 
-  // TODO: Change direction/origin/spacing to match moving image
+  ParameterMapVectorType inverseTransformParameterMap( selx.m_TransformParameterMapVector.size() - this->m_TransformParameterMapVector.size() );
+  for( unsigned int i = 0; i < inverseTransformParameterMap.size(); ++i )
+  {
+    inverseTransformParameterMap[ i ].swap( selx.m_TransformParameterMapVector[ this->m_TransformParameterMapVector.size() + i ] );
+  }
 
-  // Unlink the first transform parameter map
-  ParameterMapVectorType inverseTransformParameterMap = selx.GetTransformParameterMap();
-  inverseTransformParameterMap[ 0 ][ "InitialTransformParametersFileName" ] = ParameterValueVectorType( 1, "NoInitialTransform" );
-  this->m_InverseTransformParameterMapVector = inverseTransformParameterMap;
+  LinkTransformParameterChain( inverseTransformParameterMap, "" );
+  this->m_InverseTransformParameterMapVector.swap( inverseTransformParameterMap );
   return this->m_InverseTransformParameterMapVector;
 }
 
@@ -5,6 +5,11 @@
 #include "sitkSimpleElastix.h"
 #include "sitkMemberFunctionFactory.h"
 #include "sitkDualMemberFunctionFactory.h"
+#include "sitkSimpleElastixUtilities.h"
+
+// ITK
+#include "itkMultiThreader.h"
+#include "itkSimpleFastMutexLock.h"
 
 // Elastix
 #include "elxElastixFilter.h"
@@ -14,9 +19,10 @@ namespace itk {
   namespace simple {
 
 struct SimpleElastix::SimpleElastixImpl
+  : public ElastixLogListener
 {
 
-  SimpleElastixImpl( void );
+  SimpleElastixImpl( SimpleElastix* processObject = NULL );
   ~SimpleElastixImpl( void );
 
   typedef SimpleElastixImpl Self;                                
@@ -32,10 +38,13 @@ struct SimpleElastix::SimpleElastixImpl
   typedef SimpleElastix::ParameterMapIterator         ParameterMapIterator;
   typedef SimpleElastix::ParameterMapConstIterator    ParameterMapConstIterator;
 
+  typedef std::vector< double >                       PointType;
+  typedef std::vector< PointType >                    PointSetType;
+
   typedef elastix::ParameterObject                    ParameterObjectType;
   typedef elastix::ParameterObject::Pointer           ParameterObjectPointer;           
 
-  const std::string GetName( void );
+  const std::string GetName( void ) const;
 
   void SetFixedImage( const Image& fixedImage );
   void SetFixedImage( const VectorOfImage& fixedImages );
@@ -46,6 +55,14 @@ struct SimpleElastix::SimpleElastixImpl
   void RemoveFixedImage( void );
   unsigned int GetNumberOfFixedImages();
 
+  void SetCacheFixedImages( const bool cacheFixedImages );
+  bool GetCacheFixedImages( void );
+  void CacheFixedImagesOn( void );
+  void CacheFixedImagesOff( void );
+  uint64_t GetFixedImageCacheHits( void );
+  uint64_t GetFixedImageCacheMisses( void );
+  Image GetInternalFixedImage( const unsigned int index, const PixelIDValueEnum internalPixelID );
+
   void SetMovingImage( const Image& movingImages );
   void SetMovingImage( const VectorOfImage& movingImage );
   void AddMovingImage( const Image& movingImage );
@@ -63,6 +80,10 @@ struct SimpleElastix::SimpleElastixImpl
   void RemoveFixedMask( const unsigned long index );
   void RemoveFixedMask( void );
   unsigned int GetNumberOfFixedMasks();
+  void SetFixedMaskLabel( const int64_t fixedMaskLabel );
+  int64_t GetFixedMaskLabel( void );
+  void RemoveFixedMaskLabel( void );
+  Image GetInternalFixedMask( const unsigned int index );
 
   void SetMovingMask( const Image& movingMask );
   void SetMovingMask( const VectorOfImage& movingMasks );
@@ -72,6 +93,9 @@ struct SimpleElastix::SimpleElastixImpl
   void RemoveMovingMask( const unsigned long index );
   void RemoveMovingMask( void );
   unsigned int GetNumberOfMovingMasks();
+  void SetMovingMaskLabel( const int64_t movingMaskLabel );
+  int64_t GetMovingMaskLabel( void );
+  void RemoveMovingMaskLabel( void );
 
   void SetFixedPointSetFileName( const std::string movingPointSetFileName );
   std::string GetFixedPointSetFileName( void );
@@ -81,6 +105,14 @@ struct SimpleElastix::SimpleElastixImpl
   std::string GetMovingPointSetFileName( void );
   void RemoveMovingPointSetFileName( void );
 
+  void SetFixedPointSet( const PointSetType& fixedPointSet );
+  PointSetType GetFixedPointSet( void );
+  void RemoveFixedPointSet( void );
+
+  void SetMovingPointSet( const PointSetType& movingPointSet );
+  PointSetType GetMovingPointSet( void );
+  void RemoveMovingPointSet( void );
+
   void SetOutputDirectory( const std::string outputDirectory );
   std::string GetOutputDirectory( void );
   void RemoveOutputDirectory( void );
@@ -99,10 +131,24 @@ struct SimpleElastix::SimpleElastixImpl
   void LogToConsoleOn();
   void LogToConsoleOff();
 
+  void SetLogToMemory( const bool logToMemory );
+  bool GetLogToMemory( void );
+  void LogToMemoryOn( void );
+  void LogToMemoryOff( void );
+  void SetMaximumLogSize( const unsigned int maximumLogSize );
+  unsigned int GetMaximumLogSize( void );
+  std::string GetLog( void );
+  std::vector< std::vector< double > > GetIterationTable( void );
+
+  void SetComputeResultImage( const bool computeResultImage );
+  bool GetComputeResultImage( void );
+  void ComputeResultImageOn( void );
+  void ComputeResultImageOff( void );
+
   void SetParameterMap( const std::string transformName, const unsigned int numberOfResolutions = 4u, const double finalGridSpacingInPhysicalUnits = 10.0 );
-  void SetParameterMap( const std::vector< std::map< std::string, std::vector< std::string > > > parameterMapVector );
-  void SetParameterMap( const std::map< std::string, std::vector< std::string > > parameterMap );
-  void AddParameterMap( const std::map< std::string, std::vector< std::string > > parameterMap );
+  void SetParameterMap( const std::vector< std::map< std::string, std::vector< std::string > > >& parameterMapVector );
+  void SetParameterMap( const std::map< std::string, std::vector< std::string > >& parameterMap );
+  void AddParameterMap( const std::map< std::string, std::vector< std::string > >& parameterMap );
   std::vector< std::map< std::string, std::vector< std::string > > > GetParameterMap( void );
   std::map< std::string, std::vector< std::string > > GetDefaultParameterMap( const std::string transformName, const unsigned int numberOfResolutions = 4, const double finalGridSpacingInPhysicalUnits = 10.0 );
   unsigned int GetNumberOfParameterMaps( void );
@@ -124,14 +170,35 @@ struct SimpleElastix::SimpleElastixImpl
   std::string GetInitialTransformParameterFileName( void );
   void RemoveInitialTransformParameterFileName( void );
 
+  void SetInitialTransformParameterMap( const ParameterMapVectorType& initialTransformParameterMapVector );
+  ParameterMapVectorType GetInitialTransformParameterMap( void );
+  void RemoveInitialTransformParameterMap( void );
+
+  void SetMultiStartCandidates( const std::vector< std::vector< double > >& candidates );
+  void AddMultiStartCandidate( const std::vector< double >& candidate );
+  std::vector< std::vector< double > > GetMultiStartCandidates( void );
+  void RemoveMultiStartCandidates( void );
+  std::vector< double > GetMultiStartMetricValues( void );
+  unsigned int GetBestMultiStartCandidate( void );
+
   std::map< std::string, std::vector< std::string > > ReadParameterFile( const std::string filename );
-  void WriteParameterFile( const std::map< std::string, std::vector< std::string > > parameterMap, const std::string filename );
+  void WriteParameterFile( const std::map< std::string, std::vector< std::string > >& parameterMap, const std::string filename );
 
   Image Execute( void );
   std::vector< std::map< std::string, std::vector< std::string > > > GetTransformParameterMap( void );
   std::map< std::string, std::vector< std::string > > GetTransformParameterMap( const unsigned int index );
   Image GetResultImage( void );
 
+  unsigned int GetNumberOfThreads( void );
+
+  unsigned int GetCurrentLevel( void );
+  unsigned int GetOptimizerIteration( void );
+  double GetMetricValue( void );
+
+  VectorOfImage ExecuteBatch( const VectorOfImage& movingImages );
+  std::vector< std::map< std::string, std::vector< std::string > > > GetBatchTransformParameterMap( const unsigned int index );
+  unsigned int GetNumberOfBatchTransformParameterMaps( void );
+
   std::vector< std::map< std::string, std::vector< std::string > > > ExecuteInverse( void );
   std::vector< std::map< std::string, std::vector< std::string > > > ExecuteInverse( std::map< std::string, std::vector< std::string > > inverseParameterMap );
   std::vector< std::map< std::string, std::vector< std::string > > > ExecuteInverse( std::vector< std::map< std::string, std::vector< std::string > > > inverseParameterMapVector );
@@ -143,9 +210,110 @@ struct SimpleElastix::SimpleElastixImpl
 
   bool IsEmpty( const Image& image );
 
+  void SetUseResultCache( const bool useResultCache );
+  bool GetUseResultCache( void );
+  void UseResultCacheOn( void );
+  void UseResultCacheOff( void );
+  static void SetResultCacheMaximumSize( const uint64_t maximumSize );
+  static uint64_t GetResultCacheMaximumSize( void );
+  static uint64_t GetResultCacheSize( void );
+  static uint64_t GetResultCacheHits( void );
+  static uint64_t GetResultCacheMisses( void );
+  static void ClearResultCache( void );
+  uint64_t GetNumberOfHashedImages( void );
+
+  // Converted fixed images and pixel digests belong to the image object they were made from, as of
+  // the modified time it had then. Modified times are unique over all objects, so an image that is
+  // later allocated at the same address does not match.
+  typedef std::pair< const itk::DataObject*, itk::ModifiedTimeType > CachedImageKeyType;
+  typedef std::map< CachedImageKeyType, std::string > ImageDigestMapType;
+  static CachedImageKeyType GetCachedImageKey( const Image& image );
+
+  // The key of a registration is a SHA1 digest of its inputs, parameter maps and initial transform
+  std::string GetResultCacheKey( void );
+  std::string GetImageDigest( const Image& image, ImageDigestMapType& usedImageDigests );
+  static void DescribeImage( std::ostream& description, const Image& image, const std::string& digest );
+  static void DescribeParameterMaps( std::ostream& description, const ParameterMapVectorType& parameterMapVector );
+  bool FindInResultCache( const std::string& key );
+  void AddToResultCache( const std::string& key );
+
+  // Follow the elastix log of the running registration to report iterations to observers
+  virtual void OnElastixLogLine( const std::string& line );
+  bool HasLogObservers( void );
+  void RequestAbort( void );
+  bool IsAbortRequested( void );
+  float GetRegistrationProgress( void );
+
+  PixelIDValueEnum GetInternalImagePixelID( const ParameterKeyType key, const unsigned int dimension );
+  Image CastToInternalImage( const Image& image, const PixelIDValueEnum internalPixelID );
+  Image CastToInternalMask( const Image& mask, const bool hasLabel, const int64_t label );
+  static std::vector< std::string > LinkTransformParameterChain( ParameterMapVectorType& transformParameterMapVector, const std::string& directory );
+  std::string WriteTransformParameterChain( const ParameterMapVectorType& transformParameterMapVector, const std::string& directory );
+
+  // Jobs of ExecuteBatch() and ExecuteMultiStart() with the result of each. The jobs are owned here.
+  struct BatchData
+  {
+    ~BatchData( void )
+    {
+      for( unsigned int i = 0; i < this->Jobs.size(); ++i )
+      {
+        delete this->Jobs[ i ];
+      }
+    }
+
+    std::vector< Self* >        Jobs;
+    VectorOfImage               ResultImages;
+    std::vector< std::string >  ErrorMessages;
+  };
+
+  void ExecuteBatchJobs( BatchData& batchData );
+
+  // Register the coarsest resolution of the first parameter map from every multi-start candidate
+  // and return the initial transform chain of the best one
+  ParameterMapVectorType ExecuteMultiStart( void );
+  ParameterMapType GetMultiStartCandidateParameterMap( const std::vector< double >& candidate );
+  static ParameterMapType GetCoarsestResolutionParameterMap( const ParameterMapType& parameterMap, const unsigned int dimension );
+
+  // New implementation without owner that registers with the inputs and settings of this one
+  Self* NewJob( void );
+
+  SimpleElastix::AsyncJob* ExecuteAsync( void );
+
+  // Wrap the pixel buffer of an image in a new image object. Registrations that run concurrently on
+  // the same input then never race on ITK's pipeline bookkeeping (requested regions, time stamps).
+  // The buffer must be laid out as the image, which the const GetITKBase() ensures for region views.
+  template< class TImage >
+  static typename TImage::Pointer ShareImageBuffer( const TImage* image )
+  {
+    typename TImage::Pointer sharedImage = TImage::New();
+    sharedImage->CopyInformation( image );
+    sharedImage->SetBufferedRegion( image->GetBufferedRegion() );
+    sharedImage->SetRequestedRegion( image->GetRequestedRegion() );
+    sharedImage->SetPixelContainer( const_cast< typename TImage::PixelContainer* >( image->GetPixelContainer() ) );
+    return sharedImage;
+  }
+
   // Definitions for SimpleITK member factory
   typedef Image ( Self::*MemberFunctionType )( void );
   template< class TFixedImage, class TMovingImage > Image DualExecuteInternal( void );
+
+  // Fixed and moving images always share the internal pixel type, so only one instantiation of
+  // elastix is registered per pixel type instead of one per combination of pixel types. 4D images
+  // are registered as float only (see External_Elastix.cmake).
+  template< unsigned int VDimension > void RegisterDualExecuteInternal( void )
+  {
+    this->RegisterDualExecuteInternalForPixelType< float, VDimension >();
+    this->RegisterDualExecuteInternalForPixelType< int16_t, VDimension >();
+    this->RegisterDualExecuteInternalForPixelType< uint16_t, VDimension >();
+    this->RegisterDualExecuteInternalForPixelType< uint8_t, VDimension >();
+  }
+
+  template< class TPixel, unsigned int VDimension > void RegisterDualExecuteInternalForPixelType( void )
+  {
+    typedef itk::Image< TPixel, VDimension > ImageType;
+    this->m_DualMemberFactory->Register( &Self::DualExecuteInternal< ImageType, ImageType >, static_cast< ImageType* >( NULL ), static_cast< ImageType* >( NULL ) );
+  }
+
   friend struct detail::DualExecuteInternalAddressor< MemberFunctionType >;
   nsstd::auto_ptr< detail::DualMemberFunctionFactory< MemberFunctionType > > m_DualMemberFactory;
 
@@ -155,22 +323,131 @@ struct SimpleElastix::SimpleElastixImpl
   VectorOfImage           m_MovingMasks;
   Image                   m_ResultImage;
 
+  // Fixed images in the internal pixel type of elastix, kept between calls in session mode
+  bool                    m_CacheFixedImages;
+  VectorOfImage           m_CachedFixedImages;
+  std::vector< CachedImageKeyType > m_CachedFixedImageObjects;
+  VectorOfImage           m_CachedFixedMasks;
+  std::vector< CachedImageKeyType > m_CachedFixedMaskObjects;
+  uint64_t                m_FixedImageCacheHits;
+  uint64_t                m_FixedImageCacheMisses;
+  ImageDigestMapType      m_ImageDigests;
+  uint64_t                m_NumberOfHashedImages;
+
+  // Label of the masks that is inside the mask. Without a label, any non-zero voxel is inside.
+  bool                    m_HasFixedMaskLabel;
+  int64_t                 m_FixedMaskLabel;
+  bool                    m_HasMovingMaskLabel;
+  int64_t                 m_MovingMaskLabel;
+
+  bool                    m_UseResultCache;
+
   std::string             m_InitialTransformParameterMapFileName;
+  ParameterMapVectorType  m_InitialTransformParameterMapVector;
   std::string             m_FixedPointSetFileName;
   std::string             m_MovingPointSetFileName;
+  PointSetType            m_FixedPointSet;
+  PointSetType            m_MovingPointSet;
 
   ParameterMapVectorType  m_ParameterMapVector;
   ParameterMapVectorType  m_TransformParameterMapVector;
   ParameterMapVectorType  m_InverseTransformParameterMapVector;
 
+  // Threads of implementations without an owner, i.e. batch jobs and inner registrations
+  unsigned int                          m_NumberOfThreads;
+  std::vector< ParameterMapVectorType > m_BatchTransformParameterMapVectors;
+
+  std::vector< std::vector< double > >  m_MultiStartCandidates;
+  std::vector< double >                 m_MultiStartMetricValues;
+  unsigned int                          m_BestMultiStartCandidate;
+
   std::string             m_OutputDirectory;
   std::string             m_LogFileName;
 
   bool                    m_LogToFile;
   bool                    m_LogToConsole;
+  bool                    m_LogToMemory;
+  ElastixLogBuffer        m_Log;
+  std::vector< std::vector< double > > m_IterationTable;
+  bool                    m_ComputeResultImage;
+
+  // The SimpleElastix that owns this implementation and receives observers. Batch jobs have none.
+  // The active filter is set while the log of a registration is followed.
+  SimpleElastix*          m_ProcessObject;
+  itk::ProcessObject*     m_ActiveElastixFilter;
+  std::vector< std::vector< unsigned int > > m_MaximumNumberOfIterations;
+  unsigned int            m_CurrentParameterMap;
+  unsigned int            m_CurrentLevel;
+  unsigned int            m_OptimizerIteration;
+  double                  m_MetricValue;
+  bool                    m_HasStartedResolution;
+  bool                    m_IsInIterationTable;
+  unsigned int            m_MetricColumn;
+  int                     m_StepSizeColumn;
+  int                     m_ExactMetricColumn;
+  double                  m_ExactMetricValue;
+  bool                    m_Aborted;
+
+  // Set by SimpleElastixFuture::Cancel() for a job that is waiting or running, from another thread
+  bool                     m_AbortRequested;
+  itk::SimpleFastMutexLock m_AbortRequestedMutex;
+
+};
+
+// A registration started with ExecuteAsync(). It is referenced by its SimpleElastixFuture handles and,
+// until it has run, by the queue of the executor, and deleted with the last reference. The status and
+// results are guarded by the mutex of the executor.
+struct SimpleElastix::AsyncJob
+  : public itk::LightObject
+{
+  typedef SimpleElastix::SimpleElastixImpl          RegistrationType;
+  typedef SimpleElastix::ParameterMapVectorType     ParameterMapVectorType;
+
+  enum StatusType { Queued, Running, Finished, Cancelled };
+
+  AsyncJob( RegistrationType* registration );
+  ~AsyncJob( void );
+
+  bool IsDone( void );
+  bool IsCancelled( void );
+  void Wait( void );
+  bool WaitFor( const double seconds );
+  void Cancel( void );
+  Image GetResultImage( void );
+  ParameterMapVectorType GetTransformParameterMap( void );
+
+  // Worker threads are started on demand, up to the maximum number of workers, and exit when the
+  // queue is empty. Exited workers are joined when the next job is submitted.
+  struct Executor;
+  static Executor& GetExecutor( void );
+  static void Submit( AsyncJob* job );
+  static void Shutdown( void );
+  static void SetMaximumNumberOfWorkers( const unsigned int maximumNumberOfWorkers );
+  static unsigned int GetMaximumNumberOfWorkers( void );
+  static unsigned int GetNumberOfQueuedJobs( void );
+  static ITK_THREAD_RETURN_TYPE WorkerThreadCallback( void* arg );
+
+  RegistrationType*       Registration;
+  StatusType              Status;
+  Image                   ResultImage;
+  ParameterMapVectorType  TransformParameterMapVector;
+  std::string             ErrorMessage;
+
+private:
+
+  AsyncJob( const AsyncJob& );
+  void operator=( const AsyncJob& );
 
 };
 
+template<>
+inline void
+SimpleElastix::SimpleElastixImpl
+::RegisterDualExecuteInternal< 4 >( void )
+{
+  this->RegisterDualExecuteInternalForPixelType< float, 4 >();
+}
+
 } // end namespace simple
 } // end namespace itk
 
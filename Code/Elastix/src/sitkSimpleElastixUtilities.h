@@ -0,0 +1,630 @@
+#ifndef __sitksimpleelastixutilities_h_
+#define __sitksimpleelastixutilities_h_
+
+// SimpleITK
+#include "sitkMacro.h"
+#include "sitkExceptionObject.h"
+
+// ITK
+#include "itksys/SystemTools.hxx"
+#include "itkSimpleFastMutexLock.h"
+
+// elastix
+#include "elxElastixMain.h"
+#include "xoutmain.h"
+
+#if defined( _WIN32 )
+#include "itkWindows.h"
+#else
+#include <errno.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+// STL
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace itk {
+  namespace simple {
+
+/** \class ElastixScratchDirectory
+ * \brief Private, uniquely named directory for data that elastix and transformix
+ * only accept as files, such as point sets and initial transforms. It is removed
+ * with this object.
+ */
+class ElastixScratchDirectory
+{
+public:
+
+  ElastixScratchDirectory( void )
+  {
+    std::string temporaryDirectory;
+    const char* environmentVariables[] = { "TMPDIR", "TEMP", "TMP" };
+    for( unsigned int i = 0; i < 3 && temporaryDirectory.empty(); ++i )
+    {
+      itksys::SystemTools::GetEnv( environmentVariables[ i ], temporaryDirectory );
+    }
+
+    if( temporaryDirectory.empty() )
+    {
+#ifdef _WIN32
+      temporaryDirectory = ".";
+#else
+      temporaryDirectory = "/tmp";
+#endif
+    }
+
+    // The directory is created in a single call that fails if the name is taken, so two
+    // registrations that pick the same name never end up sharing a directory
+#if defined( _WIN32 )
+    for( unsigned int attempt = 0; attempt < 100; ++attempt )
+    {
+      std::ostringstream path;
+      path << temporaryDirectory << "/SimpleElastix-" << GetCurrentProcessId() << "-" << std::time( NULL ) << "-" << static_cast< const void* >( this ) << "-" << attempt;
+      if( CreateDirectoryA( path.str().c_str(), NULL ) )
+      {
+        this->m_Path = path.str();
+        return;
+      }
+
+      if( GetLastError() != ERROR_ALREADY_EXISTS )
+      {
+        break;
+      }
+    }
+#else
+    const std::string pathTemplate = temporaryDirectory + "/SimpleElastix-XXXXXX";
+    std::vector< char > path( pathTemplate.begin(), pathTemplate.end() );
+    path.push_back( '\0' );
+    if( mkdtemp( &path[ 0 ] ) != NULL )
+    {
+      this->m_Path = &path[ 0 ];
+      return;
+    }
+#endif
+
+    sitkExceptionMacro( "Could not create scratch directory in " << temporaryDirectory << "." );
+  }
+
+  ~ElastixScratchDirectory( void )
+  {
+    itksys::SystemTools::RemoveADirectory( this->m_Path.c_str() );
+  }
+
+  const std::string& GetPath( void ) const
+  {
+    return this->m_Path;
+  }
+
+  std::string GetFile( const std::string& fileName ) const
+  {
+    return this->m_Path + "/" + fileName;
+  }
+
+private:
+
+  ElastixScratchDirectory( const ElastixScratchDirectory& );
+  void operator=( const ElastixScratchDirectory& );
+
+  std::string m_Path;
+
+};
+
+/** \class ElastixProcessLock
+ * \brief Lets one elastix or transformix run at a time in the process for as long as it lives.
+ *
+ * elastix and transformix log through the global xout object, which every run sets up and tears
+ * down again, so runs in different threads would race on it and write into each other's logs. Work
+ * before and after a run, such as casting and masking the inputs, is not serialized.
+ */
+class ElastixProcessLock
+{
+public:
+
+  ElastixProcessLock( void )
+  {
+    GetMutex().Lock();
+  }
+
+  ~ElastixProcessLock( void )
+  {
+    GetMutex().Unlock();
+  }
+
+private:
+
+  ElastixProcessLock( const ElastixProcessLock& );
+  void operator=( const ElastixProcessLock& );
+
+  static itk::SimpleFastMutexLock& GetMutex( void )
+  {
+    static itk::SimpleFastMutexLock mutex;
+    return mutex;
+  }
+
+};
+
+/** \class ElastixConditionVariable
+ * \brief A mutex and a condition variable whose wait can time out.
+ *
+ * itk::ConditionVariable can only wait without limit, which SimpleElastixFuture::WaitFor() cannot
+ * use. Wait() and WaitFor() must be called with the mutex held, and hold it again when they return.
+ */
+class ElastixConditionVariable
+{
+public:
+
+  ElastixConditionVariable( void )
+  {
+#if defined( _WIN32 )
+    InitializeCriticalSection( &this->m_Mutex );
+    InitializeConditionVariable( &this->m_Condition );
+#else
+    pthread_mutex_init( &this->m_Mutex, NULL );
+    pthread_cond_init( &this->m_Condition, NULL );
+#endif
+  }
+
+  ~ElastixConditionVariable( void )
+  {
+#if defined( _WIN32 )
+    DeleteCriticalSection( &this->m_Mutex );
+#else
+    pthread_cond_destroy( &this->m_Condition );
+    pthread_mutex_destroy( &this->m_Mutex );
+#endif
+  }
+
+  void Lock( void )
+  {
+#if defined( _WIN32 )
+    EnterCriticalSection( &this->m_Mutex );
+#else
+    pthread_mutex_lock( &this->m_Mutex );
+#endif
+  }
+
+  void Unlock( void )
+  {
+#if defined( _WIN32 )
+    LeaveCriticalSection( &this->m_Mutex );
+#else
+    pthread_mutex_unlock( &this->m_Mutex );
+#endif
+  }
+
+  void Wait( void )
+  {
+#if defined( _WIN32 )
+    SleepConditionVariableCS( &this->m_Condition, &this->m_Mutex, INFINITE );
+#else
+    pthread_cond_wait( &this->m_Condition, &this->m_Mutex );
+#endif
+  }
+
+  /** Returns false if the time ran out. Like Wait(), it may also return early without a broadcast. */
+  bool WaitFor( const double seconds )
+  {
+#if defined( _WIN32 )
+    const DWORD milliseconds = static_cast< DWORD >( std::min( std::max( seconds, 0.0 ) * 1000.0, 4294967294.0 ) );
+    return SleepConditionVariableCS( &this->m_Condition, &this->m_Mutex, milliseconds ) != 0;
+#else
+    struct timeval now;
+    gettimeofday( &now, NULL );
+    const double endTime = now.tv_sec + now.tv_usec * 1e-6 + std::max( seconds, 0.0 );
+    struct timespec deadline;
+    deadline.tv_sec = static_cast< time_t >( endTime );
+    deadline.tv_nsec = std::min( static_cast< long >( ( endTime - deadline.tv_sec ) * 1e9 ), 999999999L );
+    return pthread_cond_timedwait( &this->m_Condition, &this->m_Mutex, &deadline ) != ETIMEDOUT;
+#endif
+  }
+
+  void Broadcast( void )
+  {
+#if defined( _WIN32 )
+    WakeAllConditionVariable( &this->m_Condition );
+#else
+    pthread_cond_broadcast( &this->m_Condition );
+#endif
+  }
+
+private:
+
+  ElastixConditionVariable( const ElastixConditionVariable& );
+  void operator=( const ElastixConditionVariable& );
+
+#if defined( _WIN32 )
+  CRITICAL_SECTION   m_Mutex;
+  CONDITION_VARIABLE m_Condition;
+#else
+  pthread_mutex_t    m_Mutex;
+  pthread_cond_t     m_Condition;
+#endif
+
+};
+
+/** Write points in elastix point set format ("point", number of points, one point per line). */
+inline void WriteElastixPointSetFile( const std::vector< std::vector< double > >& pointSet, const std::string& fileName )
+{
+  std::ostringstream buffer;
+  buffer.precision( 17 );
+  buffer << "point\n" << pointSet.size() << "\n";
+  for( unsigned int i = 0; i < pointSet.size(); ++i )
+  {
+    for( unsigned int j = 0; j < pointSet[ i ].size(); ++j )
+    {
+      buffer << ( j > 0 ? " " : "" ) << pointSet[ i ][ j ];
+    }
+    buffer << "\n";
+  }
+
+  std::ofstream pointSetFile( fileName.c_str(), std::ofstream::out | std::ofstream::binary );
+  if( !pointSetFile.is_open() )
+  {
+    sitkExceptionMacro( "Could not open " << fileName << " for writing." );
+  }
+
+  const std::string content = buffer.str();
+  pointSetFile.write( content.data(), content.size() );
+}
+
+/** Read the "OutputPoint" column of a transformix outputpoints.txt file. */
+inline std::vector< std::vector< double > > ReadTransformixOutputPointsFile( const std::string& fileName )
+{
+  std::ifstream outputPointsFile( fileName.c_str() );
+  if( !outputPointsFile.is_open() )
+  {
+    sitkExceptionMacro( "Could not open " << fileName << " for reading." );
+  }
+
+  const std::string key = "OutputPoint = [";
+  std::vector< std::vector< double > > pointSet;
+  std::string line;
+  while( std::getline( outputPointsFile, line ) )
+  {
+    const std::string::size_type begin = line.find( key );
+    if( begin == std::string::npos )
+    {
+      continue;
+    }
+
+    const std::string::size_type end = line.find( "]", begin );
+    std::istringstream coordinates( line.substr( begin + key.size(), end - begin - key.size() ) );
+    std::vector< double > point;
+    double coordinate;
+    while( coordinates >> coordinate )
+    {
+      point.push_back( coordinate );
+    }
+
+    pointSet.push_back( point );
+  }
+
+  return pointSet;
+}
+
+/** Split a contiguous array of coordinates (x0, y0, z0, x1, y1, z1, ...) into points. */
+inline std::vector< std::vector< double > > MakeElastixPointSet( const std::vector< double >& coordinates, const unsigned int dimension )
+{
+  if( dimension == 0 || coordinates.size() % dimension != 0 )
+  {
+    sitkExceptionMacro( "Number of coordinates (" << coordinates.size() << ") is not a multiple of the point dimension (" << dimension << ")." );
+  }
+
+  std::vector< std::vector< double > > pointSet( coordinates.size() / dimension );
+  for( unsigned int i = 0; i < pointSet.size(); ++i )
+  {
+    pointSet[ i ].assign( coordinates.begin() + i * dimension, coordinates.begin() + ( i + 1 ) * dimension );
+  }
+
+  return pointSet;
+}
+
+/** Shortest of %.15g and %.17g that reads back as the same double. */
+inline std::string FormatElastixParameterValue( const double value )
+{
+  char buffer[ 32 ];
+  std::sprintf( buffer, "%.15g", value );
+  if( std::strtod( buffer, NULL ) != value )
+  {
+    std::sprintf( buffer, "%.17g", value );
+  }
+
+  return buffer;
+}
+
+/** \class ElastixLogListener
+ * \brief Receives the log of elastix line by line, in the thread that runs elastix.
+ */
+class ElastixLogListener
+{
+public:
+
+  virtual ~ElastixLogListener( void ) {}
+
+  virtual void OnElastixLogLine( const std::string& line ) = 0;
+
+};
+
+/** \class ElastixLogFile
+ * \brief Log file of a single run of elastix or transformix, read back for LogToMemory.
+ *
+ * elastix writes its log file to its output directory, and runs are serialized (see
+ * ElastixProcessLock), so the file holds the log of this run only and std::cout is left alone.
+ * The user's log file is read when LogToFile is on. Otherwise the log is written under a unique
+ * name to the output directory and removed with this object, or to a private directory when there
+ * is no output directory.
+ */
+class ElastixLogFile
+{
+public:
+
+  ElastixLogFile( const std::string& outputDirectory, const bool logToFile, const std::string& logFileName, const std::string& defaultLogFileName )
+    : m_ScratchDirectory( NULL ), m_OutputDirectory( outputDirectory ), m_LogFileName( logFileName ), m_RemoveLogFile( false )
+  {
+    if( logToFile )
+    {
+      if( this->m_LogFileName.empty() )
+      {
+        this->m_LogFileName = defaultLogFileName;
+      }
+
+      return;
+    }
+
+    this->m_ScratchDirectory = new ElastixScratchDirectory();
+    if( this->m_OutputDirectory.empty() )
+    {
+      this->m_OutputDirectory = this->m_ScratchDirectory->GetPath();
+      this->m_LogFileName = defaultLogFileName;
+    }
+    else
+    {
+      // The name of the private directory is unique among concurrent runs
+      this->m_LogFileName = itksys::SystemTools::GetFilenameName( this->m_ScratchDirectory->GetPath() ) + ".log";
+      this->m_RemoveLogFile = true;
+    }
+  }
+
+  ~ElastixLogFile( void )
+  {
+    if( this->m_RemoveLogFile )
+    {
+      itksys::SystemTools::RemoveFile( this->GetPath().c_str() );
+    }
+
+    delete this->m_ScratchDirectory;
+  }
+
+  /** Output directory and log file name to give to elastix, which logs to a file */
+  const std::string& GetOutputDirectory( void ) const
+  {
+    return this->m_OutputDirectory;
+  }
+
+  const std::string& GetLogFileName( void ) const
+  {
+    return this->m_LogFileName;
+  }
+
+  std::string GetPath( void ) const
+  {
+    return this->m_OutputDirectory + "/" + this->m_LogFileName;
+  }
+
+  /** Hand the lines of the log to the listener once elastix is done */
+  void Replay( ElastixLogListener* listener ) const
+  {
+    std::ifstream logFile( this->GetPath().c_str() );
+    std::string line;
+    while( std::getline( logFile, line ) )
+    {
+      if( !line.empty() && line[ line.size() - 1 ] == '\r' )
+      {
+        line.erase( line.size() - 1 );
+      }
+
+      listener->OnElastixLogLine( line );
+    }
+  }
+
+private:
+
+  ElastixLogFile( const ElastixLogFile& );
+  void operator=( const ElastixLogFile& );
+
+  ElastixScratchDirectory* m_ScratchDirectory;
+  std::string              m_OutputDirectory;
+  std::string              m_LogFileName;
+  bool                     m_RemoveLogFile;
+
+};
+
+/** \class ElastixLogBuffer
+ * \brief The most recent lines of a log, held in memory up to a maximum number of bytes.
+ *
+ * Lines that do not fit anymore are dropped from the front, so a long registration keeps the end
+ * of its log, which holds the final metric values and any error message.
+ */
+class ElastixLogBuffer
+{
+public:
+
+  ElastixLogBuffer( void ) : m_Size( 0 ), m_MaximumSize( 1024u * 1024u ) {}
+
+  void AddLine( const std::string& line )
+  {
+    this->m_Lines.push_back( line );
+    this->m_Size += line.size() + 1;
+    this->Trim();
+  }
+
+  std::string GetLog( void ) const
+  {
+    std::string log;
+    log.reserve( this->m_Size );
+    for( std::deque< std::string >::const_iterator it = this->m_Lines.begin(); it != this->m_Lines.end(); ++it )
+    {
+      log += *it;
+      log += '\n';
+    }
+
+    return log;
+  }
+
+  void Clear( void )
+  {
+    this->m_Lines.clear();
+    this->m_Size = 0;
+  }
+
+  void SetMaximumSize( const size_t maximumSize )
+  {
+    this->m_MaximumSize = maximumSize;
+    this->Trim();
+  }
+
+  size_t GetMaximumSize( void ) const
+  {
+    return this->m_MaximumSize;
+  }
+
+private:
+
+  void Trim( void )
+  {
+    while( this->m_Size > this->m_MaximumSize )
+    {
+      this->m_Size -= this->m_Lines.front().size() + 1;
+      this->m_Lines.pop_front();
+    }
+  }
+
+  std::deque< std::string > m_Lines;
+  size_t                    m_Size;
+  size_t                    m_MaximumSize;
+
+};
+
+/** \class ElastixLogTarget
+ * \brief Adds a stream that hands the log of elastix to a listener, line by line, to the outputs of
+ * xout for as long as the object lives.
+ *
+ * elastix copies the outputs of xout to its standard, warning, error and iteration cells when a run
+ * sets up its log, so the target must be added before the run starts. Runs are serialized (see
+ * ElastixProcessLock), so the target receives the log of one run only. The console and the log file
+ * of elastix are left alone. Exceptions thrown by the listener pass through this stream into the code
+ * that wrote the line, which lets a listener stop a running registration.
+ */
+class ElastixLogTarget
+{
+public:
+
+  explicit ElastixLogTarget( ElastixLogListener* listener )
+    : m_Buffer( listener ), m_Stream( &m_Buffer )
+  {
+    // xout only exists once a run has set it up. Outputs that are set up again replace themselves.
+    static bool isSetUp = false;
+    if( !isSetUp )
+    {
+      elastix::xoutSetup( "", false, false );
+      isSetUp = true;
+    }
+
+    this->m_Stream.exceptions( std::ios::badbit );
+    xl::xout.AddOutput( GetName(), &this->m_Stream );
+  }
+
+  ~ElastixLogTarget( void )
+  {
+    // The iteration cell is given the outputs of xout anew by each registration
+    const char* cells[] = { "standard", "warning", "error" };
+    for( unsigned int i = 0; i < sizeof( cells ) / sizeof( cells[ 0 ] ); ++i )
+    {
+      xl::xout[ cells[ i ] ].RemoveOutput( GetName() );
+    }
+
+    xl::xout.RemoveOutput( GetName() );
+  }
+
+private:
+
+  ElastixLogTarget( const ElastixLogTarget& );
+  void operator=( const ElastixLogTarget& );
+
+  static const char* GetName( void )
+  {
+    return "SimpleElastix";
+  }
+
+  class Buffer : public std::streambuf
+  {
+  public:
+
+    explicit Buffer( ElastixLogListener* listener ) : m_Listener( listener ) {}
+
+  protected:
+
+    virtual int overflow( int c )
+    {
+      if( c != traits_type::eof() )
+      {
+        const char character = traits_type::to_char_type( c );
+        this->Write( &character, 1 );
+      }
+
+      return traits_type::not_eof( c );
+    }
+
+    virtual std::streamsize xsputn( const char* s, std::streamsize n )
+    {
+      this->Write( s, n );
+      return n;
+    }
+
+  private:
+
+    void Write( const char* s, std::streamsize n )
+    {
+      for( std::streamsize i = 0; i < n; ++i )
+      {
+        if( s[ i ] == '\n' )
+        {
+          std::string line;
+          line.swap( this->m_Line );
+          this->m_Listener->OnElastixLogLine( line );
+        }
+        else
+        {
+          this->m_Line += s[ i ];
+        }
+      }
+    }
+
+    ElastixLogListener* m_Listener;
+    std::string         m_Line;
+
+  };
+
+  Buffer       m_Buffer;
+  std::ostream m_Stream;
+
+};
+
+} // end namespace simple
+} // end namespace itk
+
+#endif // __sitksimpleelastixutilities_h_
@@ -3,12 +3,13 @@
 
 #include "sitkSimpleTransformix.h"
 #include "sitkSimpleTransformixImpl.h"
+#include "sitkSimpleElastixUtilities.h"
 
 namespace itk {
   namespace simple {
 
 SimpleTransformix
-::SimpleTransformix( void ) : m_Pimple( new SimpleTransformixImpl )
+::SimpleTransformix( void ) : m_Pimple( new SimpleTransformixImpl( this ) )
 {
 }
 
@@ -19,9 +20,9 @@ SimpleTransformix
   m_Pimple = NULL;
 }
 
-const std::string 
+std::string 
 SimpleTransformix
-::GetName( void )
+::GetName( void ) const
 { 
   return this->m_Pimple->GetName();
 }
@@ -72,6 +73,37 @@ SimpleTransformix
   return *this;
 }
 
+SimpleTransformix::Self&
+SimpleTransformix
+::SetFixedPointSet( const std::vector< std::vector< double > >& fixedPointSet )
+{
+  this->m_Pimple->SetFixedPointSet( fixedPointSet );
+  return *this;
+}
+
+SimpleTransformix::Self&
+SimpleTransformix
+::SetFixedPointSet( const std::vector< double >& fixedPointSet, const unsigned int dimension )
+{
+  this->m_Pimple->SetFixedPointSet( MakeElastixPointSet( fixedPointSet, dimension ) );
+  return *this;
+}
+
+std::vector< std::vector< double > >
+SimpleTransformix
+::GetFixedPointSet( void )
+{
+  return this->m_Pimple->GetFixedPointSet();
+}
+
+SimpleTransformix::Self&
+SimpleTransformix
+::RemoveFixedPointSet( void )
+{
+  this->m_Pimple->RemoveFixedPointSet();
+  return *this;
+}
+
 SimpleTransformix::Self&
 SimpleTransformix
 ::SetComputeSpatialJacobian( const bool computeSpatialJacobian )
@@ -275,7 +307,60 @@ SimpleTransformix
 
 SimpleTransformix::Self&
 SimpleTransformix
-::SetTransformParameterMap( const ParameterMapVectorType transformParameterMapVector )
+::SetLogToMemory( const bool logToMemory )
+{
+  this->m_Pimple->SetLogToMemory( logToMemory );
+  return *this;
+}
+
+bool
+SimpleTransformix
+::GetLogToMemory( void )
+{
+  return this->m_Pimple->GetLogToMemory();
+}
+
+SimpleTransformix::Self&
+SimpleTransformix
+::LogToMemoryOn( void )
+{
+  this->m_Pimple->LogToMemoryOn();
+  return *this;
+}
+
+SimpleTransformix::Self&
+SimpleTransformix
+::LogToMemoryOff( void )
+{
+  this->m_Pimple->LogToMemoryOff();
+  return *this;
+}
+
+SimpleTransformix::Self&
+SimpleTransformix
+::SetMaximumLogSize( const unsigned int maximumLogSize )
+{
+  this->m_Pimple->SetMaximumLogSize( maximumLogSize );
+  return *this;
+}
+
+unsigned int
+SimpleTransformix
+::GetMaximumLogSize( void )
+{
+  return this->m_Pimple->GetMaximumLogSize();
+}
+
+std::string
+SimpleTransformix
+::GetLog( void )
+{
+  return this->m_Pimple->GetLog();
+}
+
+SimpleTransformix::Self&
+SimpleTransformix
+::SetTransformParameterMap( const ParameterMapVectorType& transformParameterMapVector )
 {
   this->m_Pimple->SetTransformParameterMap( transformParameterMapVector );
   return *this;
@@ -283,7 +368,7 @@ SimpleTransformix
 
 SimpleTransformix::Self&
 SimpleTransformix
-::SetTransformParameterMap( const ParameterMapType transformParameterMap )
+::SetTransformParameterMap( const ParameterMapType& transformParameterMap )
 {
   this->m_Pimple->SetTransformParameterMap( transformParameterMap );
   return *this;
@@ -291,7 +376,7 @@ SimpleTransformix
 
 SimpleTransformix::Self&
 SimpleTransformix
-::AddTransformParameterMap( const ParameterMapType transformParameterMap )
+::AddTransformParameterMap( const ParameterMapType& transformParameterMap )
 {
   this->m_Pimple->AddTransformParameterMap( transformParameterMap );
   return *this;
@@ -398,7 +483,7 @@ SimpleTransformix
 
 SimpleTransformix::Self&
 SimpleTransformix
-::WriteParameterFile( const ParameterMapType parameterMap, const std::string parameterFileName )
+::WriteParameterFile( const ParameterMapType& parameterMap, const std::string parameterFileName )
 {
   this->m_Pimple->WriteParameterFile( parameterMap, parameterFileName );
   return *this;
@@ -435,6 +520,28 @@ SimpleTransformix
   return this->m_Pimple->Execute();
 }
 
+SimpleTransformix::VectorOfImage
+SimpleTransformix
+::Execute( const VectorOfImage& movingImages )
+{
+  return this->m_Pimple->Execute( movingImages );
+}
+
+SimpleTransformix::VectorOfImage
+SimpleTransformix
+::Execute( const VectorOfImage& movingImages, const std::vector< unsigned int >& finalBSplineInterpolationOrders, const std::vector< double >& defaultPixelValues )
+{
+  return this->m_Pimple->Execute( movingImages, finalBSplineInterpolationOrders, defaultPixelValues );
+}
+
+SimpleTransformix::Self&
+SimpleTransformix
+::ExecuteToFile( const std::string movingImageFileName, const std::string resultImageFileName, const unsigned int numberOfTiles )
+{
+  this->m_Pimple->ExecuteToFile( movingImageFileName, resultImageFileName, numberOfTiles );
+  return *this;
+}
+
 Image
 SimpleTransformix
 ::GetResultImage( void )
@@ -442,6 +549,41 @@ SimpleTransformix
   return this->m_Pimple->GetResultImage();
 }
 
+std::vector< std::vector< double > >
+SimpleTransformix
+::GetTransformedPoints( void )
+{
+  return this->m_Pimple->GetTransformedPoints();
+}
+
+Image
+SimpleTransformix
+::GetDeformationField( void )
+{
+  return this->m_Pimple->GetDeformationField();
+}
+
+Image
+SimpleTransformix
+::GetSpatialJacobian( void )
+{
+  return this->m_Pimple->GetSpatialJacobian();
+}
+
+Image
+SimpleTransformix
+::GetDeterminantOfSpatialJacobian( void )
+{
+  return this->m_Pimple->GetDeterminantOfSpatialJacobian();
+}
+
+Transform
+SimpleTransformix
+::GetTransform( void )
+{
+  return this->m_Pimple->GetTransform();
+}
+
 /**
  * Procedural interface 
  */
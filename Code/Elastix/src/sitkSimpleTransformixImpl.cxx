@@ -4,12 +4,43 @@
 #include "sitkSimpleTransformix.h"
 #include "sitkSimpleTransformixImpl.h"
 #include "sitkCastImageFilter.h"
+#include "sitkResampleImageFilter.h"
+#include "sitkImageFileReader.h"
+#include "sitkDisplacementFieldTransform.h"
+#include "sitkTranslationTransform.h"
+#include "sitkEuler2DTransform.h"
+#include "sitkEuler3DTransform.h"
+#include "sitkSimilarity2DTransform.h"
+#include "sitkSimilarity3DTransform.h"
+#include "sitkAffineTransform.h"
+#include "sitkBSplineTransform.h"
+#include "sitkTransformToDisplacementFieldFilter.h"
+#include "sitkAddImageFilter.h"
+#include "sitkSimpleElastixUtilities.h"
+
+#include "itkBSplineDerivativeKernelFunction.h"
+#include "itkBSplineKernelFunction.h"
+#include "itkBSplineTransform.h"
+#include "itkCompositeTransform.h"
+#include "itkImageFileReader.h"
+#include "itkImageIOFactory.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionSplitterSlowDimension.h"
+#include "itkVectorImage.h"
+#include "vnl/vnl_det.h"
+#include "vnl/vnl_math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <set>
 
 namespace itk {
   namespace simple {
 
 SimpleTransformix::SimpleTransformixImpl
-::SimpleTransformixImpl( void )
+::SimpleTransformixImpl( SimpleTransformix* processObject )
 {
   // Register this class with SimpleITK
   this->m_MemberFactory.reset( new detail::MemberFunctionFactory< MemberFunctionType >( this ) );
@@ -29,12 +60,24 @@ SimpleTransformix::SimpleTransformixImpl
   this->m_ComputeDeterminantOfSpatialJacobian = false;
   this->m_ComputeDeformationField = false;
   this->m_MovingPointSetFileName = "";
+  this->m_FixedPointSet = PointSetType();
+  this->m_TransformedPointSet = PointSetType();
+
+  this->m_DeformationField = Image();
+  this->m_SpatialJacobian = Image();
+  this->m_DeterminantOfSpatialJacobian = Image();
+
+  this->ClearDeformationFieldCache();
 
   this->m_OutputDirectory = "";
   this->m_LogFileName = "";
   
   this->m_LogToFile = "";
   this->m_LogToConsole = "";
+  this->m_LogToMemory = false;
+
+  this->m_ProcessObject = processObject;
+  this->m_NumberOfThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
 }
 
 SimpleTransformix::SimpleTransformixImpl
@@ -47,7 +90,18 @@ SimpleTransformix::SimpleTransformixImpl
 ::Execute( void )
 {
   const PixelIDValueEnum MovingImagePixelEnum = this->m_MovingImage.GetPixelID();
-  const unsigned int MovingImageDimension = this->m_MovingImage.GetDimension();
+  unsigned int MovingImageDimension = this->m_MovingImage.GetDimension();
+
+  // Without a moving image the transform is instantiated from the dimension of the points
+  // or, when only outputs such as the deformation field are requested, of the transform
+  if( this->IsEmpty( this->m_MovingImage ) && this->m_FixedPointSet.size() > 0 )
+  {
+    MovingImageDimension = this->m_FixedPointSet[ 0 ].size();
+  }
+  else if( this->IsEmpty( this->m_MovingImage ) && this->GetNumberOfTransformParameterMaps() > 0 )
+  {
+    MovingImageDimension = this->GetTransformParameterAsUnsignedInt( "FixedImageDimension", MovingImageDimension );
+  }
 
   if( this->m_MemberFactory->HasMemberFunction( sitkFloat32, MovingImageDimension ) )
   {
@@ -76,16 +130,56 @@ SimpleTransformix::SimpleTransformixImpl
       transformixFilter->SetMovingImage( itkDynamicCastInDebugMode< TMovingImage* >( Cast( this->GetMovingImage(), static_cast< PixelIDValueEnum >( GetPixelIDValueFromElastixString( "float" ) ) ).GetITKBase() ) );
     }
 
+    // The deformation field and the spatial Jacobians are computed from the transform in memory.
+    // Only transforms that GetTransform() cannot convert are left to transformix, which hands these
+    // outputs over in files.
+    const bool computeOutputFields = this->GetComputeDeformationField() || this->GetComputeSpatialJacobian() || this->GetComputeDeterminantOfSpatialJacobian();
+    Transform transform;
+    bool computeOutputFieldsInMemory = false;
+    if( computeOutputFields )
+    {
+      try
+      {
+        transform = this->GetTransform();
+        computeOutputFieldsInMemory = true;
+      }
+      catch( GenericException & )
+      {
+        computeOutputFieldsInMemory = false;
+      }
+    }
+
     transformixFilter->SetFixedPointSetFileName( this->GetFixedPointSetFileName() );
-    transformixFilter->SetComputeSpatialJacobian( this->GetComputeSpatialJacobian() );
-    transformixFilter->SetComputeDeterminantOfSpatialJacobian( this->GetComputeDeterminantOfSpatialJacobian() );
-    transformixFilter->SetComputeDeformationField( this->GetComputeDeformationField() );
+    transformixFilter->SetComputeSpatialJacobian( this->GetComputeSpatialJacobian() && !computeOutputFieldsInMemory );
+    transformixFilter->SetComputeDeterminantOfSpatialJacobian( this->GetComputeDeterminantOfSpatialJacobian() && !computeOutputFieldsInMemory );
+    transformixFilter->SetComputeDeformationField( this->GetComputeDeformationField() && !computeOutputFieldsInMemory );
 
     transformixFilter->SetOutputDirectory( this->GetOutputDirectory() );
     transformixFilter->SetLogFileName( this->GetLogFileName() );
     transformixFilter->SetLogToFile( this->GetLogToFile() );
     transformixFilter->SetLogToConsole( this->GetLogToConsole() );
 
+    // In-memory points, outputpoints.txt and, without an output directory, output fields of
+    // transformix are passed as files
+    std::string outputDirectory = this->GetOutputDirectory();
+    nsstd::auto_ptr< ElastixScratchDirectory > scratchDirectory;
+    if( this->m_FixedPointSet.size() > 0 || ( computeOutputFields && !computeOutputFieldsInMemory && outputDirectory.empty() ) )
+    {
+      scratchDirectory.reset( new ElastixScratchDirectory() );
+    }
+
+    if( this->m_FixedPointSet.size() > 0 )
+    {
+      WriteElastixPointSetFile( this->m_FixedPointSet, scratchDirectory->GetFile( "fixedPointSet.pts" ) );
+      transformixFilter->SetFixedPointSetFileName( scratchDirectory->GetFile( "fixedPointSet.pts" ) );
+    }
+
+    if( scratchDirectory.get() )
+    {
+      outputDirectory = scratchDirectory->GetPath();
+      transformixFilter->SetOutputDirectory( outputDirectory );
+    }
+
     ParameterMapVectorType transformParameterMapVector = this->m_TransformParameterMapVector;
     for( unsigned int i = 0; i < transformParameterMapVector.size(); i++ )
     {
@@ -96,12 +190,94 @@ SimpleTransformix::SimpleTransformixImpl
     ParameterObjectPointer parameterObject = ParameterObjectType::New();
     parameterObject->SetParameterMap( transformParameterMapVector );
     transformixFilter->SetTransformParameterObject( parameterObject );
-    transformixFilter->Update();
+
+    transformixFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
+
+    // transformix has no iterations; observers receive the start, end and progress events of the filter
+    if( this->m_ProcessObject )
+    {
+      this->m_ProcessObject->PreUpdate( transformixFilter.GetPointer() );
+    }
+
+    // transformix is not needed when only output fields are requested and they are computed here
+    this->m_Log.Clear();
+    if( !computeOutputFieldsInMemory || !this->IsEmpty( this->m_MovingImage ) || !this->GetFixedPointSetFileName().empty() || this->m_FixedPointSet.size() > 0 )
+    {
+      // Runs of elastix and transformix in other threads wait here (see ElastixProcessLock)
+      ElastixProcessLock processLock;
+
+      // The in-memory log is read back from the log file of this run (see ElastixLogFile)
+      nsstd::auto_ptr< ElastixLogFile > memoryLogFile;
+      if( this->m_LogToMemory )
+      {
+        memoryLogFile.reset( new ElastixLogFile( outputDirectory, this->GetLogToFile(), this->GetLogFileName(), "transformix.log" ) );
+        transformixFilter->SetOutputDirectory( memoryLogFile->GetOutputDirectory() );
+        transformixFilter->SetLogFileName( memoryLogFile->GetLogFileName() );
+        transformixFilter->SetLogToFile( true );
+      }
+
+      transformixFilter->Update();
+
+      if( memoryLogFile.get() )
+      {
+        memoryLogFile->Replay( this );
+      }
+    }
 
     if( !this->IsEmpty( this->GetMovingImage() ) )
     {
-      this->m_ResultImage = Image( itkDynamicCastInDebugMode< TMovingImage * >( transformixFilter->GetOutput() ) );
-      this->m_ResultImage.MakeUnique();
+      // Take ownership of the output instead of copying it (see SimpleElastix)
+      typename TMovingImage::Pointer resultImage = itkDynamicCastInDebugMode< TMovingImage * >( transformixFilter->GetOutput() );
+      resultImage->DisconnectPipeline();
+      this->m_ResultImage = Image( resultImage );
+    }
+
+    this->m_TransformedPointSet = PointSetType();
+    if( this->m_FixedPointSet.size() > 0 )
+    {
+      this->m_TransformedPointSet = ReadTransformixOutputPointsFile( scratchDirectory->GetFile( "outputpoints.txt" ) );
+    }
+
+    this->m_DeformationField = Image();
+    this->m_SpatialJacobian = Image();
+    this->m_DeterminantOfSpatialJacobian = Image();
+
+    if( computeOutputFieldsInMemory )
+    {
+      // transformix writes the deformation field with float components
+      if( this->GetComputeDeformationField() )
+      {
+        this->m_DeformationField = this->ComputeDeformationField( transform, sitkVectorFloat32 );
+      }
+
+      if( this->GetComputeSpatialJacobian() || this->GetComputeDeterminantOfSpatialJacobian() )
+      {
+        this->ComputeSpatialJacobianInternal< TMovingImage::ImageDimension >( transform );
+      }
+    }
+    else if( computeOutputFields )
+    {
+      // transformix names these outputs after the result image format of the last transform parameter map
+      std::string resultImageFormat = "mhd";
+      if( transformParameterMapVector.size() > 0 && transformParameterMapVector.back().count( "ResultImageFormat" ) > 0 && transformParameterMapVector.back()[ "ResultImageFormat" ].size() > 0 )
+      {
+        resultImageFormat = transformParameterMapVector.back()[ "ResultImageFormat" ][ 0 ];
+      }
+
+      if( this->GetComputeDeformationField() )
+      {
+        this->m_DeformationField = ReadImage( outputDirectory + "/deformationField." + resultImageFormat );
+      }
+
+      if( this->GetComputeSpatialJacobian() )
+      {
+        this->m_SpatialJacobian = ReadImage( outputDirectory + "/fullSpatialJacobian." + resultImageFormat );
+      }
+
+      if( this->GetComputeDeterminantOfSpatialJacobian() )
+      {
+        this->m_DeterminantOfSpatialJacobian = ReadImage( outputDirectory + "/spatialJacobian." + resultImageFormat );
+      }
     }
   }
   catch( itk::ExceptionObject &e )
@@ -112,9 +288,899 @@ SimpleTransformix::SimpleTransformixImpl
   return this->m_ResultImage;
 }
 
+namespace
+{
+
+// Spatial Jacobian of a B-spline transform, differentiated through the B-spline kernel, since
+// ITK does not implement ComputeJacobianWithRespectToPosition() for B-spline transforms
+template< unsigned int VDimension, unsigned int VSplineOrder >
+class BSplineSpatialJacobian
+{
+public:
+  typedef itk::Transform< double, VDimension, VDimension >          ITKTransformType;
+  typedef itk::BSplineTransform< double, VDimension, VSplineOrder > BSplineTransformType;
+  typedef typename BSplineTransformType::ImageType                  CoefficientImageType;
+  typedef vnl_matrix_fixed< double, VDimension, VDimension >        MatrixType;
+
+  BSplineSpatialJacobian( void )
+  {
+    this->m_Kernel = itk::BSplineKernelFunction< VSplineOrder >::New();
+    this->m_DerivativeKernel = itk::BSplineDerivativeKernelFunction< VSplineOrder >::New();
+  }
+
+  static bool IsBSplineTransform( const ITKTransformType* transform )
+  {
+    return dynamic_cast< const BSplineTransformType* >( transform ) != NULL;
+  }
+
+  void Compute( const ITKTransformType* transform, const typename ITKTransformType::InputPointType& point, MatrixType& jacobian ) const
+  {
+    const typename BSplineTransformType::CoefficientImageArray coefficientImages = static_cast< const BSplineTransformType* >( transform )->GetCoefficientImages();
+    itk::ContinuousIndex< double, VDimension > gridIndex;
+    coefficientImages[ 0 ]->TransformPhysicalPointToContinuousIndex( point, gridIndex );
+
+    // Where the support of a point does not lie within the grid, BSplineTransform does not displace it
+    jacobian.set_identity();
+    const typename CoefficientImageType::SizeType gridSize = coefficientImages[ 0 ]->GetLargestPossibleRegion().GetSize();
+    const double halfSupport = 0.5 * static_cast< double >( VSplineOrder - 1 );
+    typename CoefficientImageType::IndexType startIndex;
+    vnl_matrix_fixed< double, VDimension, VSplineOrder + 1 > weights;
+    vnl_matrix_fixed< double, VDimension, VSplineOrder + 1 > derivativeWeights;
+    for( unsigned int i = 0; i < VDimension; ++i )
+    {
+      if( gridIndex[ i ] < halfSupport || gridIndex[ i ] >= static_cast< double >( gridSize[ i ] ) - halfSupport - 1.0 )
+      {
+        return;
+      }
+
+      startIndex[ i ] = static_cast< itk::IndexValueType >( std::floor( gridIndex[ i ] - halfSupport ) );
+      for( unsigned int k = 0; k <= VSplineOrder; ++k )
+      {
+        const double u = gridIndex[ i ] - static_cast< double >( startIndex[ i ] + k );
+        weights( i, k ) = this->m_Kernel->Evaluate( u );
+        derivativeWeights( i, k ) = this->m_DerivativeKernel->Evaluate( u );
+      }
+    }
+
+    // Derivatives of the displacement with respect to the grid index, summed over the support
+    MatrixType displacementDerivative;
+    displacementDerivative.fill( 0.0 );
+    std::vector< unsigned int > supportIndex( VDimension, 0 );
+    bool isSupportDone = false;
+    while( !isSupportDone )
+    {
+      typename CoefficientImageType::IndexType coefficientIndex;
+      for( unsigned int i = 0; i < VDimension; ++i )
+      {
+        coefficientIndex[ i ] = startIndex[ i ] + supportIndex[ i ];
+      }
+
+      for( unsigned int j = 0; j < VDimension; ++j )
+      {
+        double weight = 1.0;
+        for( unsigned int i = 0; i < VDimension; ++i )
+        {
+          weight *= i == j ? derivativeWeights( i, supportIndex[ i ] ) : weights( i, supportIndex[ i ] );
+        }
+
+        for( unsigned int i = 0; i < VDimension; ++i )
+        {
+          displacementDerivative( i, j ) += weight * coefficientImages[ i ]->GetPixel( coefficientIndex );
+        }
+      }
+
+      isSupportDone = true;
+      for( unsigned int i = 0; i < VDimension && isSupportDone; ++i )
+      {
+        if( supportIndex[ i ] < VSplineOrder )
+        {
+          ++supportIndex[ i ];
+          isSupportDone = false;
+        }
+        else
+        {
+          supportIndex[ i ] = 0;
+        }
+      }
+    }
+
+    // Chain rule through the mapping of physical points to grid indices
+    jacobian += displacementDerivative * coefficientImages[ 0 ]->GetPhysicalPointToIndex().GetVnlMatrix();
+  }
+
+private:
+  typename itk::BSplineKernelFunction< VSplineOrder >::Pointer           m_Kernel;
+  typename itk::BSplineDerivativeKernelFunction< VSplineOrder >::Pointer m_DerivativeKernel;
+};
+
+// Computes the spatial Jacobian of a transform on a grid, region by region in threads
+template< unsigned int VDimension >
+class SpatialJacobianThreadData
+{
+public:
+  typedef itk::Transform< double, VDimension, VDimension >   ITKTransformType;
+  typedef itk::CompositeTransform< double, VDimension >      CompositeTransformType;
+  typedef typename ITKTransformType::InputPointType          PointType;
+  typedef itk::Image< float, VDimension >                    DeterminantImageType;
+  typedef itk::VectorImage< float, VDimension >              SpatialJacobianImageType;
+  typedef vnl_matrix_fixed< double, VDimension, VDimension > MatrixType;
+
+  enum DerivativeEnum { Analytic, LinearBSpline, QuadraticBSpline, CubicBSpline, CentralDifference };
+
+  SpatialJacobianThreadData( const ITKTransformType* transform, const PointType& point, const double step )
+  {
+    this->Step = step;
+    this->AddTransform( transform );
+
+    // Transforms that do not implement ComputeJacobianWithRespectToPosition() throw, which is found out once
+    typename ITKTransformType::JacobianType jacobian;
+    for( unsigned int n = 0; n < this->Transforms.size(); ++n )
+    {
+      if( BSplineSpatialJacobian< VDimension, 1 >::IsBSplineTransform( this->Transforms[ n ] ) )
+      {
+        this->Derivatives.push_back( LinearBSpline );
+      }
+      else if( BSplineSpatialJacobian< VDimension, 2 >::IsBSplineTransform( this->Transforms[ n ] ) )
+      {
+        this->Derivatives.push_back( QuadraticBSpline );
+      }
+      else if( BSplineSpatialJacobian< VDimension, 3 >::IsBSplineTransform( this->Transforms[ n ] ) )
+      {
+        this->Derivatives.push_back( CubicBSpline );
+      }
+      else
+      {
+        try
+        {
+          this->Transforms[ n ]->ComputeJacobianWithRespectToPosition( point, jacobian );
+          this->Derivatives.push_back( Analytic );
+        }
+        catch( itk::ExceptionObject & )
+        {
+          this->Derivatives.push_back( CentralDifference );
+        }
+      }
+    }
+  }
+
+  // The Jacobian of a chain of transforms is the product of their Jacobians at the points that they map
+  void Compute( PointType point, MatrixType& jacobian ) const
+  {
+    jacobian.set_identity();
+    MatrixType transformJacobian;
+    typename ITKTransformType::JacobianType analyticJacobian;
+    for( unsigned int n = 0; n < this->Transforms.size(); ++n )
+    {
+      const ITKTransformType* transform = this->Transforms[ n ];
+      switch( this->Derivatives[ n ] )
+      {
+        case Analytic:
+          transform->ComputeJacobianWithRespectToPosition( point, analyticJacobian );
+          for( unsigned int i = 0; i < VDimension; ++i )
+          {
+            for( unsigned int j = 0; j < VDimension; ++j )
+            {
+              transformJacobian( i, j ) = analyticJacobian( i, j );
+            }
+          }
+          break;
+        case LinearBSpline: this->LinearBSplineJacobian.Compute( transform, point, transformJacobian ); break;
+        case QuadraticBSpline: this->QuadraticBSplineJacobian.Compute( transform, point, transformJacobian ); break;
+        case CubicBSpline: this->CubicBSplineJacobian.Compute( transform, point, transformJacobian ); break;
+        case CentralDifference:
+          for( unsigned int j = 0; j < VDimension; ++j )
+          {
+            PointType forwardPoint = point;
+            PointType backwardPoint = point;
+            forwardPoint[ j ] += this->Step;
+            backwardPoint[ j ] -= this->Step;
+            const PointType transformedForwardPoint = transform->TransformPoint( forwardPoint );
+            const PointType transformedBackwardPoint = transform->TransformPoint( backwardPoint );
+            for( unsigned int i = 0; i < VDimension; ++i )
+            {
+              transformJacobian( i, j ) = ( transformedForwardPoint[ i ] - transformedBackwardPoint[ i ] ) / ( 2.0 * this->Step );
+            }
+          }
+          break;
+      }
+
+      jacobian = transformJacobian * jacobian;
+      point = transform->TransformPoint( point );
+    }
+  }
+
+  static ITK_THREAD_RETURN_TYPE ThreadCallback( void* arg )
+  {
+    itk::MultiThreader::ThreadInfoStruct* threadInfo = static_cast< itk::MultiThreader::ThreadInfoStruct* >( arg );
+    SpatialJacobianThreadData* data = static_cast< SpatialJacobianThreadData* >( threadInfo->UserData );
+    const typename DeterminantImageType::RegionType& region = data->Regions[ threadInfo->ThreadID ];
+
+    // Exceptions cannot cross thread boundaries and are rethrown after the threads have joined
+    try
+    {
+      MatrixType jacobian;
+      typename SpatialJacobianImageType::PixelType spatialJacobianPixel( VDimension * VDimension );
+      itk::ImageRegionIteratorWithIndex< DeterminantImageType > it( data->DeterminantOfSpatialJacobian, region );
+      itk::ImageRegionIterator< SpatialJacobianImageType > spatialJacobianIt;
+      if( data->SpatialJacobian.IsNotNull() )
+      {
+        spatialJacobianIt = itk::ImageRegionIterator< SpatialJacobianImageType >( data->SpatialJacobian, region );
+      }
+
+      for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+        PointType point;
+        data->DeterminantOfSpatialJacobian->TransformIndexToPhysicalPoint( it.GetIndex(), point );
+        data->Compute( point, jacobian );
+        it.Set( static_cast< float >( vnl_det( jacobian ) ) );
+
+        // transformix stores the matrix row by row: component i * VDimension + j is dT_i / dx_j
+        if( data->SpatialJacobian.IsNotNull() )
+        {
+          for( unsigned int i = 0; i < VDimension * VDimension; ++i )
+          {
+            spatialJacobianPixel[ i ] = static_cast< float >( jacobian( i / VDimension, i % VDimension ) );
+          }
+
+          spatialJacobianIt.Set( spatialJacobianPixel );
+          ++spatialJacobianIt;
+        }
+      }
+    }
+    catch( std::exception &e )
+    {
+      data->ErrorMessages[ threadInfo->ThreadID ] = e.what();
+    }
+
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
+  typename DeterminantImageType::Pointer                   DeterminantOfSpatialJacobian;
+  typename SpatialJacobianImageType::Pointer               SpatialJacobian;
+  std::vector< typename DeterminantImageType::RegionType > Regions;
+  std::vector< std::string >                               ErrorMessages;
+
+private:
+  // Composite transforms are flattened, in the order in which their transforms are applied
+  void AddTransform( const ITKTransformType* transform )
+  {
+    const CompositeTransformType* compositeTransform = dynamic_cast< const CompositeTransformType* >( transform );
+    if( compositeTransform == NULL )
+    {
+      this->Transforms.push_back( transform );
+      return;
+    }
+
+    // A composite transform applies the transform added last first
+    for( itk::SizeValueType n = compositeTransform->GetNumberOfTransforms(); n > 0; --n )
+    {
+      this->AddTransform( compositeTransform->GetNthTransform( n - 1 ).GetPointer() );
+    }
+  }
+
+  std::vector< const ITKTransformType* >  Transforms;
+  std::vector< DerivativeEnum >           Derivatives;
+  double                                  Step;
+  BSplineSpatialJacobian< VDimension, 1 > LinearBSplineJacobian;
+  BSplineSpatialJacobian< VDimension, 2 > QuadraticBSplineJacobian;
+  BSplineSpatialJacobian< VDimension, 3 > CubicBSplineJacobian;
+};
+
+} // end namespace
+
+template< unsigned int VDimension >
+void
+SimpleTransformix::SimpleTransformixImpl
+::ComputeSpatialJacobianInternal( const Transform& transform )
+{
+  typedef itk::Transform< double, VDimension, VDimension >   ITKTransformType;
+  typedef SpatialJacobianThreadData< VDimension >            ThreadDataType;
+  typedef typename ThreadDataType::DeterminantImageType      DeterminantImageType;
+  typedef typename ThreadDataType::SpatialJacobianImageType  SpatialJacobianImageType;
+
+  const ITKTransformType* itkTransform = dynamic_cast< const ITKTransformType* >( transform.GetITKBase() );
+  if( itkTransform == NULL )
+  {
+    sitkExceptionMacro( "Transform of dimension " << transform.GetDimension() << " does not match images of dimension " << VDimension << "." );
+  }
+
+  std::vector< unsigned int > size;
+  std::vector< double > origin;
+  std::vector< double > spacing;
+  std::vector< double > direction;
+  this->GetOutputGrid( size, origin, spacing, direction );
+
+  typename DeterminantImageType::RegionType region;
+  typename DeterminantImageType::PointType gridOrigin;
+  typename DeterminantImageType::SpacingType gridSpacing;
+  typename DeterminantImageType::DirectionType gridDirection;
+  double minimumSpacing = itk::NumericTraits< double >::max();
+  for( unsigned int i = 0; i < VDimension; ++i )
+  {
+    region.SetSize( i, size[ i ] );
+    gridOrigin[ i ] = origin[ i ];
+    gridSpacing[ i ] = spacing[ i ];
+    minimumSpacing = std::min( minimumSpacing, spacing[ i ] );
+    for( unsigned int j = 0; j < VDimension; ++j )
+    {
+      gridDirection[ i ][ j ] = direction[ i * VDimension + j ];
+    }
+  }
+
+  // The derivatives are analytic, except for transforms that do not implement them, which are
+  // differentiated with central differences in physical space
+  ThreadDataType data( itkTransform, gridOrigin, 1e-3 * minimumSpacing );
+
+  data.DeterminantOfSpatialJacobian = DeterminantImageType::New();
+  data.DeterminantOfSpatialJacobian->SetRegions( region );
+  data.DeterminantOfSpatialJacobian->SetOrigin( gridOrigin );
+  data.DeterminantOfSpatialJacobian->SetSpacing( gridSpacing );
+  data.DeterminantOfSpatialJacobian->SetDirection( gridDirection );
+  data.DeterminantOfSpatialJacobian->Allocate();
+
+  if( this->GetComputeSpatialJacobian() )
+  {
+    data.SpatialJacobian = SpatialJacobianImageType::New();
+    data.SpatialJacobian->CopyInformation( data.DeterminantOfSpatialJacobian );
+    data.SpatialJacobian->SetRegions( region );
+    data.SpatialJacobian->SetNumberOfComponentsPerPixel( VDimension * VDimension );
+    data.SpatialJacobian->Allocate();
+  }
+
+  // Each thread computes a slab of the grid
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads( this->GetNumberOfThreads() );
+  itk::ImageRegionSplitterSlowDimension::Pointer splitter = itk::ImageRegionSplitterSlowDimension::New();
+  const unsigned int numberOfSplits = splitter->GetNumberOfSplits( region, threader->GetNumberOfThreads() );
+  for( unsigned int i = 0; i < numberOfSplits; ++i )
+  {
+    typename DeterminantImageType::RegionType split = region;
+    splitter->GetSplit( i, numberOfSplits, split );
+    data.Regions.push_back( split );
+  }
+
+  data.ErrorMessages.resize( numberOfSplits );
+  threader->SetNumberOfThreads( numberOfSplits );
+  threader->SetSingleMethod( ThreadDataType::ThreadCallback, &data );
+  threader->SingleMethodExecute();
+  for( unsigned int i = 0; i < numberOfSplits; ++i )
+  {
+    if( !data.ErrorMessages[ i ].empty() )
+    {
+      sitkExceptionMacro( "Could not compute the spatial Jacobian: " << data.ErrorMessages[ i ] );
+    }
+  }
+
+  if( this->GetComputeSpatialJacobian() )
+  {
+    this->m_SpatialJacobian = Image( data.SpatialJacobian );
+  }
+
+  if( this->GetComputeDeterminantOfSpatialJacobian() )
+  {
+    this->m_DeterminantOfSpatialJacobian = Image( data.DeterminantOfSpatialJacobian );
+  }
+}
+
+SimpleTransformix::SimpleTransformixImpl::VectorOfImage
+SimpleTransformix::SimpleTransformixImpl
+::Execute( const VectorOfImage& movingImages )
+{
+  const unsigned int finalBSplineInterpolationOrder = this->GetTransformParameterAsUnsignedInt( "FinalBSplineInterpolationOrder", 3 );
+  double defaultPixelValue = 0.0;
+  if( this->GetNumberOfTransformParameterMaps() > 0 && this->m_TransformParameterMapVector.back().count( "DefaultPixelValue" ) > 0 )
+  {
+    defaultPixelValue = std::atof( this->m_TransformParameterMapVector.back()[ "DefaultPixelValue" ][ 0 ].c_str() );
+  }
+
+  return this->Execute( movingImages,
+                        std::vector< unsigned int >( movingImages.size(), finalBSplineInterpolationOrder ),
+                        std::vector< double >( movingImages.size(), defaultPixelValue ) );
+}
+
+SimpleTransformix::SimpleTransformixImpl::VectorOfImage
+SimpleTransformix::SimpleTransformixImpl
+::Execute( const VectorOfImage& movingImages, const std::vector< unsigned int >& finalBSplineInterpolationOrders, const std::vector< double >& defaultPixelValues )
+{
+  if( movingImages.size() == 0 )
+  {
+    sitkExceptionMacro( "Cannot transform empty vector of moving images." );
+  }
+
+  if( finalBSplineInterpolationOrders.size() != movingImages.size() || defaultPixelValues.size() != movingImages.size() )
+  {
+    sitkExceptionMacro( "Number of interpolation orders (" << finalBSplineInterpolationOrders.size() << ") and default pixel values ("
+                     << defaultPixelValues.size() << ") must match the number of moving images (" << movingImages.size() << ")." );
+  }
+
+  std::vector< InterpolatorEnum > interpolators;
+  for( unsigned int i = 0; i < movingImages.size(); ++i )
+  {
+    if( this->IsEmpty( movingImages[ i ] ) )
+    {
+      sitkExceptionMacro( "Moving image at index " << i << " is empty." );
+    }
+
+    switch( finalBSplineInterpolationOrders[ i ] )
+    {
+      case 0: interpolators.push_back( sitkNearestNeighbor ); break;
+      case 1: interpolators.push_back( sitkLinear ); break;
+      case 3: interpolators.push_back( sitkBSpline ); break;
+      default:
+        sitkExceptionMacro( "Unsupported interpolation order " << finalBSplineInterpolationOrders[ i ] << " for moving image at index " << i << ". "
+                         << "Choose 0 (nearest neighbor), 1 (linear) or 3 (cubic B-spline)." );
+    }
+  }
+
+  this->UpdateDeformationFieldCache();
+
+  // The transform was evaluated once per output voxel when the deformation field was computed. Every
+  // image is resampled through the cached field, which reproduces the mapped coordinates exactly at
+  // the voxel centers, so only the interpolation of the moving image is repeated per input.
+  ResampleImageFilter resampler;
+  resampler.SetNumberOfThreads( this->GetNumberOfThreads() );
+  resampler.SetTransform( this->m_DeformationFieldTransform );
+  resampler.SetSize( this->m_DeformationFieldSize );
+  resampler.SetOutputOrigin( this->m_DeformationFieldOrigin );
+  resampler.SetOutputSpacing( this->m_DeformationFieldSpacing );
+  resampler.SetOutputDirection( this->m_DeformationFieldDirection );
+
+  VectorOfImage resultImages;
+  for( unsigned int i = 0; i < movingImages.size(); ++i )
+  {
+    if( movingImages[ i ].GetDimension() != this->m_DeformationFieldSize.size() )
+    {
+      sitkExceptionMacro( "Dimension of moving image at index " << i << " (" << movingImages[ i ].GetDimension()
+                       << ") does not match the dimension of the transform (" << this->m_DeformationFieldSize.size() << ")." );
+    }
+
+    resampler.SetInterpolator( interpolators[ i ] );
+    resampler.SetDefaultPixelValue( defaultPixelValues[ i ] );
+    resampler.SetOutputPixelType( movingImages[ i ].GetPixelID() );
+    resultImages.push_back( resampler.Execute( movingImages[ i ] ) );
+  }
+
+  return resultImages;
+}
+
+void
+SimpleTransformix::SimpleTransformixImpl
+::ExecuteToFile( const std::string movingImageFileName, const std::string resultImageFileName, const unsigned int numberOfTiles )
+{
+  if( this->GetNumberOfTransformParameterMaps() == 0 )
+  {
+    sitkExceptionMacro( "Transform parameter map not set." );
+  }
+
+  if( numberOfTiles == 0 )
+  {
+    sitkExceptionMacro( "Number of tiles must be at least 1." );
+  }
+
+  const unsigned int dimension = static_cast< unsigned int >( GetTransformParameterAsDouble( this->m_TransformParameterMapVector.back(), "FixedImageDimension", std::vector< double >( 1, 2.0 ) )[ 0 ] );
+  switch( dimension )
+  {
+    case 2: this->ExecuteToFileInternal< 2 >( movingImageFileName, resultImageFileName, numberOfTiles ); break;
+    case 3: this->ExecuteToFileInternal< 3 >( movingImageFileName, resultImageFileName, numberOfTiles ); break;
+#ifdef SITK_4D_IMAGES
+    case 4: this->ExecuteToFileInternal< 4 >( movingImageFileName, resultImageFileName, numberOfTiles ); break;
+#endif
+    default:
+      sitkExceptionMacro( "Tiled transformation does not support images of dimension " << dimension << "." );
+  }
+}
+
+template< unsigned int VDimension >
+void
+SimpleTransformix::SimpleTransformixImpl
+::ExecuteToFileInternal( const std::string& movingImageFileName, const std::string& resultImageFileName, const unsigned int numberOfTiles )
+{
+  typedef itk::Image< float, VDimension >                  ImageType;
+  typedef itk::ImageFileReader< ImageType >                ReaderType;
+  typedef itk::Transform< double, VDimension, VDimension > ITKTransformType;
+
+  // Output grid, interpolator and default pixel value as transformix takes them from the last map
+  std::vector< unsigned int > size;
+  std::vector< double > origin, spacing, direction;
+  this->GetOutputGrid( size, origin, spacing, direction );
+  if( size.size() != VDimension )
+  {
+    sitkExceptionMacro( "Transform parameter maps of dimension " << size.size() << " do not match the moving image of dimension " << VDimension << "." );
+  }
+
+  const ParameterMapType& transformParameterMap = this->m_TransformParameterMapVector.back();
+  const double defaultPixelValue = GetTransformParameterAsDouble( transformParameterMap, "DefaultPixelValue", std::vector< double >( 1, 0.0 ) )[ 0 ];
+  const unsigned int finalBSplineInterpolationOrder = this->GetTransformParameterAsUnsignedInt( "FinalBSplineInterpolationOrder", 3 );
+  const std::string resultImagePixelType = GetTransformParameterAsString( transformParameterMap, "ResultImagePixelType", "float" );
+  const PixelIDValueEnum resultPixelID = static_cast< PixelIDValueEnum >( GetPixelIDValueFromElastixString( resultImagePixelType ) );
+  if( GetIOComponentType( resultPixelID ) == itk::ImageIOBase::UNKNOWNCOMPONENTTYPE )
+  {
+    sitkExceptionMacro( "Unsupported ResultImagePixelType \"" << resultImagePixelType << "\"." );
+  }
+
+  InterpolatorEnum interpolator = sitkBSpline;
+  switch( finalBSplineInterpolationOrder )
+  {
+    case 0: interpolator = sitkNearestNeighbor; break;
+    case 1: interpolator = sitkLinear; break;
+    case 3: interpolator = sitkBSpline; break;
+    default:
+      sitkExceptionMacro( "Unsupported FinalBSplineInterpolationOrder " << finalBSplineInterpolationOrder << ". Choose 0 (nearest neighbor), 1 (linear) or 3 (cubic B-spline)." );
+  }
+
+  const Transform transform = this->GetTransform();
+  const ITKTransformType* itkTransform = dynamic_cast< const ITKTransformType* >( transform.GetITKBase() );
+  if( itkTransform == NULL )
+  {
+    sitkExceptionMacro( "Transform of dimension " << transform.GetDimension() << " does not match the moving image of dimension " << VDimension << "." );
+  }
+
+  try
+  {
+    // Memory only stays bounded if both files can be accessed region by region
+    itk::ImageIOBase::Pointer readImageIO = itk::ImageIOFactory::CreateImageIO( movingImageFileName.c_str(), itk::ImageIOFactory::ReadMode );
+    if( readImageIO.IsNull() || !readImageIO->CanStreamRead() )
+    {
+      sitkExceptionMacro( "Cannot read regions of " << movingImageFileName << ". Store the moving image in a format that supports streamed reading, e.g. MetaImage (.mha, .mhd)." );
+    }
+
+    itk::ImageIOBase::Pointer writeImageIO = itk::ImageIOFactory::CreateImageIO( resultImageFileName.c_str(), itk::ImageIOFactory::WriteMode );
+    if( writeImageIO.IsNull() || !writeImageIO->CanStreamWrite() )
+    {
+      sitkExceptionMacro( "Cannot write regions of " << resultImageFileName << ". Choose a format that supports streamed writing, e.g. MetaImage (.mha, .mhd)." );
+    }
+
+    typename ReaderType::Pointer reader = ReaderType::New();
+    reader->SetFileName( movingImageFileName );
+    reader->SetImageIO( readImageIO );
+    reader->UpdateOutputInformation();
+    typename ImageType::ConstPointer movingImageInformation = reader->GetOutput();
+    const typename ImageType::RegionType movingRegion = movingImageInformation->GetLargestPossibleRegion();
+
+    // Output grid without pixels, to map indices to points
+    typename ImageType::Pointer outputImageInformation = ImageType::New();
+    typename ImageType::RegionType outputRegion;
+    typename ImageType::PointType outputOrigin;
+    typename ImageType::SpacingType outputSpacing;
+    typename ImageType::DirectionType outputDirection;
+    for( unsigned int i = 0; i < VDimension; ++i )
+    {
+      outputRegion.SetSize( i, static_cast< itk::SizeValueType >( size[ i ] ) );
+      outputOrigin[ i ] = origin[ i ];
+      outputSpacing[ i ] = spacing[ i ];
+      for( unsigned int j = 0; j < VDimension; ++j )
+      {
+        outputDirection[ i ][ j ] = direction[ i * VDimension + j ];
+      }
+    }
+
+    outputImageInformation->SetRegions( outputRegion );
+    outputImageInformation->SetOrigin( outputOrigin );
+    outputImageInformation->SetSpacing( outputSpacing );
+    outputImageInformation->SetDirection( outputDirection );
+
+    // A file left from an earlier run would be written into instead of replaced
+    itksys::SystemTools::RemoveFile( resultImageFileName.c_str() );
+    writeImageIO->SetFileName( resultImageFileName );
+    writeImageIO->SetNumberOfDimensions( VDimension );
+    writeImageIO->SetPixelType( itk::ImageIOBase::SCALAR );
+    writeImageIO->SetComponentType( GetIOComponentType( resultPixelID ) );
+    writeImageIO->SetNumberOfComponents( 1 );
+    writeImageIO->SetUseStreamedWriting( true );
+    for( unsigned int i = 0; i < VDimension; ++i )
+    {
+      std::vector< double > axisDirection( VDimension );
+      for( unsigned int j = 0; j < VDimension; ++j )
+      {
+        axisDirection[ j ] = outputDirection[ j ][ i ];
+      }
+
+      writeImageIO->SetDimensions( i, outputRegion.GetSize( i ) );
+      writeImageIO->SetOrigin( i, outputOrigin[ i ] );
+      writeImageIO->SetSpacing( i, outputSpacing[ i ] );
+      writeImageIO->SetDirection( i, axisDirection );
+    }
+
+    ResampleImageFilter resampler;
+    resampler.SetNumberOfThreads( this->GetNumberOfThreads() );
+    resampler.SetTransform( transform );
+    resampler.SetInterpolator( interpolator );
+    resampler.SetDefaultPixelValue( defaultPixelValue );
+    resampler.SetOutputPixelType( resultPixelID );
+    resampler.SetOutputSpacing( spacing );
+    resampler.SetOutputDirection( direction );
+
+    // Beyond the points that a tile maps to, the interpolator reads its support. The cubic B-spline
+    // is interpolated from coefficients that depend on the whole image, with an influence that
+    // decays by a factor of 0.27 per voxel, so 16 further voxels reproduce them to float precision.
+    const double marginInMovingVoxels = finalBSplineInterpolationOrder == 3 ? 2 + 16 : 1;
+    const itk::SizeValueType latticeStep = 8;
+
+    // Tiles are slabs along the slowest axis, so that each one is a contiguous part of the output file
+    itk::ImageRegionSplitterSlowDimension::Pointer splitter = itk::ImageRegionSplitterSlowDimension::New();
+    const unsigned int numberOfSplits = splitter->GetNumberOfSplits( outputRegion, numberOfTiles );
+    for( unsigned int tile = 0; tile < numberOfSplits; ++tile )
+    {
+      typename ImageType::RegionType tileRegion = outputRegion;
+      splitter->GetSplit( tile, numberOfSplits, tileRegion );
+
+      // The transform is evaluated on a lattice of every latticeStep-th voxel of the tile, including its
+      // last voxels. Points between lattice points are taken to map no further from the mapped lattice
+      // than the largest distance between mapped lattice neighbours, by which the bounds are dilated.
+      // A point that does not map to a finite one makes the tile read the whole image.
+      std::vector< itk::SizeValueType > latticeSize( VDimension ), latticeStride( VDimension );
+      itk::SizeValueType numberOfLatticePoints = 1;
+      for( unsigned int i = 0; i < VDimension; ++i )
+      {
+        latticeSize[ i ] = ( tileRegion.GetSize( i ) - 1 + latticeStep - 1 ) / latticeStep + 1;
+        latticeStride[ i ] = numberOfLatticePoints;
+        numberOfLatticePoints *= latticeSize[ i ];
+      }
+
+      std::vector< itk::ContinuousIndex< double, VDimension > > movingIndices;
+      movingIndices.reserve( numberOfLatticePoints );
+      std::vector< double > minimumIndex( VDimension, itk::NumericTraits< double >::max() );
+      std::vector< double > maximumIndex( VDimension, itk::NumericTraits< double >::NonpositiveMin() );
+      bool isBounded = true;
+      std::vector< itk::SizeValueType > latticeIndex( VDimension, 0 );
+      bool isLatticeDone = false;
+      while( !isLatticeDone )
+      {
+        typename ImageType::IndexType outputIndex;
+        for( unsigned int i = 0; i < VDimension; ++i )
+        {
+          outputIndex[ i ] = tileRegion.GetIndex( i ) + static_cast< itk::IndexValueType >( std::min( latticeIndex[ i ] * latticeStep, tileRegion.GetSize( i ) - 1 ) );
+        }
+
+        typename ImageType::PointType outputPoint;
+        outputImageInformation->TransformIndexToPhysicalPoint( outputIndex, outputPoint );
+        itk::ContinuousIndex< double, VDimension > movingIndex;
+        movingImageInformation->TransformPhysicalPointToContinuousIndex( itkTransform->TransformPoint( outputPoint ), movingIndex );
+        movingIndices.push_back( movingIndex );
+        for( unsigned int i = 0; i < VDimension; ++i )
+        {
+          isBounded = isBounded && vnl_math_isfinite( movingIndex[ i ] );
+          minimumIndex[ i ] = std::min( minimumIndex[ i ], movingIndex[ i ] );
+          maximumIndex[ i ] = std::max( maximumIndex[ i ], movingIndex[ i ] );
+        }
+
+        isLatticeDone = true;
+        for( unsigned int i = 0; i < VDimension && isLatticeDone; ++i )
+        {
+          if( latticeIndex[ i ] + 1 < latticeSize[ i ] )
+          {
+            ++latticeIndex[ i ];
+            isLatticeDone = false;
+          }
+          else
+          {
+            latticeIndex[ i ] = 0;
+          }
+        }
+      }
+
+      std::vector< double > dilation( VDimension, 0.0 );
+      for( itk::SizeValueType point = 0; point < numberOfLatticePoints && isBounded; ++point )
+      {
+        for( unsigned int i = 0; i < VDimension; ++i )
+        {
+          // Compare with the next lattice point along each axis, if there is one
+          if( ( point / latticeStride[ i ] ) % latticeSize[ i ] + 1 < latticeSize[ i ] )
+          {
+            for( unsigned int j = 0; j < VDimension; ++j )
+            {
+              dilation[ j ] = std::max( dilation[ j ], std::abs( movingIndices[ point + latticeStride[ i ] ][ j ] - movingIndices[ point ][ j ] ) );
+            }
+          }
+        }
+      }
+
+      typename ImageType::RegionType movingTileRegion = movingRegion;
+      for( unsigned int i = 0; i < VDimension && isBounded; ++i )
+      {
+        // Clamped to the moving region, which keeps the bounds of far away points representable
+        const double lowerBound = movingRegion.GetIndex( i ) - marginInMovingVoxels - 1.0;
+        const double upperBound = movingRegion.GetIndex( i ) + static_cast< double >( movingRegion.GetSize( i ) ) + marginInMovingVoxels;
+        const itk::IndexValueType first = static_cast< itk::IndexValueType >( std::floor( std::min( std::max( minimumIndex[ i ] - dilation[ i ] - marginInMovingVoxels, lowerBound ), upperBound ) ) );
+        const itk::IndexValueType last = static_cast< itk::IndexValueType >( std::ceil( std::min( std::max( maximumIndex[ i ] + dilation[ i ] + marginInMovingVoxels, lowerBound ), upperBound ) ) );
+        movingTileRegion.SetIndex( i, first );
+        movingTileRegion.SetSize( i, static_cast< itk::SizeValueType >( std::max< itk::IndexValueType >( last - first + 1, 0 ) ) );
+      }
+
+      // Resample the tile from the part of the moving image that it maps to
+      typename ImageType::PointType tileOrigin;
+      outputImageInformation->TransformIndexToPhysicalPoint( tileRegion.GetIndex(), tileOrigin );
+      std::vector< unsigned int > tileSize( VDimension );
+      for( unsigned int i = 0; i < VDimension; ++i )
+      {
+        tileSize[ i ] = static_cast< unsigned int >( tileRegion.GetSize( i ) );
+      }
+
+      Image resultTile;
+      if( movingTileRegion.Crop( movingRegion ) )
+      {
+        reader->UpdateOutputInformation();
+        reader->GetOutput()->SetRequestedRegion( movingTileRegion );
+        reader->Update();
+        typename ImageType::Pointer movingTile = reader->GetOutput();
+        movingTile->DisconnectPipeline();
+
+        // SimpleITK images start at index 0, so the tile becomes an image of its own
+        typename ImageType::PointType movingTileOrigin;
+        movingTile->TransformIndexToPhysicalPoint( movingTile->GetBufferedRegion().GetIndex(), movingTileOrigin );
+        typename ImageType::Pointer movingTileImage = ImageType::New();
+        movingTileImage->SetRegions( typename ImageType::RegionType( movingTile->GetBufferedRegion().GetSize() ) );
+        movingTileImage->SetOrigin( movingTileOrigin );
+        movingTileImage->SetSpacing( movingTile->GetSpacing() );
+        movingTileImage->SetDirection( movingTile->GetDirection() );
+        movingTileImage->SetPixelContainer( movingTile->GetPixelContainer() );
+
+        resampler.SetSize( tileSize );
+        resampler.SetOutputOrigin( std::vector< double >( tileOrigin.Begin(), tileOrigin.End() ) );
+        resultTile = resampler.Execute( Image( movingTileImage ) );
+      }
+      else
+      {
+        // The tile maps outside the moving image
+        resultTile = Add( Image( tileSize, resultPixelID ), defaultPixelValue );
+      }
+
+      itk::ImageIORegion ioRegion( VDimension );
+      for( unsigned int i = 0; i < VDimension; ++i )
+      {
+        ioRegion.SetIndex( i, tileRegion.GetIndex( i ) );
+        ioRegion.SetSize( i, tileRegion.GetSize( i ) );
+      }
+
+      writeImageIO->SetIORegion( ioRegion );
+      writeImageIO->Write( GetBuffer( resultTile ) );
+    }
+  }
+  catch( itk::ExceptionObject &e )
+  {
+    sitkExceptionMacro( << e );
+  }
+}
+
+void
+SimpleTransformix::SimpleTransformixImpl
+::UpdateDeformationFieldCache( void )
+{
+  if( this->m_DeformationFieldSize.size() > 0 )
+  {
+    return;
+  }
+
+  if( this->GetNumberOfTransformParameterMaps() == 0 )
+  {
+    sitkExceptionMacro( "Transform parameter map not set." );
+  }
+
+  // The field is computed in memory in the pixel type of DisplacementFieldTransform. Only transforms
+  // that GetTransform() cannot convert are left to transformix, which hands its field over in a file.
+  Image deformationField;
+  Transform transform;
+  bool hasTransform = true;
+  try
+  {
+    transform = this->GetTransform();
+  }
+  catch( GenericException & )
+  {
+    hasTransform = false;
+  }
+
+  if( hasTransform )
+  {
+    deformationField = this->ComputeDeformationField( transform, sitkVectorFloat64 );
+  }
+  else
+  {
+    Self transformix;
+    transformix.m_NumberOfThreads = this->GetNumberOfThreads();
+    transformix.SetTransformParameterMap( this->m_TransformParameterMapVector );
+    transformix.ComputeDeformationFieldOn();
+    transformix.SetLogToConsole( this->GetLogToConsole() );
+    transformix.Execute();
+    deformationField = Cast( transformix.GetDeformationField(), sitkVectorFloat64 );
+  }
+
+  this->m_DeformationFieldSize = deformationField.GetSize();
+  this->m_DeformationFieldOrigin = deformationField.GetOrigin();
+  this->m_DeformationFieldSpacing = deformationField.GetSpacing();
+  this->m_DeformationFieldDirection = deformationField.GetDirection();
+  this->m_DeformationFieldTransform = DisplacementFieldTransform( deformationField );
+}
+
+Image
+SimpleTransformix::SimpleTransformixImpl
+::ComputeDeformationField( const Transform& transform, const PixelIDValueEnum outputPixelType )
+{
+  std::vector< unsigned int > size;
+  std::vector< double > origin;
+  std::vector< double > spacing;
+  std::vector< double > direction;
+  this->GetOutputGrid( size, origin, spacing, direction );
+
+  TransformToDisplacementFieldFilter transformToDisplacementField;
+  transformToDisplacementField.SetNumberOfThreads( this->GetNumberOfThreads() );
+  transformToDisplacementField.SetOutputPixelType( outputPixelType );
+  transformToDisplacementField.SetSize( size );
+  transformToDisplacementField.SetOutputOrigin( origin );
+  transformToDisplacementField.SetOutputSpacing( spacing );
+  transformToDisplacementField.SetOutputDirection( direction );
+  return transformToDisplacementField.Execute( transform );
+}
+
+void
+SimpleTransformix::SimpleTransformixImpl
+::GetOutputGrid( std::vector< unsigned int >& size, std::vector< double >& origin, std::vector< double >& spacing, std::vector< double >& direction )
+{
+  // transformix resamples onto the grid of the last map. Its first voxel is at Index, which
+  // becomes index 0 of the output image.
+  const ParameterMapType& transformParameterMap = this->m_TransformParameterMapVector.back();
+  const unsigned int dimension = this->GetTransformParameterAsUnsignedInt( "FixedImageDimension", 0 );
+  const std::vector< double > gridSize = GetTransformParameterAsDouble( transformParameterMap, "Size", std::vector< double >() );
+  const std::vector< double > index = GetTransformParameterAsDouble( transformParameterMap, "Index", std::vector< double >( dimension, 0.0 ) );
+  origin = GetTransformParameterAsDouble( transformParameterMap, "Origin", std::vector< double >( dimension, 0.0 ) );
+  spacing = GetTransformParameterAsDouble( transformParameterMap, "Spacing", std::vector< double >( dimension, 1.0 ) );
+  direction = GetTransformParameterAsDirection( transformParameterMap, "Direction", dimension );
+  if( dimension == 0 || gridSize.size() != dimension || index.size() != dimension || origin.size() != dimension || spacing.size() != dimension )
+  {
+    sitkExceptionMacro( "Size, Index, Origin and Spacing of the last transform parameter map must have FixedImageDimension elements." );
+  }
+
+  size = std::vector< unsigned int >( gridSize.begin(), gridSize.end() );
+  for( unsigned int i = 0; i < dimension; ++i )
+  {
+    for( unsigned int j = 0; j < dimension; ++j )
+    {
+      origin[ i ] += direction[ i * dimension + j ] * spacing[ j ] * index[ j ];
+    }
+  }
+}
+
+void
+SimpleTransformix::SimpleTransformixImpl
+::ClearDeformationFieldCache( void )
+{
+  this->m_DeformationFieldTransform = Transform();
+  this->m_DeformationFieldSize.clear();
+  this->m_DeformationFieldOrigin.clear();
+  this->m_DeformationFieldSpacing.clear();
+  this->m_DeformationFieldDirection.clear();
+}
+
+unsigned int
+SimpleTransformix::SimpleTransformixImpl
+::GetNumberOfThreads( void )
+{
+  if( this->m_ProcessObject )
+  {
+    return this->m_ProcessObject->GetNumberOfThreads();
+  }
+
+  return this->m_NumberOfThreads;
+}
+
+unsigned int
+SimpleTransformix::SimpleTransformixImpl
+::GetTransformParameterAsUnsignedInt( const ParameterKeyType key, const unsigned int defaultValue )
+{
+  // transformix takes the output settings from the last transform parameter map
+  if( this->GetNumberOfTransformParameterMaps() == 0 
+   || this->m_TransformParameterMapVector.back().count( key ) == 0 
+   || this->m_TransformParameterMapVector.back()[ key ].size() == 0 )
+  {
+    return defaultValue;
+  }
+
+  return static_cast< unsigned int >( std::atoi( this->m_TransformParameterMapVector.back()[ key ][ 0 ].c_str() ) );
+}
+
 const std::string 
 SimpleTransformix::SimpleTransformixImpl
-::GetName( void )
+::GetName( void ) const
 { 
   const std::string name = std::string( "SimpleTransformix" );
   return name;
@@ -145,6 +1211,7 @@ void
 SimpleTransformix::SimpleTransformixImpl
 ::SetFixedPointSetFileName( const std::string movingPointSetFileName )
 {
+  this->RemoveFixedPointSet();
   this->m_MovingPointSetFileName = movingPointSetFileName;
 }
 
@@ -162,6 +1229,38 @@ SimpleTransformix::SimpleTransformixImpl
   this->m_MovingPointSetFileName = std::string();
 }
 
+void
+SimpleTransformix::SimpleTransformixImpl
+::SetFixedPointSet( const PointSetType& fixedPointSet )
+{
+  for( unsigned int i = 1; i < fixedPointSet.size(); ++i )
+  {
+    if( fixedPointSet[ i ].size() != fixedPointSet[ 0 ].size() )
+    {
+      sitkExceptionMacro( "Fixed points must be of same dimension (fixed point at index 0 is of dimension "
+                       << fixedPointSet[ 0 ].size() << ", fixed point at index " << i
+                       << " is of dimension " << fixedPointSet[ i ].size() << ")." );
+    }
+  }
+
+  this->RemoveFixedPointSetFileName();
+  this->m_FixedPointSet = fixedPointSet;
+}
+
+SimpleTransformix::SimpleTransformixImpl::PointSetType
+SimpleTransformix::SimpleTransformixImpl
+::GetFixedPointSet( void )
+{
+  return this->m_FixedPointSet;
+}
+
+void
+SimpleTransformix::SimpleTransformixImpl
+::RemoveFixedPointSet( void )
+{
+  this->m_FixedPointSet.clear();
+}
+
 void
 SimpleTransformix::SimpleTransformixImpl
 ::SetComputeSpatialJacobian( const bool computeSpatialJacobian )
@@ -350,14 +1449,71 @@ SimpleTransformix::SimpleTransformixImpl
 
 void
 SimpleTransformix::SimpleTransformixImpl
-::SetTransformParameterMap( const ParameterMapVectorType parameterMapVector )
+::SetLogToMemory( const bool logToMemory )
 {
+  this->m_LogToMemory = logToMemory;
+}
+
+bool
+SimpleTransformix::SimpleTransformixImpl
+::GetLogToMemory( void )
+{
+  return this->m_LogToMemory;
+}
+
+void
+SimpleTransformix::SimpleTransformixImpl
+::LogToMemoryOn( void )
+{
+  this->SetLogToMemory( true );
+}
+
+void
+SimpleTransformix::SimpleTransformixImpl
+::LogToMemoryOff( void )
+{
+  this->SetLogToMemory( false );
+}
+
+void
+SimpleTransformix::SimpleTransformixImpl
+::SetMaximumLogSize( const unsigned int maximumLogSize )
+{
+  this->m_Log.SetMaximumSize( maximumLogSize );
+}
+
+unsigned int
+SimpleTransformix::SimpleTransformixImpl
+::GetMaximumLogSize( void )
+{
+  return static_cast< unsigned int >( this->m_Log.GetMaximumSize() );
+}
+
+std::string
+SimpleTransformix::SimpleTransformixImpl
+::GetLog( void )
+{
+  return this->m_Log.GetLog();
+}
+
+void
+SimpleTransformix::SimpleTransformixImpl
+::OnElastixLogLine( const std::string& line )
+{
+  this->m_Log.AddLine( line );
+}
+
+void
+SimpleTransformix::SimpleTransformixImpl
+::SetTransformParameterMap( const ParameterMapVectorType& parameterMapVector )
+{
+  this->ClearDeformationFieldCache();
   this->m_TransformParameterMapVector = parameterMapVector;
 }
 
 void
 SimpleTransformix::SimpleTransformixImpl
-::SetTransformParameterMap( const ParameterMapType parameterMap )
+::SetTransformParameterMap( const ParameterMapType& parameterMap )
 {
   ParameterMapVectorType parameterMapVector;
   parameterMapVector.push_back( parameterMap );
@@ -367,8 +1523,9 @@ SimpleTransformix::SimpleTransformixImpl
 
 void
 SimpleTransformix::SimpleTransformixImpl
-::AddTransformParameterMap( const ParameterMapType parameterMap )
+::AddTransformParameterMap( const ParameterMapType& parameterMap )
 {
+  this->ClearDeformationFieldCache();
   this->m_TransformParameterMapVector.push_back( parameterMap );
 }
 
@@ -415,6 +1572,7 @@ SimpleTransformix::SimpleTransformixImpl
     sitkExceptionMacro( "Parameter map index is out of range (index: " << index << "; number of transform parameters maps: " << this->m_TransformParameterMapVector.size() << "). Note that indexes are zero-based." );
   }
 
+  this->ClearDeformationFieldCache();
   this->m_TransformParameterMapVector[ index ][ key ] = ParameterValueVectorType( 1, value );
 }
 
@@ -427,6 +1585,7 @@ SimpleTransformix::SimpleTransformixImpl
     sitkExceptionMacro( "Parameter map index is out of range (index: " << index << ", number of transform parameters maps: " << this->m_TransformParameterMapVector.size() << "). Note that indexes are zero-based." );
   }
 
+  this->ClearDeformationFieldCache();
   this->m_TransformParameterMapVector[ index ][ key ] = value;
 }
 
@@ -455,6 +1614,7 @@ SimpleTransformix::SimpleTransformixImpl
   }
   else
   {
+    this->ClearDeformationFieldCache();
     this->m_TransformParameterMapVector[ index ][ key ].push_back( value );
   }
 }
@@ -502,6 +1662,7 @@ SimpleTransformix::SimpleTransformixImpl
     sitkExceptionMacro( "Parameter map index is out of range (index: " << index << ", number of transform parameters maps: " << this->m_TransformParameterMapVector.size() << "). Note that indexes are zero-based." );
   }
 
+  this->ClearDeformationFieldCache();
   this->m_TransformParameterMapVector[ index ].erase( key );
 }
 
@@ -525,7 +1686,7 @@ SimpleTransformix::SimpleTransformixImpl
 
 void
 SimpleTransformix::SimpleTransformixImpl
-::WriteParameterFile( const ParameterMapType parameterMap, const std::string parameterFileName )
+::WriteParameterFile( const ParameterMapType& parameterMap, const std::string parameterFileName )
 {
   ParameterObjectPointer parameterObject = ParameterObjectType::New();
   parameterObject->WriteParameterFile( parameterMap, parameterFileName );
@@ -569,6 +1730,325 @@ SimpleTransformix::SimpleTransformixImpl
   return this->m_ResultImage;
 }
 
+Image
+SimpleTransformix::SimpleTransformixImpl
+::GetDeformationField( void )
+{
+  if( this->IsEmpty( this->m_DeformationField ) )
+  {
+    sitkExceptionMacro( "No deformation field was found. Enable ComputeDeformationFieldOn() and run transformix with Execute()." )
+  }
+
+  return this->m_DeformationField;
+}
+
+Image
+SimpleTransformix::SimpleTransformixImpl
+::GetSpatialJacobian( void )
+{
+  if( this->IsEmpty( this->m_SpatialJacobian ) )
+  {
+    sitkExceptionMacro( "No spatial Jacobian was found. Enable ComputeSpatialJacobianOn() and run transformix with Execute()." )
+  }
+
+  return this->m_SpatialJacobian;
+}
+
+Image
+SimpleTransformix::SimpleTransformixImpl
+::GetDeterminantOfSpatialJacobian( void )
+{
+  if( this->IsEmpty( this->m_DeterminantOfSpatialJacobian ) )
+  {
+    sitkExceptionMacro( "No determinant of spatial Jacobian was found. Enable ComputeDeterminantOfSpatialJacobianOn() and run transformix with Execute()." )
+  }
+
+  return this->m_DeterminantOfSpatialJacobian;
+}
+
+SimpleTransformix::SimpleTransformixImpl::PointSetType
+SimpleTransformix::SimpleTransformixImpl
+::GetTransformedPoints( void )
+{
+  if( this->m_TransformedPointSet.size() == 0 )
+  {
+    sitkExceptionMacro( "No transformed points were found. Set points with SetFixedPointSet() and run transformix with Execute()." )
+  }
+
+  return this->m_TransformedPointSet;
+}
+
+Transform
+SimpleTransformix::SimpleTransformixImpl
+::GetTransform( void )
+{
+  if( this->GetNumberOfTransformParameterMaps() == 0 )
+  {
+    sitkExceptionMacro( "Transform parameter map not set." );
+  }
+
+  // An initial transform of the first map is only available on disk. Files that refer back to a
+  // file of the chain would be read forever.
+  ParameterMapVectorType transformParameterMapVector = this->m_TransformParameterMapVector;
+  std::set< std::string > visitedFileNames;
+  std::string initialTransformParameterFileName = GetTransformParameterAsString( transformParameterMapVector[ 0 ], "InitialTransformParametersFileName", "NoInitialTransform" );
+  while( initialTransformParameterFileName != "NoInitialTransform" )
+  {
+    if( !visitedFileNames.insert( itksys::SystemTools::CollapseFullPath( initialTransformParameterFileName ) ).second )
+    {
+      sitkExceptionMacro( "Initial transform parameter file " << initialTransformParameterFileName << " refers back to itself through InitialTransformParametersFileName." );
+    }
+
+    ParameterMapType initialTransformParameterMap = this->ReadParameterFile( initialTransformParameterFileName );
+    if( initialTransformParameterMap.size() == 0 )
+    {
+      sitkExceptionMacro( "Could not read initial transform parameter file " << initialTransformParameterFileName << "." );
+    }
+
+    transformParameterMapVector.insert( transformParameterMapVector.begin(), initialTransformParameterMap );
+    initialTransformParameterFileName = GetTransformParameterAsString( initialTransformParameterMap, "InitialTransformParametersFileName", "NoInitialTransform" );
+  }
+
+  // Each map is combined with the transform of the maps before it, as transformix does
+  Transform transform = this->ConvertTransformParameterMap( transformParameterMapVector[ 0 ] );
+  for( unsigned int i = 1; i < transformParameterMapVector.size(); ++i )
+  {
+    const ParameterMapType& transformParameterMap = transformParameterMapVector[ i ];
+    const Transform currentTransform = this->ConvertTransformParameterMap( transformParameterMap );
+    const std::string howToCombineTransforms = GetTransformParameterAsString( transformParameterMap, "HowToCombineTransforms", "Compose" );
+    if( howToCombineTransforms == "Compose" )
+    {
+      // T( x ) = T_current( T_initial( x ) ). A composite transform applies the transform added last first.
+      Transform compositeTransform = currentTransform;
+      compositeTransform.AddTransform( transform );
+      transform = compositeTransform;
+    }
+    else if( howToCombineTransforms == "Add" )
+    {
+      // T( x ) = T_current( x ) + T_initial( x ) - x has no closed form, so the displacements
+      // are added on the grid of the current map
+      const unsigned int dimension = static_cast< unsigned int >( GetTransformParameterAsDouble( transformParameterMap, "FixedImageDimension", std::vector< double >( 1, 2.0 ) )[ 0 ] );
+      const std::vector< double > size = GetTransformParameterAsDouble( transformParameterMap, "Size", std::vector< double >() );
+      if( size.size() != dimension )
+      {
+        sitkExceptionMacro( "Transform parameter map " << i << " must give the Size of the fixed image to add transforms." );
+      }
+
+      TransformToDisplacementFieldFilter transformToDisplacementField;
+      transformToDisplacementField.SetOutputPixelType( sitkVectorFloat64 );
+      transformToDisplacementField.SetSize( std::vector< unsigned int >( size.begin(), size.end() ) );
+      transformToDisplacementField.SetOutputOrigin( GetTransformParameterAsDouble( transformParameterMap, "Origin", std::vector< double >( dimension, 0.0 ) ) );
+      transformToDisplacementField.SetOutputSpacing( GetTransformParameterAsDouble( transformParameterMap, "Spacing", std::vector< double >( dimension, 1.0 ) ) );
+      transformToDisplacementField.SetOutputDirection( GetTransformParameterAsDirection( transformParameterMap, "Direction", dimension ) );
+      Image displacementField = Add( transformToDisplacementField.Execute( transform ), transformToDisplacementField.Execute( currentTransform ) );
+      transform = DisplacementFieldTransform( displacementField );
+    }
+    else
+    {
+      sitkExceptionMacro( "HowToCombineTransforms \"" << howToCombineTransforms << "\" of transform parameter map " << i << " is not supported. Use \"Compose\" or \"Add\"." );
+    }
+  }
+
+  return transform;
+}
+
+Transform
+SimpleTransformix::SimpleTransformixImpl
+::ConvertTransformParameterMap( const ParameterMapType& transformParameterMap )
+{
+  const std::string transformName = GetTransformParameterAsString( transformParameterMap, "Transform", "" );
+  const unsigned int dimension = static_cast< unsigned int >( GetTransformParameterAsDouble( transformParameterMap, "FixedImageDimension", std::vector< double >( 1, 0.0 ) )[ 0 ] );
+  const std::vector< double > parameters = GetTransformParameterAsDouble( transformParameterMap, "TransformParameters", std::vector< double >() );
+  const std::vector< double > center = GetTransformParameterAsDouble( transformParameterMap, "CenterOfRotationPoint", std::vector< double >( dimension, 0.0 ) );
+
+  if( dimension != 2 && dimension != 3 )
+  {
+    sitkExceptionMacro( "Cannot convert " << transformName << " of dimension " << dimension << ". Only 2D and 3D transforms are supported." );
+  }
+
+  if( transformName == "TranslationTransform" )
+  {
+    TranslationTransform transform( dimension );
+    transform.SetParameters( parameters );
+    return transform;
+  }
+  else if( transformName == "EulerTransform" && dimension == 2 )
+  {
+    Euler2DTransform transform;
+    transform.SetCenter( center );
+    transform.SetParameters( parameters );
+    return transform;
+  }
+  else if( transformName == "EulerTransform" && dimension == 3 )
+  {
+    Euler3DTransform transform;
+    transform.SetCenter( center );
+    transform.SetComputeZYX( GetTransformParameterAsString( transformParameterMap, "ComputeZYX", "false" ) == "true" );
+    transform.SetParameters( parameters );
+    return transform;
+  }
+  else if( transformName == "SimilarityTransform" && dimension == 2 )
+  {
+    Similarity2DTransform transform;
+    transform.SetCenter( center );
+    transform.SetParameters( parameters );
+    return transform;
+  }
+  else if( transformName == "SimilarityTransform" && dimension == 3 )
+  {
+    Similarity3DTransform transform;
+    transform.SetCenter( center );
+    transform.SetParameters( parameters );
+    return transform;
+  }
+  else if( transformName == "AffineTransform" )
+  {
+    AffineTransform transform( dimension );
+    transform.SetCenter( center );
+    transform.SetParameters( parameters );
+    return transform;
+  }
+  else if( transformName == "BSplineTransform" || transformName == "RecursiveBSplineTransform" )
+  {
+    if( GetTransformParameterAsString( transformParameterMap, "UseCyclicTransform", "false" ) == "true" )
+    {
+      sitkExceptionMacro( "Cannot convert cyclic B-spline transforms." );
+    }
+
+    // The control point grid is the coefficient image of the ITK B-spline transform. Its fixed
+    // parameters are the size, origin, spacing and direction of the grid in this order.
+    const std::vector< double > gridSize = GetTransformParameterAsDouble( transformParameterMap, "GridSize", std::vector< double >() );
+    const std::vector< double > gridIndex = GetTransformParameterAsDouble( transformParameterMap, "GridIndex", std::vector< double >( dimension, 0.0 ) );
+    const std::vector< double > gridSpacing = GetTransformParameterAsDouble( transformParameterMap, "GridSpacing", std::vector< double >( dimension, 1.0 ) );
+    const std::vector< double > gridDirection = GetTransformParameterAsDirection( transformParameterMap, "GridDirection", dimension );
+    std::vector< double > gridOrigin = GetTransformParameterAsDouble( transformParameterMap, "GridOrigin", std::vector< double >( dimension, 0.0 ) );
+    if( gridSize.size() != dimension || gridIndex.size() != dimension || gridSpacing.size() != dimension || gridOrigin.size() != dimension )
+    {
+      sitkExceptionMacro( "B-spline transform parameter map has an invalid control point grid." );
+    }
+
+    // Move the origin to the first control point of the grid
+    for( unsigned int i = 0; i < dimension; ++i )
+    {
+      for( unsigned int j = 0; j < dimension; ++j )
+      {
+        gridOrigin[ i ] += gridDirection[ i * dimension + j ] * gridSpacing[ j ] * gridIndex[ j ];
+      }
+    }
+
+    std::vector< double > fixedParameters;
+    fixedParameters.insert( fixedParameters.end(), gridSize.begin(), gridSize.end() );
+    fixedParameters.insert( fixedParameters.end(), gridOrigin.begin(), gridOrigin.end() );
+    fixedParameters.insert( fixedParameters.end(), gridSpacing.begin(), gridSpacing.end() );
+    fixedParameters.insert( fixedParameters.end(), gridDirection.begin(), gridDirection.end() );
+
+    BSplineTransform transform( dimension, static_cast< unsigned int >( GetTransformParameterAsDouble( transformParameterMap, "BSplineTransformSplineOrder", std::vector< double >( 1, 3.0 ) )[ 0 ] ) );
+    transform.SetFixedParameters( fixedParameters );
+    transform.SetParameters( parameters );
+    return transform;
+  }
+
+  sitkExceptionMacro( "Cannot convert " << ( transformName.empty() ? std::string( "transform parameter map without Transform" ) : transformName )
+                   << ". Supported transforms are TranslationTransform, EulerTransform, SimilarityTransform, AffineTransform and BSplineTransform." );
+}
+
+std::string
+SimpleTransformix::SimpleTransformixImpl
+::GetTransformParameterAsString( const ParameterMapType& transformParameterMap, const ParameterKeyType key, const std::string defaultValue )
+{
+  ParameterMapConstIterator it = transformParameterMap.find( key );
+  if( it == transformParameterMap.end() || it->second.size() == 0 )
+  {
+    return defaultValue;
+  }
+
+  return it->second[ 0 ];
+}
+
+itk::ImageIOBase::IOComponentType
+SimpleTransformix::SimpleTransformixImpl
+::GetIOComponentType( const PixelIDValueEnum pixelID )
+{
+  switch( pixelID )
+  {
+    case sitkUInt8: return itk::ImageIOBase::UCHAR;
+    case sitkInt8: return itk::ImageIOBase::CHAR;
+    case sitkUInt16: return itk::ImageIOBase::USHORT;
+    case sitkInt16: return itk::ImageIOBase::SHORT;
+    case sitkUInt32: return itk::ImageIOBase::UINT;
+    case sitkInt32: return itk::ImageIOBase::INT;
+    case sitkFloat32: return itk::ImageIOBase::FLOAT;
+    case sitkFloat64: return itk::ImageIOBase::DOUBLE;
+    default: return itk::ImageIOBase::UNKNOWNCOMPONENTTYPE;
+  }
+}
+
+const void*
+SimpleTransformix::SimpleTransformixImpl
+::GetBuffer( const Image& image )
+{
+  switch( image.GetPixelID() )
+  {
+    case sitkUInt8: return image.GetBufferAsUInt8();
+    case sitkInt8: return image.GetBufferAsInt8();
+    case sitkUInt16: return image.GetBufferAsUInt16();
+    case sitkInt16: return image.GetBufferAsInt16();
+    case sitkUInt32: return image.GetBufferAsUInt32();
+    case sitkInt32: return image.GetBufferAsInt32();
+    case sitkFloat32: return image.GetBufferAsFloat();
+    case sitkFloat64: return image.GetBufferAsDouble();
+    default:
+      sitkExceptionMacro( "Cannot write images of pixel type " << image.GetPixelIDTypeAsString() << "." );
+  }
+}
+
+std::vector< double >
+SimpleTransformix::SimpleTransformixImpl
+::GetTransformParameterAsDouble( const ParameterMapType& transformParameterMap, const ParameterKeyType key, const std::vector< double > defaultValue )
+{
+  ParameterMapConstIterator it = transformParameterMap.find( key );
+  if( it == transformParameterMap.end() || it->second.size() == 0 )
+  {
+    return defaultValue;
+  }
+
+  std::vector< double > values;
+  for( unsigned int i = 0; i < it->second.size(); ++i )
+  {
+    values.push_back( std::atof( it->second[ i ].c_str() ) );
+  }
+
+  return values;
+}
+
+std::vector< double >
+SimpleTransformix::SimpleTransformixImpl
+::GetTransformParameterAsDirection( const ParameterMapType& transformParameterMap, const ParameterKeyType key, const unsigned int dimension )
+{
+  // elastix writes direction cosines column by column, SimpleITK expects them row by row
+  std::vector< double > identity( dimension * dimension, 0.0 );
+  for( unsigned int i = 0; i < dimension; ++i )
+  {
+    identity[ i * dimension + i ] = 1.0;
+  }
+
+  const std::vector< double > columnMajorDirection = GetTransformParameterAsDouble( transformParameterMap, key, identity );
+  if( columnMajorDirection.size() != dimension * dimension )
+  {
+    sitkExceptionMacro( key << " must have " << dimension * dimension << " elements." );
+  }
+
+  std::vector< double > direction( dimension * dimension );
+  for( unsigned int i = 0; i < dimension; ++i )
+  {
+    for( unsigned int j = 0; j < dimension; ++j )
+    {
+      direction[ i * dimension + j ] = columnMajorDirection[ j * dimension + i ];
+    }
+  }
+
+  return direction;
+}
 
 bool
 SimpleTransformix::SimpleTransformixImpl
@@ -4,6 +4,12 @@
 // SimpleITK
 #include "sitkSimpleTransformix.h"
 #include "sitkMemberFunctionFactory.h"
+#include "sitkTransform.h"
+#include "sitkSimpleElastixUtilities.h"
+
+// ITK
+#include "itkImageIOBase.h"
+#include "itkMultiThreader.h"
 
 // Transformix
 #include "elxTransformixFilter.h"
@@ -13,9 +19,10 @@ namespace itk {
   namespace simple {
 
 struct SimpleTransformix::SimpleTransformixImpl
+  : public ElastixLogListener
 {
 
-  SimpleTransformixImpl( void );
+  SimpleTransformixImpl( SimpleTransformix* processObject = NULL );
   ~SimpleTransformixImpl( void );
 
   typedef SimpleTransformixImpl Self;
@@ -32,7 +39,12 @@ struct SimpleTransformix::SimpleTransformixImpl
   typedef ParameterObjectType::ParameterValueType        ParameterValueType;
   typedef ParameterObjectType::ParameterValueVectorType  ParameterValueVectorType;
 
-  const std::string GetName( void );
+  typedef std::vector< Image >                           VectorOfImage;
+
+  typedef std::vector< double >                          PointType;
+  typedef std::vector< PointType >                       PointSetType;
+
+  const std::string GetName( void ) const;
 
   void SetMovingImage( const Image& movingImage );
   Image& GetMovingImage( void );
@@ -42,6 +54,10 @@ struct SimpleTransformix::SimpleTransformixImpl
   std::string GetFixedPointSetFileName( void );
   void RemoveFixedPointSetFileName( void );
 
+  void SetFixedPointSet( const PointSetType& fixedPointSet );
+  PointSetType GetFixedPointSet( void );
+  void RemoveFixedPointSet( void );
+
   void SetComputeSpatialJacobian( const bool );
   bool GetComputeSpatialJacobian( void );
   void ComputeSpatialJacobianOn( void );
@@ -75,9 +91,17 @@ struct SimpleTransformix::SimpleTransformixImpl
   void LogToConsoleOn();
   void LogToConsoleOff();
 
-  void SetTransformParameterMap( const std::vector< std::map< std::string, std::vector< std::string > > > parameterMapVector );
-  void SetTransformParameterMap( const std::map< std::string, std::vector< std::string > > parameterMap );
-  void AddTransformParameterMap( const std::map< std::string, std::vector< std::string > > parameterMap );
+  void SetLogToMemory( const bool logToMemory );
+  bool GetLogToMemory( void );
+  void LogToMemoryOn( void );
+  void LogToMemoryOff( void );
+  void SetMaximumLogSize( const unsigned int maximumLogSize );
+  unsigned int GetMaximumLogSize( void );
+  std::string GetLog( void );
+
+  void SetTransformParameterMap( const std::vector< std::map< std::string, std::vector< std::string > > >& parameterMapVector );
+  void SetTransformParameterMap( const std::map< std::string, std::vector< std::string > >& parameterMap );
+  void AddTransformParameterMap( const std::map< std::string, std::vector< std::string > >& parameterMap );
   std::vector< std::map< std::string, std::vector< std::string > > > GetTransformParameterMap( void );
   unsigned int GetNumberOfTransformParameterMaps( void );
 
@@ -93,18 +117,48 @@ struct SimpleTransformix::SimpleTransformixImpl
   void RemoveTransformParameter( const unsigned int index, const std::string key );
 
   std::map< std::string, std::vector< std::string > > ReadParameterFile( const std::string filename );
-  void WriteParameterFile( const std::map< std::string, std::vector< std::string > > parameterMap, const std::string parameterFileName );
+  void WriteParameterFile( const std::map< std::string, std::vector< std::string > >& parameterMap, const std::string parameterFileName );
 
   void PrintParameterMap( void );
   void PrintParameterMap( const std::map< std::string, std::vector< std::string > > parameterMap );
   void PrintParameterMap( const std::vector< std::map< std::string, std::vector< std::string > > > parameterMapVector );
 
   Image Execute( void );
+  VectorOfImage Execute( const VectorOfImage& movingImages );
+  VectorOfImage Execute( const VectorOfImage& movingImages, const std::vector< unsigned int >& finalBSplineInterpolationOrders, const std::vector< double >& defaultPixelValues );
+  void ExecuteToFile( const std::string movingImageFileName, const std::string resultImageFileName, const unsigned int numberOfTiles );
+  template< unsigned int VDimension > void ExecuteToFileInternal( const std::string& movingImageFileName, const std::string& resultImageFileName, const unsigned int numberOfTiles );
 
   Image GetResultImage( void );
+  PointSetType GetTransformedPoints( void );
+  Image GetDeformationField( void );
+  Image GetSpatialJacobian( void );
+  Image GetDeterminantOfSpatialJacobian( void );
+
+  Transform GetTransform( void );
+  Transform ConvertTransformParameterMap( const ParameterMapType& transformParameterMap );
+  static std::string GetTransformParameterAsString( const ParameterMapType& transformParameterMap, const ParameterKeyType key, const std::string defaultValue );
+  static std::vector< double > GetTransformParameterAsDouble( const ParameterMapType& transformParameterMap, const ParameterKeyType key, const std::vector< double > defaultValue );
+  static std::vector< double > GetTransformParameterAsDirection( const ParameterMapType& transformParameterMap, const ParameterKeyType key, const unsigned int dimension );
+
+  // Component type and buffer of scalar images written by ExecuteToFile()
+  static itk::ImageIOBase::IOComponentType GetIOComponentType( const PixelIDValueEnum pixelID );
+  static const void* GetBuffer( const Image& image );
+
+  unsigned int GetNumberOfThreads( void );
 
   bool IsEmpty( const Image& image );
 
+  // Keep the transformix log in memory when LogToMemoryOn()
+  virtual void OnElastixLogLine( const std::string& line );
+
+  void UpdateDeformationFieldCache( void );
+  void ClearDeformationFieldCache( void );
+  Image ComputeDeformationField( const Transform& transform, const PixelIDValueEnum outputPixelType );
+  template< unsigned int VDimension > void ComputeSpatialJacobianInternal( const Transform& transform );
+  void GetOutputGrid( std::vector< unsigned int >& size, std::vector< double >& origin, std::vector< double >& spacing, std::vector< double >& direction );
+  unsigned int GetTransformParameterAsUnsignedInt( const ParameterKeyType key, const unsigned int defaultValue );
+
   // Definitions for SimpleITK member factory
   typedef Image ( Self::*MemberFunctionType )( void );
   template< class TMovingImage > Image ExecuteInternal( void );
@@ -120,12 +174,32 @@ struct SimpleTransformix::SimpleTransformixImpl
   bool                    m_ComputeDeterminantOfSpatialJacobian;
   bool                    m_ComputeDeformationField;
   std::string             m_MovingPointSetFileName;
+  PointSetType            m_FixedPointSet;
+  PointSetType            m_TransformedPointSet;
+  Image                   m_DeformationField;
+  Image                   m_SpatialJacobian;
+  Image                   m_DeterminantOfSpatialJacobian;
+
+  // Dense deformation of the current transform, shared by all images warped with Execute( VectorOfImage )
+  Transform               m_DeformationFieldTransform;
+  std::vector< unsigned int > m_DeformationFieldSize;
+  std::vector< double >   m_DeformationFieldOrigin;
+  std::vector< double >   m_DeformationFieldSpacing;
+  std::vector< double >   m_DeformationFieldDirection;
 
   std::string             m_OutputDirectory;
   std::string             m_LogFileName;
 
   bool                    m_LogToConsole;
   bool                    m_LogToFile;
+  bool                    m_LogToMemory;
+  ElastixLogBuffer        m_Log;
+
+  // The SimpleTransformix that owns this implementation and receives observers
+  SimpleTransformix*      m_ProcessObject;
+
+  // Threads of implementations without an owner, i.e. the one that computes the deformation field cache
+  unsigned int            m_NumberOfThreads;
 };
 
 } // end namespace simple
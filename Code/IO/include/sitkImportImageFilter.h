@@ -35,7 +35,8 @@ namespace itk {
      * image class. It creates a SimpleITK image which shares the bulk
      * data buffer as what is set. SimpleITK will not responsible to
      * delete the buffer afterwards, and it buffer must remain valid
-     * while in use.
+     * while in use, unless ownership of the buffer is transferred to
+     * the image with SetBufferDeleter.
      *
      * \sa itk::simple::ImportAsInt8, itk::simple::ImportAsUInt8,
      * itk::simple::ImportAsInt16, itk::simple::ImportAsUInt16,
@@ -80,6 +81,21 @@ namespace itk {
       SITK_RETURN_SELF_TYPE_HEADER SetBufferAsFloat( float * buffer, unsigned int numberOfComponents = 1 );
       SITK_RETURN_SELF_TYPE_HEADER SetBufferAsDouble( double * buffer, unsigned int numberOfComponents = 1 );
 
+      /** Function that releases an imported buffer. It is called with
+       * the buffer and the client data given to SetBufferDeleter. */
+      typedef void (*BufferDeleterCallback)( void * buffer, void * clientData );
+
+      /** Transfer ownership of the buffer to the image created by the
+       * next call to Execute. The deleter is called once the last
+       * image that refers to the buffer is destroyed, which may be on
+       * any thread. After a successful Execute the filter forgets the
+       * buffer and the deleter, so that a buffer is never adopted
+       * twice. If Execute throws, the caller keeps ownership. Without
+       * a deleter, the default, the caller owns the buffer. */
+      SITK_RETURN_SELF_TYPE_HEADER SetBufferDeleter( BufferDeleterCallback deleter, void * clientData = NULL );
+      BufferDeleterCallback GetBufferDeleter( ) const;
+      void * GetBufferDeleterClientData( ) const;
+
       Image Execute();
 
     protected:
@@ -116,6 +132,9 @@ namespace itk {
 
       void        * m_Buffer;
 
+      BufferDeleterCallback m_BufferDeleter;
+      void                * m_BufferDeleterClientData;
+
     };
 
   Image SITKIO_EXPORT ImportAsInt8(
@@ -24,6 +24,7 @@
 
 #include <itkImage.h>
 #include <itkVectorImage.h>
+#include <itkImportImageContainer.h>
 
 #include <iterator>
 
@@ -31,6 +32,59 @@
 namespace
 {
 const unsigned int UnusedDimension = 2;
+
+/** A pixel container that releases its buffer with a deleter of the
+ * caller instead of delete[]. */
+template< typename TElementIdentifier, typename TElement >
+class ImportImageContainerWithDeleter
+  : public itk::ImportImageContainer< TElementIdentifier, TElement >
+{
+public:
+  typedef ImportImageContainerWithDeleter                           Self;
+  typedef itk::ImportImageContainer< TElementIdentifier, TElement > Superclass;
+  typedef itk::SmartPointer< Self >                                 Pointer;
+
+  itkNewMacro( Self );
+
+  void SetDeleter( itk::simple::ImportImageFilter::BufferDeleterCallback deleter, void * clientData )
+    {
+    this->m_Deleter = deleter;
+    this->m_ClientData = clientData;
+    }
+
+protected:
+  ImportImageContainerWithDeleter()
+    : m_Deleter( NULL ),
+      m_ClientData( NULL )
+    {
+    }
+
+  // The destructor of the superclass would only call its own version
+  ~ImportImageContainerWithDeleter()
+    {
+    this->DeallocateManagedMemory();
+    }
+
+  virtual void DeallocateManagedMemory()
+    {
+    if ( this->GetImportPointer() && this->GetContainerManageMemory() && this->m_Deleter )
+      {
+      // The buffer is released once, also if the container is given a new one
+      this->m_Deleter( this->GetImportPointer(), this->m_ClientData );
+      this->m_Deleter = NULL;
+      this->m_ClientData = NULL;
+      this->SetContainerManageMemory( false );
+      }
+    Superclass::DeallocateManagedMemory();
+    }
+
+private:
+  ImportImageContainerWithDeleter( const Self & ); // purposely not implemented
+  void operator=( const Self & );                  // purposely not implemented
+
+  itk::simple::ImportImageFilter::BufferDeleterCallback m_Deleter;
+  void                                              * m_ClientData;
+};
 }
 
 namespace itk {
@@ -213,6 +267,8 @@ ImportImageFilter::ImportImageFilter()
   m_Origin = std::vector<double>( 3, 0.0 );
   m_Spacing = std::vector<double>( 3, 1.0 );
   this->m_Buffer = NULL;
+  this->m_BufferDeleter = NULL;
+  this->m_BufferDeleterClientData = NULL;
 
   // list of pixel types supported
   typedef NonLabelPixelIDTypeList PixelIDTypeList;
@@ -411,6 +467,23 @@ ImportImageFilter::Self& ImportImageFilter::SetBufferAsDouble( double * buffer,
   return *this;
 }
 
+ImportImageFilter::Self& ImportImageFilter::SetBufferDeleter( BufferDeleterCallback deleter, void * clientData )
+{
+  this->m_BufferDeleter = deleter;
+  this->m_BufferDeleterClientData = clientData;
+  return *this;
+}
+
+ImportImageFilter::BufferDeleterCallback ImportImageFilter::GetBufferDeleter( ) const
+{
+  return this->m_BufferDeleter;
+}
+
+void * ImportImageFilter::GetBufferDeleterClientData( ) const
+{
+  return this->m_BufferDeleterClientData;
+}
+
 
 #define PRINT_IVAR_MACRO( VAR ) "\t" << #VAR << ": " << VAR << std::endl
 
@@ -425,7 +498,8 @@ std::string ImportImageFilter::ToString() const
       << PRINT_IVAR_MACRO( m_Spacing )
       << PRINT_IVAR_MACRO( m_Size )
       << PRINT_IVAR_MACRO( m_Direction )
-      << PRINT_IVAR_MACRO( m_Buffer );
+      << PRINT_IVAR_MACRO( m_Buffer )
+      << PRINT_IVAR_MACRO( m_BufferDeleterClientData );
   return out.str();
 }
 
@@ -454,7 +528,17 @@ Image ImportImageFilter::Execute ()
                         << "Refusing to load! " << std::endl );
     }
 
-  return this->m_MemberFactory->GetMemberFunction( this->m_PixelIDValue, imageDimension )();
+  Image image = this->m_MemberFactory->GetMemberFunction( this->m_PixelIDValue, imageDimension )();
+
+  // The image owns an adopted buffer now
+  if ( this->m_BufferDeleter )
+    {
+    this->m_Buffer = NULL;
+    this->m_BufferDeleter = NULL;
+    this->m_BufferDeleterClientData = NULL;
+    }
+
+  return image;
 }
 
 
@@ -511,11 +595,25 @@ Image ImportImageFilter::ExecuteInternal( )
     numberOfElements *= size[si];
     }
 
-  const bool TheContainerWillTakeCareOfDeletingTheMemoryBuffer = false;
+  if ( this->m_BufferDeleter )
+    {
+    // The container releases the buffer with the caller's deleter
+    typedef typename ImageType::PixelContainer PixelContainerType;
+    typedef ImportImageContainerWithDeleter< typename PixelContainerType::ElementIdentifier,
+                                             typename PixelContainerType::Element > ContainerType;
+    typename ContainerType::Pointer container = ContainerType::New();
+    container->SetDeleter( this->m_BufferDeleter, this->m_BufferDeleterClientData );
+    container->SetImportPointer(static_cast<typename ImageType::InternalPixelType*>(m_Buffer), numberOfElements, true);
+    image->SetPixelContainer( container.GetPointer() );
+    }
+  else
+    {
+    const bool TheContainerWillTakeCareOfDeletingTheMemoryBuffer = false;
 
-  // Set the image's pixel container to import the pointer provided.
-  image->GetPixelContainer()->SetImportPointer(static_cast<typename ImageType::InternalPixelType*>(m_Buffer), numberOfElements,
-                                               TheContainerWillTakeCareOfDeletingTheMemoryBuffer);
+    // Set the image's pixel container to import the pointer provided.
+    image->GetPixelContainer()->SetImportPointer(static_cast<typename ImageType::InternalPixelType*>(m_Buffer), numberOfElements,
+                                                 TheContainerWillTakeCareOfDeletingTheMemoryBuffer);
+    }
 
 
   //
@@ -526,7 +624,17 @@ Image ImportImageFilter::ExecuteInternal( )
 
   // This line must be the last line in the function to prevent a deep
   // copy caused by a implicit sitk::MakeUnique
-  return Image( image );
+  try
+    {
+    return Image( image );
+    }
+  catch( ... )
+    {
+    // The caller keeps ownership of an adopted buffer when Execute
+    // throws, so the container must not release it as well
+    image->GetPixelContainer()->SetContainerManageMemory( false );
+    throw;
+    }
 }
 
 template <class TFilterType>
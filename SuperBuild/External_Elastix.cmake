@@ -10,6 +10,18 @@ endif()
 
 file( WRITE "${CMAKE_CURRENT_BINARY_DIR}/${proj}-build/CMakeCacheInit.txt" "${ep_common_cache}" )
 
+# Must match SimpleElastixImpl::RegisterDualExecuteInternal(). Every pixel type adds an
+# instantiation of all elastix components, so 4D images, which are only registered groupwise,
+# are built for float only. The lists are passed through the initial cache because
+# ExternalProject splits command line arguments on semicolons.
+set( ELASTIX_IMAGE_2D_PIXELTYPES "float;short;unsigned short;unsigned char" )
+set( ELASTIX_IMAGE_3D_PIXELTYPES "float;short;unsigned short;unsigned char" )
+set( ELASTIX_IMAGE_4D_PIXELTYPES "float" )
+foreach( _dimension 2 3 4 )
+  file( APPEND "${CMAKE_CURRENT_BINARY_DIR}/${proj}-build/CMakeCacheInit.txt"
+    "set( ELASTIX_IMAGE_${_dimension}D_PIXELTYPES \"${ELASTIX_IMAGE_${_dimension}D_PIXELTYPES}\" CACHE STRING \"\" FORCE )\n" )
+endforeach()
+
 set( ELASTIX_GIT_REPOSITORY ${git_protocol}://github.com/kaspermarstal/elastix )
 set( ELASTIX_GIT_TAG 99251130b1d04841a1b94f7023be74124d9d9c43 )
 
@@ -37,9 +49,6 @@ ExternalProject_Add( ${proj}
   -DELASTIX_BUILD_SHARED_LIBS:BOOL=${ELASTIX_BUILD_SHARED_LIBS}
   -DCMAKE_INSTALL_PREFIX:PATH=<INSTALL_DIR>
   -DITK_DIR:PATH=${ITK_DIR}
-  -DELASTIX_IMAGE_2D_PIXELTYPES:STRING=float
-  -DELASTIX_IMAGE_3D_PIXELTYPES:STRING=float
-  -DELASTIX_IMAGE_4D_PIXELTYPES:STRING=float
   -DUSE_AdaptiveStochasticGradientDescent:BOOL=ON                                           
   -DUSE_AdvancedAffineTransformElastix:BOOL=ON
   -DUSE_AdvancedBSplineTransform:BOOL=ON                                           
@@ -23,6 +23,7 @@
 #include <sitkCastImageFilter.h>
 
 #include <sitkKernel.h>
+#include <sitkImageBufferPool.h>
 
 namespace nsstd = itk::simple::nsstd;
 
@@ -666,3 +667,62 @@ TEST( Kernel, Test1 )
   EXPECT_EQ("Polygon9", ss.str());
 
 }
+
+TEST( ImageBufferPool, Reuse ) {
+
+  EXPECT_FALSE( sitk::ImageBufferPool::GetEnabled() );
+
+  sitk::ImageBufferPool::EnabledOn();
+  EXPECT_TRUE( sitk::ImageBufferPool::GetEnabled() );
+  sitk::ImageBufferPool::ResetStatistics();
+
+  {
+  sitk::Image image( 64, 64, 64, sitk::sitkFloat32 );
+  EXPECT_EQ( 1u, sitk::ImageBufferPool::GetNumberOfAllocations() );
+  EXPECT_EQ( 1u, sitk::ImageBufferPool::GetNumberOfBuffersInUse() );
+  EXPECT_EQ( 64u*64u*64u*4u, sitk::ImageBufferPool::GetSizeInUse() );
+  }
+  EXPECT_EQ( 0u, sitk::ImageBufferPool::GetNumberOfBuffersInUse() );
+  EXPECT_EQ( 1u, sitk::ImageBufferPool::GetNumberOfIdleBuffers() );
+
+  {
+  sitk::Image image( 64, 64, 64, sitk::sitkFloat32 );
+  EXPECT_EQ( 1u, sitk::ImageBufferPool::GetNumberOfReuses() );
+  EXPECT_EQ( 0u, sitk::ImageBufferPool::GetNumberOfIdleBuffers() );
+
+  // filter outputs are pooled too
+  sitk::Image result = sitk::Cast( image, sitk::sitkInt32 );
+  EXPECT_EQ( 3u, sitk::ImageBufferPool::GetNumberOfAllocations() );
+  EXPECT_EQ( 2u, sitk::ImageBufferPool::GetNumberOfBuffersInUse() );
+  }
+  EXPECT_EQ( 2u, sitk::ImageBufferPool::GetNumberOfIdleBuffers() );
+  EXPECT_EQ( 2u*64u*64u*64u*4u, sitk::ImageBufferPool::GetIdleSize() );
+
+  // small images are left to the regular allocator
+  sitk::Image small( 8, 8, sitk::sitkUInt8 );
+  EXPECT_EQ( 3u, sitk::ImageBufferPool::GetNumberOfAllocations() );
+
+  // a smaller limit only frees what does not fit
+  sitk::ImageBufferPool::SetMaximumIdleSize( 64u*64u*64u*4u );
+  EXPECT_EQ( 1u, sitk::ImageBufferPool::GetNumberOfIdleBuffers() );
+  EXPECT_EQ( 64u*64u*64u*4u, sitk::ImageBufferPool::GetIdleSize() );
+  sitk::ImageBufferPool::SetMaximumIdleSize( std::numeric_limits< uint64_t >::max() );
+
+  sitk::ImageBufferPool::Trim();
+  EXPECT_EQ( 0u, sitk::ImageBufferPool::GetNumberOfIdleBuffers() );
+  EXPECT_EQ( 0u, sitk::ImageBufferPool::GetIdleSize() );
+
+  sitk::ImageBufferPool::SetMaximumIdleSize( 0u );
+  {
+  sitk::Image image( 64, 64, 64, sitk::sitkFloat32 );
+  }
+  EXPECT_EQ( 0u, sitk::ImageBufferPool::GetNumberOfIdleBuffers() );
+  sitk::ImageBufferPool::SetMaximumIdleSize( std::numeric_limits< uint64_t >::max() );
+
+  sitk::ImageBufferPool::EnabledOff();
+  EXPECT_FALSE( sitk::ImageBufferPool::GetEnabled() );
+  {
+  sitk::Image image( 64, 64, 64, sitk::sitkFloat32 );
+  }
+  EXPECT_EQ( 4u, sitk::ImageBufferPool::GetNumberOfAllocations() );
+}
@@ -325,6 +325,27 @@ TEST(IO,Write_BadName) {
 }
 
 
+TEST(IO, WriteRegionView) {
+
+  sitk::Image image = sitk::ReadImage( dataFinder.GetFile ( "Input/BlackDots.png" ) );
+
+  std::vector<uint32_t> index( 2, 10 );
+  std::vector<uint32_t> size( 2, 20 );
+  const sitk::Image view = image.GetRegionView( index, size );
+
+  std::string filename = dataFinder.GetOutputFile ( "IO.WriteRegionView.mha" );
+  ASSERT_NO_THROW( sitk::WriteImage( view, filename ) );
+  EXPECT_TRUE( view.IsRegionView() );
+
+  sitk::Image copy = view;
+  copy.MakeUnique();
+  sitk::Image written = sitk::ReadImage( filename );
+  EXPECT_EQ( view.GetSize(), written.GetSize() );
+  EXPECT_EQ( view.GetOrigin(), written.GetOrigin() );
+  EXPECT_EQ( sitk::Hash( copy ), sitk::Hash( written ) );
+}
+
+
 TEST(IO, DicomSeriesReader) {
 
   std::vector< std::string > fileNames;
@@ -24,6 +24,8 @@
 #include "sitkAddImageFilter.h"
 #include "sitkSubtractImageFilter.h"
 #include "sitkMultiplyImageFilter.h"
+#include "sitkMedianImageFilter.h"
+#include "sitkRegionOfInterestImageFilter.h"
 
 #include "sitkImageOperators.h"
 
@@ -39,6 +41,7 @@
 #include "itkMetaDataObject.h"
 
 #include <stdint.h>
+#include <limits>
 
 const double adir[] = {0.0, 0.0, 1.0,
                        -1.0, 0.0, 0.0,
@@ -1568,6 +1571,275 @@ TEST_F(Image, GetBufferVector)
 
 }
 
+namespace
+{
+std::vector<uint32_t> idx2( uint32_t x, uint32_t y )
+{
+  std::vector<uint32_t> idx( 2 );
+  idx[0] = x; idx[1] = y;
+  return idx;
+}
+}
+
+TEST_F(Image, BulkPixelAccess)
+{
+  sitk::Image img( 4, 3, sitk::sitkUInt8 );
+  for ( unsigned int y = 0; y < 3; ++y )
+    {
+    for ( unsigned int x = 0; x < 4; ++x )
+      {
+      img.GetBufferAsUInt8()[x + 4 * y] = 10 * y + x;
+      }
+    }
+
+  std::vector<uint32_t> indexes;
+  indexes.push_back( 1 ); indexes.push_back( 0 );
+  indexes.push_back( 3 ); indexes.push_back( 2 );
+  std::vector<double> values = img.GetPixelsAsDouble( indexes );
+  ASSERT_EQ( 2u, values.size() );
+  EXPECT_EQ( 1.0, values[0] );
+  EXPECT_EQ( 23.0, values[1] );
+
+  sitk::Image copy = img;
+  values[0] = 100.0;
+  values[1] = 200.0;
+  img.SetPixelsAsDouble( indexes, values );
+  EXPECT_EQ( 100, img.GetPixelAsUInt8( idx2(1,0) ) );
+  EXPECT_EQ( 200, img.GetPixelAsUInt8( idx2(3,2) ) );
+  EXPECT_EQ( 1, copy.GetPixelAsUInt8( idx2(1,0) ) ) << " copy on write";
+
+  indexes.push_back( 4 ); indexes.push_back( 0 );
+  EXPECT_ANY_THROW( img.GetPixelsAsDouble( indexes ) ) << " index out of bounds";
+  indexes.pop_back();
+  EXPECT_ANY_THROW( img.GetPixelsAsDouble( indexes ) ) << " incomplete index";
+  EXPECT_ANY_THROW( img.SetPixelsAsDouble( idx2(0,0), std::vector<double>( 2, 0.0 ) ) ) << " wrong number of values";
+
+  std::vector<double> region = copy.GetRegionAsDouble( idx2(1,1), idx2(2,2) );
+  ASSERT_EQ( 4u, region.size() );
+  EXPECT_EQ( 11.0, region[0] );
+  EXPECT_EQ( 12.0, region[1] );
+  EXPECT_EQ( 21.0, region[2] );
+  EXPECT_EQ( 22.0, region[3] );
+  EXPECT_ANY_THROW( copy.GetRegionAsDouble( idx2(3,1), idx2(2,2) ) ) << " region out of bounds";
+
+  std::fill( region.begin(), region.end(), 7.0 );
+  copy.SetRegionAsDouble( idx2(0,0), idx2(2,2), region );
+  EXPECT_EQ( 7, copy.GetPixelAsUInt8( idx2(1,1) ) );
+  EXPECT_EQ( 2, copy.GetPixelAsUInt8( idx2(2,0) ) );
+
+  sitk::Image vimg( 2, 2, sitk::sitkVectorFloat32, 2 );
+  vimg.SetPixelAsVectorFloat32( idx2(1,1), std::vector<float>( 2, 4.0f ) );
+  values = vimg.GetRegionAsDouble( idx2(0,0), idx2(2,2) );
+  ASSERT_EQ( 8u, values.size() );
+  EXPECT_EQ( 4.0, values[6] );
+  EXPECT_EQ( 4.0, values[7] );
+
+  sitk::Image fimg( 2, 2, sitk::sitkFloat32 );
+  fimg.SetPixelAsFloat( idx2(1,0), 2.0f );
+  fimg.SetPixelAsFloat( idx2(1,1), 4.0f );
+  fimg.SetOrigin( v2(1.0,1.0) );
+
+  std::vector<double> points;
+  points.push_back( 1.5 ); points.push_back( 1.5 );
+  points.push_back( 2.0 ); points.push_back( 1.0 );
+  points.push_back( 10.0 ); points.push_back( 1.0 );
+  values = fimg.EvaluateAtPhysicalPoints( points );
+  ASSERT_EQ( 3u, values.size() );
+  EXPECT_DOUBLE_EQ( 1.5, values[0] );
+  EXPECT_DOUBLE_EQ( 2.0, values[1] );
+  EXPECT_DOUBLE_EQ( 0.0, values[2] ) << " outside of the image";
+
+  values = fimg.EvaluateAtPhysicalPoints( points, sitk::sitkNearestNeighbor, -1.0 );
+  EXPECT_DOUBLE_EQ( 4.0, values[0] );
+  EXPECT_DOUBLE_EQ( 2.0, values[1] );
+  EXPECT_DOUBLE_EQ( -1.0, values[2] );
+  EXPECT_ANY_THROW( fimg.EvaluateAtPhysicalPoints( points, sitk::sitkBSpline ) );
+
+  EXPECT_ANY_THROW( sitk::Image( 2, 2, sitk::sitkComplexFloat32 ).GetPixelsAsDouble( idx2(0,0) ) );
+}
+
+TEST_F(Image, BulkPixelAccessTyped)
+{
+  // 2^53 + 1 is not representable as a double
+  const int64_t large = ( int64_t(1) << 53 ) + 1;
+
+  sitk::Image img( 3, 2, sitk::sitkInt64 );
+  img.SetPixelsAsInt64( idx2(2,1), std::vector<int64_t>( 1, large ) );
+  EXPECT_EQ( large, img.GetPixelAsInt64( idx2(2,1) ) );
+
+  std::vector<int64_t> values = img.GetPixelsAsInt64( idx2(2,1) );
+  ASSERT_EQ( 1u, values.size() );
+  EXPECT_EQ( large, values[0] );
+
+  values = img.GetRegionAsInt64( idx2(1,1), idx2(2,1) );
+  ASSERT_EQ( 2u, values.size() );
+  EXPECT_EQ( 0, values[0] );
+  EXPECT_EQ( large, values[1] );
+
+  values[0] = -large;
+  img.SetRegionAsInt64( idx2(1,1), idx2(2,1), values );
+  EXPECT_EQ( -large, img.GetPixelAsInt64( idx2(1,1) ) );
+  EXPECT_EQ( large, img.GetPixelAsInt64( idx2(2,1) ) );
+
+  EXPECT_ANY_THROW( img.GetPixelsAsUInt64( idx2(0,0) ) ) << " Get with wrong type";
+  EXPECT_ANY_THROW( img.SetRegionAsInt32( idx2(0,0), idx2(1,1), std::vector<int32_t>( 1, 0 ) ) ) << " Set with wrong type";
+
+  sitk::Image vimg( 2, 2, sitk::sitkVectorUInt8, 3 );
+  std::vector<uint8_t> bytes( 3, 255 );
+  vimg.SetPixelsAsUInt8( idx2(1,0), bytes );
+  bytes = vimg.GetRegionAsUInt8( idx2(0,0), idx2(2,1) );
+  ASSERT_EQ( 6u, bytes.size() );
+  EXPECT_EQ( 0, bytes[2] );
+  EXPECT_EQ( 255, bytes[3] );
+  EXPECT_ANY_THROW( vimg.GetPixelsAsInt8( idx2(0,0) ) ) << " Get with wrong type";
+
+  // Doubles which are not in the range of the pixel type are rejected
+  // instead of being cast
+  sitk::Image uimg( 2, 2, sitk::sitkUInt8 );
+  uimg.SetPixelsAsDouble( idx2(0,0), std::vector<double>( 1, 255.5 ) );
+  EXPECT_EQ( 255, uimg.GetPixelAsUInt8( idx2(0,0) ) );
+  EXPECT_ANY_THROW( uimg.SetPixelsAsDouble( idx2(0,0), std::vector<double>( 1, 256.0 ) ) );
+  EXPECT_ANY_THROW( uimg.SetPixelsAsDouble( idx2(0,0), std::vector<double>( 1, -1.0 ) ) );
+  EXPECT_ANY_THROW( uimg.SetRegionAsDouble( idx2(0,0), idx2(1,1), std::vector<double>( 1, std::numeric_limits<double>::quiet_NaN() ) ) );
+  EXPECT_EQ( 255, uimg.GetPixelAsUInt8( idx2(0,0) ) );
+
+  // A call which throws does not write any of its pixels
+  std::vector<uint32_t> indexes;
+  indexes.push_back( 0 ); indexes.push_back( 1 );
+  indexes.push_back( 1 ); indexes.push_back( 1 );
+  indexes.push_back( 2 ); indexes.push_back( 1 );
+  std::vector<double> doubles( 3, 1.0 );
+  EXPECT_ANY_THROW( uimg.SetPixelsAsDouble( indexes, doubles ) ) << " index out of bounds";
+  indexes.resize( 4 );
+  doubles.resize( 2 );
+  doubles[1] = 300.0;
+  EXPECT_ANY_THROW( uimg.SetPixelsAsDouble( indexes, doubles ) ) << " value out of range";
+  doubles.push_back( 1.0 );
+  doubles.push_back( 300.0 );
+  EXPECT_ANY_THROW( uimg.SetRegionAsDouble( idx2(0,0), idx2(2,2), doubles ) ) << " value out of range";
+  EXPECT_EQ( 255, uimg.GetPixelAsUInt8( idx2(0,0) ) );
+  EXPECT_EQ( 0, uimg.GetPixelAsUInt8( idx2(1,0) ) );
+  EXPECT_EQ( 0, uimg.GetPixelAsUInt8( idx2(0,1) ) );
+
+  EXPECT_ANY_THROW( img.SetPixelsAsDouble( idx2(0,0), std::vector<double>( 1, 9.3e18 ) ) );
+  img.SetPixelsAsDouble( idx2(0,0), std::vector<double>( 1, -9223372036854775808.0 ) );
+  EXPECT_EQ( std::numeric_limits<int64_t>::min(), img.GetPixelAsInt64( idx2(0,0) ) );
+
+  sitk::Image fimg( 2, 2, sitk::sitkFloat32 );
+  EXPECT_ANY_THROW( fimg.SetPixelsAsDouble( idx2(0,0), std::vector<double>( 1, 1e300 ) ) );
+  fimg.SetPixelsAsDouble( idx2(0,0), std::vector<double>( 1, std::numeric_limits<double>::infinity() ) );
+  EXPECT_EQ( std::numeric_limits<float>::infinity(), fimg.GetPixelAsFloat( idx2(0,0) ) );
+}
+
+TEST_F(Image, IsUniqueSharedPixelContainer)
+{
+  typedef itk::Image<float,2> ITKImageType;
+
+  sitk::Image img( 4, 3, sitk::sitkFloat32 );
+  EXPECT_TRUE( img.IsUnique() );
+
+  // an ITK image which shares only the pixel container
+  ITKImageType::Pointer other = ITKImageType::New();
+  {
+  ITKImageType *itkImage = dynamic_cast<ITKImageType *>( img.GetITKBase() );
+  ASSERT_TRUE( itkImage != NULL );
+  other->SetRegions( itkImage->GetLargestPossibleRegion() );
+  other->SetPixelContainer( itkImage->GetPixelContainer() );
+  }
+  EXPECT_FALSE( img.IsUnique() );
+
+  // writing makes the image unique, the other image keeps its value
+  img.SetPixelAsFloat( idx2(1,1), 5.0f );
+  EXPECT_TRUE( img.IsUnique() );
+  EXPECT_EQ( 0.0f, other->GetPixel( ITKImageType::IndexType() ) );
+  EXPECT_EQ( 5.0f, img.GetPixelAsFloat( idx2(1,1) ) );
+  EXPECT_EQ( 0.0f, other->GetBufferPointer()[5] );
+}
+
+TEST_F(Image, RegionView)
+{
+  sitk::Image img( 4, 3, sitk::sitkFloat32 );
+  for ( unsigned int i = 0; i < 12; ++i )
+    {
+    img.GetBufferAsFloat()[i] = i;
+    }
+  img.SetSpacing( v2(0.5,2.0) );
+  img.SetOrigin( v2(10.0,20.0) );
+  const sitk::Image &cimg = img;
+
+  sitk::Image view = img.GetRegionView( idx2(1,1), idx2(2,2) );
+  EXPECT_TRUE( view.IsRegionView() );
+  EXPECT_FALSE( img.IsRegionView() );
+  EXPECT_FALSE( view.IsUnique() );
+  EXPECT_FALSE( img.IsUnique() ) << " the view refers to the image";
+  EXPECT_EQ( 2u, view.GetWidth() );
+  EXPECT_EQ( 2u, view.GetHeight() );
+  EXPECT_EQ( img.GetSpacing(), view.GetSpacing() );
+  EXPECT_EQ( v2(10.5,22.0), view.GetOrigin() );
+  EXPECT_EQ( idx2(1,1), view.GetRegionViewIndex() );
+  EXPECT_EQ( idx2(4,3), view.GetRegionViewBufferSize() );
+  EXPECT_EQ( static_cast<const void *>( cimg.GetBufferAsFloat() ), view.GetRegionViewBuffer() );
+  EXPECT_EQ( 5.0f, view.GetPixelAsFloat( idx2(0,0) ) );
+  EXPECT_EQ( 10.0f, view.GetPixelAsFloat( idx2(1,1) ) );
+
+  sitk::Image subview = view.GetRegionView( idx2(1,0), idx2(1,2) );
+  EXPECT_EQ( idx2(2,1), subview.GetRegionViewIndex() );
+  EXPECT_EQ( 10.0f, subview.GetPixelAsFloat( idx2(0,1) ) );
+
+  EXPECT_ANY_THROW( img.GetRegionView( idx2(3,1), idx2(2,2) ) );
+  EXPECT_ANY_THROW( img.GetRegionView( idx2(0,0), idx2(0,2) ) );
+
+  // pixel-wise filters read the view in place
+  sitk::Image copy = view;
+  copy.MakeUnique();
+  EXPECT_FALSE( copy.IsRegionView() );
+  EXPECT_EQ( sitk::Hash( copy ), sitk::Hash( view ) );
+  sitk::Image sum = view + view;
+  EXPECT_FALSE( sum.IsRegionView() );
+  EXPECT_EQ( 2u, sum.GetWidth() );
+  EXPECT_EQ( 20.0f, sum.GetPixelAsFloat( idx2(1,1) ) );
+  EXPECT_TRUE( view.IsRegionView() );
+
+  // modifying the image does not change the view
+  img.SetPixelAsFloat( idx2(1,1), 100.0f );
+  EXPECT_EQ( 5.0f, view.GetPixelAsFloat( idx2(0,0) ) );
+
+  // the buffer of a const view is a copy kept with the view, the
+  // view itself is copied when written
+  const sitk::Image cview = view;
+  const float *buffer = cview.GetBufferAsFloat();
+  EXPECT_EQ( 6.0f, buffer[1] );
+  EXPECT_EQ( 9.0f, buffer[2] );
+  EXPECT_EQ( buffer, cview.GetBufferAsFloat() );
+  EXPECT_TRUE( cview.IsRegionView() );
+  EXPECT_EQ( idx2(1,1), cview.GetRegionViewIndex() );
+  view.SetPixelAsFloat( idx2(0,0), -1.0f );
+  EXPECT_FALSE( view.IsRegionView() );
+  EXPECT_EQ( 6.0f, subview.GetPixelAsFloat( idx2(0,0) ) ) << " views of views are independent";
+}
+
+TEST_F(Image, RegionViewNeighborhoodFilter)
+{
+  sitk::Image img( 6, 6, sitk::sitkFloat32 );
+  for ( unsigned int i = 0; i < 36; ++i )
+    {
+    img.GetBufferAsFloat()[i] = ( i * 7 ) % 11;
+    }
+
+  // the neighborhood of the border pixels of the view extends into
+  // the image, a filter must not read it
+  const sitk::Image view = img.GetRegionView( idx2(2,2), idx2(3,3) );
+  sitk::Image roi = sitk::RegionOfInterest( img, idx2(3,3), std::vector<int>( 2, 2 ) );
+  EXPECT_EQ( sitk::Hash( roi ), sitk::Hash( view ) );
+
+  std::vector<unsigned int> radius( 2, 1 );
+  sitk::Image medianOfView = sitk::Median( view, radius );
+  sitk::Image medianOfROI = sitk::Median( roi, radius );
+  EXPECT_EQ( sitk::Hash( medianOfROI ), sitk::Hash( medianOfView ) );
+  EXPECT_EQ( roi.GetOrigin(), medianOfView.GetOrigin() );
+  EXPECT_TRUE( view.IsRegionView() );
+}
+
 TEST_F(Image,MetaDataDictionary)
 {
   sitk::Image img = sitk::Image( 10,10, 10, sitk::sitkFloat32 );
@@ -78,6 +78,24 @@ class ImageTests(unittest.TestCase):
 
         self.assertEqual(len( image ), 100)
 
+    def test_inplace_operators(self):
+        """Test that the compound operators modify the image"""
+
+        image = sitk.Image( 10, 10, sitk.sitkFloat32 )
+        alias = image
+        copy = sitk.Image( image )
+
+        image += 2
+        image *= image
+        image -= 1
+
+        self.assertTrue( alias is image )
+        self.assertEqual( alias[2,3], 3.0 )
+        self.assertEqual( copy[2,3], 0.0 )
+
+        with self.assertRaises(TypeError):
+            image += "one"
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -227,6 +227,48 @@ TEST_F(Import,Shallow) {
 
 }
 
+namespace
+{
+void CountingFloatBufferDeleter( void * buffer, void * clientData )
+{
+  delete [] static_cast< float * >( buffer );
+  ++*static_cast< int * >( clientData );
+}
+}
+
+TEST_F(Import,BufferDeleter) {
+
+  // This test is designed to verify that an adopted buffer is released
+  // once, by the last image that refers to it
+
+  int numberOfDeletions = 0;
+
+  sitk::ImportImageFilter importer;
+  EXPECT_TRUE( importer.GetBufferDeleter() == NULL );
+  importer.SetSize( std::vector< unsigned int >( 2, 16u ) );
+  importer.SetBufferAsFloat( new float[16*16], 1 );
+  importer.SetBufferDeleter( CountingFloatBufferDeleter, &numberOfDeletions );
+  EXPECT_TRUE( importer.GetBufferDeleter() == CountingFloatBufferDeleter );
+  EXPECT_EQ( static_cast< void * >( &numberOfDeletions ), importer.GetBufferDeleterClientData() );
+
+  {
+  sitk::Image image = importer.Execute();
+  sitk::Image copy = image;
+
+  // the importer forgets the adopted buffer
+  EXPECT_TRUE( importer.GetBufferDeleter() == NULL );
+  EXPECT_TRUE( importer.GetBufferDeleterClientData() == NULL );
+
+  const sitk::Image & constImage = image;
+  const sitk::Image & constCopy = copy;
+  EXPECT_EQ( constImage.GetBufferAsFloat(), constCopy.GetBufferAsFloat() );
+  image = sitk::Image();
+  EXPECT_EQ( 0, numberOfDeletions );
+  }
+
+  EXPECT_EQ( 1, numberOfDeletions );
+}
+
 TEST_F(Import,ExhaustiveTypes) {
 
   sitk::ImportImageFilter importer;
@@ -126,6 +126,71 @@ class TestNumpySimpleITKInterface(unittest.TestCase):
         self.assertEqual(h, sitk.Hash(img2))
 
 
+    def test_array_view(self):
+        """Test numpy array views of SimpleITK images and back"""
+
+        img = sitk.GaussianSource( sitk.sitkFloat32,  [100,100], sigma=[10]*3, mean = [50,50] )
+        h = sitk.Hash( img )
+
+        nda = sitk.GetArrayViewFromImage( img )
+        self.assertEqual( nda.shape, (100,100) )
+        self.assertFalse( nda.flags.writeable )
+        self.assertEqual( nda[50,50], img[50,50] )
+
+        # The view keeps the buffer when the image is modified or deleted
+        value = nda[0,0]
+        img[0,0] = value + 1.0
+        self.assertEqual( nda[0,0], value )
+        del img
+        self.assertEqual( nda[0,0], value )
+
+        # The image refers to the buffer of the array
+        arr = np.arange(60, dtype=np.int16)
+        arr.shape = (sizeZ, sizeY, sizeX)
+        image = sitk.GetImageViewFromArray( arr )
+        self.assertEqual( image.GetSize(), (sizeX, sizeY, sizeZ) )
+        self.assertEqual( image[1,1,1], 25 )
+        arr[1,1,1] = 7
+        self.assertEqual( image[1,1,1], 7 )
+
+        vector = sitk.GetArrayFromImage( sitk.PhysicalPointSource(sitk.sitkVectorFloat32, [3,4]) )
+        image = sitk.GetImageViewFromArray( vector, isVector=True )
+        self.assertEqual( image.GetSize(), (3,4) )
+        self.assertEqual( image.GetNumberOfComponentsPerPixel(), 2 )
+        self.assertEqual( sitk.GetArrayFromImage( image ).tolist(), vector.tolist() )
+
+        self.assertRaises( ValueError, sitk.GetImageViewFromArray, arr[:,:,::2] )
+        self.assertEqual( h, sitk.Hash( sitk.GetImageViewFromArray( np.array( nda ) ) ) )
+
+    def test_region_view(self):
+        """Test slicing images into region views"""
+
+        img = sitk.GaussianSource( sitk.sitkFloat32,  [20,30,10], sigma=[10]*3, mean = [10,15,5] )
+        nda = sitk.GetArrayFromImage( img )
+
+        view = img[2:12,5:25,1:9]
+        self.assertTrue( view.IsRegionView() )
+        self.assertEqual( view.GetSize(), (10,20,8) )
+        self.assertEqual( view.GetRegionViewIndex(), (2,5,1) )
+        self.assertEqual( view.GetOrigin(), img.TransformIndexToPhysicalPoint( (2,5,1) ) )
+
+        # the array of a view refers to the buffer of the image
+        arr = sitk.GetArrayViewFromImage( view )
+        self.assertEqual( arr.shape, (8,20,10) )
+        self.assertFalse( arr.flags.c_contiguous )
+        self.assertEqual( arr.tolist(), nda[1:9,5:25,2:12].tolist() )
+        self.assertEqual( sitk.GetArrayFromImage( view ).tolist(), nda[1:9,5:25,2:12].tolist() )
+
+        self.assertEqual( sitk.Hash( view ), sitk.Hash( sitk.RegionOfInterest( img, (10,20,8), (2,5,1) ) ) )
+
+        # writing to the view copies it
+        view[0,0,0] = -1.0
+        self.assertFalse( view.IsRegionView() )
+        self.assertEqual( img[2,5,1], nda[1,5,2] )
+
+        # images with steps are copied
+        self.assertFalse( img[::2,:,:].IsRegionView() )
+
     def test_legacy(self):
       """Test SimpleITK Image to numpy array."""
 
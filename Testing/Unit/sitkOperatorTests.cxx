@@ -160,3 +160,45 @@ TEST(OperatorTests, AdditionalDivide)
   EXPECT_EQ( -0.25,  sitk::DivideReal(img1, -4).GetPixelAsDouble(idx) );
 
 }
+
+
+TEST(OperatorTests, InPlace)
+{
+
+  sitk::Image img1 ( 10, 10, sitk::sitkFloat32 );
+  sitk::Image img2 ( 10, 10, sitk::sitkFloat32 );
+  img2 += 2;
+
+  std::vector<uint32_t> idx( 2, 4);
+
+  const float *buffer = static_cast<const sitk::Image &>( img1 ).GetBufferAsFloat();
+
+  EXPECT_TRUE( img1.IsUnique() );
+  img1 += img2;
+  EXPECT_EQ( 2.0, img1.GetPixelAsFloat(idx) );
+  EXPECT_EQ( buffer, static_cast<const sitk::Image &>( img1 ).GetBufferAsFloat() ) << " buffer of a unique image is reused";
+
+  img1 *= 3;
+  EXPECT_EQ( 6.0, img1.GetPixelAsFloat(idx) );
+  EXPECT_EQ( buffer, static_cast<const sitk::Image &>( img1 ).GetBufferAsFloat() );
+
+  // an image sharing its buffer keeps its value
+  sitk::Image shared = img1;
+  EXPECT_FALSE( img1.IsUnique() );
+  img1 -= img2;
+  EXPECT_EQ( 4.0, img1.GetPixelAsFloat(idx) );
+  EXPECT_EQ( 6.0, shared.GetPixelAsFloat(idx) );
+  EXPECT_EQ( buffer, static_cast<const sitk::Image &>( shared ).GetBufferAsFloat() );
+  EXPECT_TRUE( img1.IsUnique() );
+  EXPECT_TRUE( shared.IsUnique() );
+
+  // unary functor filters
+  buffer = static_cast<const sitk::Image &>( img1 ).GetBufferAsFloat();
+  sitk::UnaryMinusImageFilter().ExecuteInPlace( img1 );
+  EXPECT_EQ( -4.0, img1.GetPixelAsFloat(idx) );
+  EXPECT_EQ( buffer, static_cast<const sitk::Image &>( img1 ).GetBufferAsFloat() );
+
+  // the same image as both inputs
+  img1 += img1;
+  EXPECT_EQ( -8.0, img1.GetPixelAsFloat(idx) );
+}
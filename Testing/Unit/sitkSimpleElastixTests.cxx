@@ -1,10 +1,13 @@
 #include "SimpleITKTestHarness.h"
 #include "sitkCastImageFilter.h"
 #include "sitkSimpleElastix.h"
+#include "sitkSimpleTransformix.h"
 #include "sitkImageFileWriter.h"
 #include "sitkBinaryThresholdImageFilter.h"
+#include "sitkLabelImageToLabelMapFilter.h"
   
 #include <fstream>
+#include <sstream>
 
 namespace itk {
   namespace simple {
@@ -68,6 +71,103 @@ TEST( SimpleElastix, Registration2D )
   EXPECT_FALSE( silxIsEmpty( resultImage ) );
 }
 
+TEST( SimpleElastix, RegionView )
+{
+  Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
+  Image movingImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) );
+  Image resultImage;
+
+  // Elastix registers the region of a view, not the buffer it refers to
+  std::vector< unsigned int > index( 2, 30 );
+  std::vector< unsigned int > size( 2, 120 );
+  Image fixedView = fixedImage.GetRegionView( index, size );
+  Image movingView = movingImage.GetRegionView( index, size );
+
+  SimpleElastix silx;
+  silx.SetFixedImage( fixedView );
+  silx.SetMovingImage( movingView );
+  silx.SetParameterMap( "translation" );
+  EXPECT_NO_THROW( resultImage = silx.Execute() );
+  EXPECT_EQ( fixedView.GetSize(), resultImage.GetSize() );
+  EXPECT_EQ( fixedView.GetOrigin(), resultImage.GetOrigin() );
+  ASSERT_EQ( silx.GetTransformParameterMap().size(), 1u );
+  EXPECT_EQ( silx.GetTransformParameterMap()[ 0 ][ "Size" ], SimpleElastix::ParameterValueVectorType( 2, "120" ) );
+  EXPECT_TRUE( fixedView.IsRegionView() );
+
+  SimpleTransformix stfx;
+  stfx.SetMovingImage( movingView );
+  stfx.SetTransformParameterMap( silx.GetTransformParameterMap() );
+  EXPECT_NO_THROW( resultImage = stfx.Execute() );
+  EXPECT_EQ( fixedView.GetSize(), resultImage.GetSize() );
+}
+
+TEST( SimpleElastix, TransformOnly )
+{
+  Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
+  Image movingImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) );
+  Image resultImage;
+
+  SimpleElastix silx;
+  EXPECT_TRUE( silx.GetComputeResultImage() );
+  EXPECT_NO_THROW( silx.SetFixedImage( fixedImage ) );
+  EXPECT_NO_THROW( silx.SetMovingImage( movingImage ) );
+  EXPECT_NO_THROW( silx.SetParameterMap( "translation" ) );
+  EXPECT_NO_THROW( silx.ComputeResultImageOff() );
+  EXPECT_NO_THROW( resultImage = silx.Execute() );
+  EXPECT_TRUE( silxIsEmpty( resultImage ) );
+  EXPECT_THROW( silx.GetResultImage(), GenericException );
+  EXPECT_EQ( silx.GetTransformParameterMap().size(), 1u );
+  EXPECT_EQ( silx.GetTransformParameterMap()[ 0 ].count( "WriteResultImage" ), 0u );
+
+  SimpleTransformix stfx;
+  EXPECT_NO_THROW( stfx.SetMovingImage( Cast( movingImage, sitkFloat32 ) ) );
+  EXPECT_NO_THROW( stfx.SetTransformParameterMap( silx.GetTransformParameterMap() ) );
+  EXPECT_NO_THROW( resultImage = stfx.Execute() );
+  EXPECT_FALSE( silxIsEmpty( resultImage ) );
+}
+
+TEST( SimpleElastix, InternalPixelTypes )
+{
+  Image fixedImage = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) ), sitkUInt16 );
+  Image movingImage = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) ), sitkInt16 );
+  Image resultImage;
+
+  // Images are registered as float by default
+  SimpleElastix silx;
+  silx.SetParameterMap( "translation" );
+  silx.RemoveParameter( "FixedInternalImagePixelType" );
+  silx.RemoveParameter( "MovingInternalImagePixelType" );
+  EXPECT_NO_THROW( silx.SetFixedImage( fixedImage ) );
+  EXPECT_NO_THROW( silx.SetMovingImage( movingImage ) );
+  EXPECT_NO_THROW( resultImage = silx.Execute() );
+  EXPECT_EQ( resultImage.GetPixelID(), sitkFloat32 );
+  EXPECT_EQ( silx.GetTransformParameterMap()[ 0 ][ "FixedInternalImagePixelType" ][ 0 ], "float" );
+  EXPECT_EQ( silx.GetTransformParameterMap()[ 0 ][ "MovingInternalImagePixelType" ][ 0 ], "float" );
+
+  // Other internal pixel types are used when the parameter maps ask for them
+  silx.SetParameter( "FixedInternalImagePixelType", "short" );
+  silx.SetParameter( "MovingInternalImagePixelType", "short" );
+  EXPECT_NO_THROW( resultImage = silx.Execute() );
+  EXPECT_EQ( resultImage.GetPixelID(), sitkInt16 );
+  EXPECT_EQ( silx.GetTransformParameterMap()[ 0 ][ "FixedInternalImagePixelType" ][ 0 ], "short" );
+  EXPECT_EQ( silx.GetTransformParameterMap()[ 0 ][ "MovingInternalImagePixelType" ][ 0 ], "short" );
+
+  silx.SetParameter( "FixedInternalImagePixelType", "unsigned short" );
+  EXPECT_THROW( silx.Execute(), GenericException );
+
+  silx.SetParameter( "FixedInternalImagePixelType", "double" );
+  silx.SetParameter( "MovingInternalImagePixelType", "double" );
+  EXPECT_THROW( silx.Execute(), GenericException );
+
+  silx.SetParameterMap( "translation" );
+  silx.AddParameterMap( silx.GetDefaultParameterMap( "translation" ) );
+  silx.SetParameter( 0, "FixedInternalImagePixelType", "short" );
+  silx.SetParameter( 0, "MovingInternalImagePixelType", "short" );
+  silx.SetParameter( 1, "FixedInternalImagePixelType", "float" );
+  silx.SetParameter( 1, "MovingInternalImagePixelType", "float" );
+  EXPECT_THROW( silx.Execute(), GenericException );
+}
+
 TEST( SimpleElastix, Masks )
 {
   Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
@@ -86,7 +186,7 @@ TEST( SimpleElastix, Masks )
   EXPECT_NO_THROW( resultImage = silx.Execute() );
   EXPECT_FALSE( silxIsEmpty( resultImage ) );
 
-  // Only accept masks of pixel type unsigned char
+  // Only accept masks of an integer or label pixel type
   EXPECT_NO_THROW( silx.SetMovingMask( movingMaskInvalidType ) );
   EXPECT_THROW( silx.Execute(), GenericException );
   EXPECT_NO_THROW( silx.SetMovingMask( movingMask ) );
@@ -95,6 +195,61 @@ TEST( SimpleElastix, Masks )
   EXPECT_THROW( silx.Execute(), GenericException );
 }
 
+TEST( SimpleElastix, MaskLabel )
+{
+  Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
+  Image movingImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) );
+  Image mask = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20Mask.png" ) ), sitkUInt8 );
+
+  // A segmentation with label 7 inside the mask and label 3 outside
+  Image segmentation = Cast( BinaryThreshold( mask, 0.0, 0.0, 3u, 7u ), sitkUInt16 );
+  Image resultImage;
+
+  SimpleElastix silx;
+  EXPECT_THROW( silx.GetFixedMaskLabel(), GenericException );
+  EXPECT_NO_THROW( silx.SetParameter( "ImageSampler", "RandomSparseMask" ) );
+  EXPECT_NO_THROW( silx.SetParameter( "MaximumNumberOfIterations", "8" ) );
+  EXPECT_NO_THROW( silx.SetFixedImage( fixedImage ) );
+  EXPECT_NO_THROW( silx.SetMovingImage( movingImage ) );
+  EXPECT_NO_THROW( silx.SetFixedMask( segmentation ) );
+  EXPECT_NO_THROW( silx.SetFixedMaskLabel( 7 ) );
+  EXPECT_EQ( 7, silx.GetFixedMaskLabel() );
+  EXPECT_NO_THROW( resultImage = silx.Execute() );
+  EXPECT_FALSE( silxIsEmpty( resultImage ) );
+  const std::vector< std::string > insideParameters = silx.GetTransformParameterMap()[ 0 ][ "TransformParameters" ];
+
+  // The label restricts the samples of the metric, so another label changes the registration
+  EXPECT_NO_THROW( silx.SetFixedMaskLabel( 3 ) );
+  EXPECT_NO_THROW( silx.Execute() );
+  EXPECT_NE( insideParameters, silx.GetTransformParameterMap()[ 0 ][ "TransformParameters" ] );
+
+  // Labels that the mask pixel type, or the double threshold, cannot represent are rejected
+  EXPECT_NO_THROW( silx.SetFixedMaskLabel( 70000 ) );
+  EXPECT_THROW( silx.Execute(), GenericException );
+  EXPECT_NO_THROW( silx.SetFixedMaskLabel( -1 ) );
+  EXPECT_THROW( silx.Execute(), GenericException );
+  EXPECT_NO_THROW( silx.SetFixedMask( Cast( segmentation, sitkInt64 ) ) );
+  EXPECT_NO_THROW( silx.SetFixedMaskLabel( ( static_cast< int64_t >( 1 ) << 53 ) + 1 ) );
+  EXPECT_THROW( silx.Execute(), GenericException );
+
+  // Label maps are accepted as well
+  EXPECT_NO_THROW( silx.SetFixedMask( LabelImageToLabelMap( segmentation ) ) );
+  EXPECT_NO_THROW( silx.SetFixedMaskLabel( 7 ) );
+  EXPECT_NO_THROW( silx.SetMovingMask( segmentation ) );
+  EXPECT_NO_THROW( silx.SetMovingMaskLabel( 7 ) );
+  EXPECT_NO_THROW( resultImage = silx.Execute() );
+  EXPECT_FALSE( silxIsEmpty( resultImage ) );
+
+  // Without a label, every non-zero voxel is inside the mask, which covers both labels
+  EXPECT_NO_THROW( silx.SetFixedMask( segmentation ) );
+  EXPECT_NO_THROW( silx.RemoveFixedMaskLabel() );
+  EXPECT_THROW( silx.GetFixedMaskLabel(), GenericException );
+  EXPECT_NO_THROW( silx.RemoveMovingMaskLabel() );
+  EXPECT_NO_THROW( resultImage = silx.Execute() );
+  EXPECT_FALSE( silxIsEmpty( resultImage ) );
+  EXPECT_NE( insideParameters, silx.GetTransformParameterMap()[ 0 ][ "TransformParameters" ] );
+}
+
 TEST( SimpleElastix, ProceduralInterface )
 {
   Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
@@ -335,6 +490,36 @@ TEST( SimpleElastix, RegistrationWithPointSets )
   EXPECT_FALSE( silxIsEmpty( resultImage ) );
  }
 
+TEST( SimpleElastix, RegistrationWithInMemoryPointSets )
+{
+  std::vector< std::vector< double > > fixedPointSet( 1, std::vector< double >( 2, 128.0 ) );
+  std::vector< double > movingPointSet;
+  movingPointSet.push_back( 115.0 );
+  movingPointSet.push_back( 111.0 );
+
+  Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
+  Image movingImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) );
+  Image resultImage;
+
+  SimpleElastix silx;
+  silx.SetParameterMap( "translation" );
+  silx.SetParameter( "Registration", "MultiMetricMultiResolutionRegistration" );
+  silx.AddParameter( "Metric", "CorrespondingPointsEuclideanDistanceMetric" );
+  silx.SetParameter( "Metric0Weight", "0.0" );
+
+  EXPECT_NO_THROW( silx.SetFixedImage( fixedImage ) );
+  EXPECT_NO_THROW( silx.SetFixedPointSet( fixedPointSet ) );
+  EXPECT_NO_THROW( silx.SetMovingImage( movingImage ) );
+  EXPECT_THROW( silx.SetMovingPointSet( movingPointSet, 3 ), GenericException );
+  EXPECT_NO_THROW( silx.SetMovingPointSet( movingPointSet, 2 ) );
+  EXPECT_EQ( silx.GetMovingPointSet().size(), 1u );
+  EXPECT_NO_THROW( resultImage = silx.Execute() );
+  EXPECT_FALSE( silxIsEmpty( resultImage ) );
+
+  EXPECT_NO_THROW( silx.SetFixedPointSetFileName( "FixedPointSet.pts" ) );
+  EXPECT_EQ( silx.GetFixedPointSet().size(), 0u );
+}
+
 TEST( SimpleElastix, InitialTransform )
 {
   std::string initialTransformParameterFileName = dataFinder.GetOutputFile( "InitialTransformTestParameterFile.txt" );
@@ -356,6 +541,35 @@ TEST( SimpleElastix, InitialTransform )
   EXPECT_NO_THROW( silx2.SetInitialTransformParameterFileName( initialTransformParameterFileName ) );
   EXPECT_NO_THROW( resultImage2 = silx2.Execute() );
   EXPECT_FALSE( silxIsEmpty( resultImage2 ) );
+
+  // The result of a registration from initial transform parameter maps begins with the initial
+  // transform and does not refer to the files it was passed to elastix in
+  SimpleElastix silx3;
+  EXPECT_NO_THROW( silx3.SetFixedImage( fixedImage ) );
+  EXPECT_NO_THROW( silx3.SetMovingImage( movingImage ) );
+  EXPECT_NO_THROW( silx3.SetParameterMap( silx3.GetDefaultParameterMap( "translation" ) ) );
+  EXPECT_NO_THROW( silx3.SetInitialTransformParameterMap( silx1.GetTransformParameterMap() ) );
+  EXPECT_NO_THROW( resultImage2 = silx3.Execute() );
+  EXPECT_FALSE( silxIsEmpty( resultImage2 ) );
+
+  SimpleElastix::ParameterMapVectorType transformParameterMapVector = silx3.GetTransformParameterMap();
+  ASSERT_EQ( transformParameterMapVector.size(), silx1.GetTransformParameterMap().size() + 1u );
+  EXPECT_EQ( transformParameterMapVector[ 0 ][ "InitialTransformParametersFileName" ][ 0 ], "NoInitialTransform" );
+  EXPECT_EQ( transformParameterMapVector[ 0 ][ "TransformParameters" ], silx1.GetTransformParameterMap()[ 0 ][ "TransformParameters" ] );
+  for( unsigned int i = 1; i < transformParameterMapVector.size(); ++i )
+  {
+    std::ostringstream initialTransformParametersFileName;
+    initialTransformParametersFileName << "TransformParameters." << i - 1 << ".txt";
+    EXPECT_EQ( transformParameterMapVector[ i ][ "InitialTransformParametersFileName" ][ 0 ], initialTransformParametersFileName.str() );
+  }
+
+  SimpleTransformix stfx;
+  Image transformixResultImage;
+  EXPECT_NO_THROW( stfx.SetMovingImage( Cast( movingImage, sitkFloat32 ) ) );
+  EXPECT_NO_THROW( stfx.SetTransformParameterMap( transformParameterMapVector ) );
+  EXPECT_NO_THROW( transformixResultImage = stfx.Execute() );
+  EXPECT_FALSE( silxIsEmpty( transformixResultImage ) );
+  EXPECT_EQ( transformixResultImage.GetSize(), resultImage2.GetSize() );
 }
 
 TEST( SimpleElastix, InverseTransform )
@@ -375,6 +589,91 @@ TEST( SimpleElastix, InverseTransform )
   EXPECT_NO_THROW( inverseParameterMapVector = silx.GetInverseTransformParameterMap() );
 }
 
+TEST( SimpleElastix, InverseTransformWithoutOutputDirectory )
+{
+  Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
+  Image movingImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) );
+  Image resultImage;
+
+  SimpleElastix silx;
+  SimpleElastix::ParameterMapVectorType inverseParameterMapVector;
+  EXPECT_NO_THROW( silx.SetFixedImage( fixedImage ) );
+  EXPECT_NO_THROW( silx.SetMovingImage( movingImage ) );
+  EXPECT_NO_THROW( silx.SetParameterMap( silx.GetDefaultParameterMap( "translation" ) ) );
+  EXPECT_NO_THROW( silx.AddParameterMap( silx.GetDefaultParameterMap( "affine" ) ) );
+  EXPECT_NO_THROW( silx.RemoveOutputDirectory() );
+  EXPECT_NO_THROW( resultImage = silx.Execute() );
+  EXPECT_FALSE( silxIsEmpty( resultImage ) );
+  EXPECT_NO_THROW( inverseParameterMapVector = silx.ExecuteInverse() );
+  EXPECT_EQ( inverseParameterMapVector.size(), 2u );
+  EXPECT_EQ( inverseParameterMapVector[ 0 ][ "InitialTransformParametersFileName" ][ 0 ], "NoInitialTransform" );
+
+  SimpleElastix silx2;
+  EXPECT_NO_THROW( silx2.SetInitialTransformParameterMap( silx.GetTransformParameterMap() ) );
+  EXPECT_EQ( silx2.GetInitialTransformParameterMap().size(), 2u );
+  EXPECT_NO_THROW( silx2.SetInitialTransformParameterFileName( "TransformParameters.0.txt" ) );
+  EXPECT_EQ( silx2.GetInitialTransformParameterMap().size(), 0u );
+}
+
+TEST( SimpleElastix, MultiStart )
+{
+  Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
+  Image movingImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) );
+  Image resultImage;
+
+  // Rotations of 180, 90, 0 and 270 degrees ( angle, tx, ty ). The images are only shifted, so
+  // the rotation of 0 degrees must win.
+  const unsigned int quarterTurns[] = { 2, 1, 0, 3 };
+  std::vector< std::vector< double > > candidates;
+  for( unsigned int i = 0; i < 4; ++i )
+  {
+    std::vector< double > candidate( 3, 0.0 );
+    candidate[ 0 ] = quarterTurns[ i ] * 1.5707963267948966;
+    candidates.push_back( candidate );
+  }
+
+  SimpleElastix silx;
+  EXPECT_THROW( silx.GetMultiStartMetricValues(), GenericException );
+  EXPECT_NO_THROW( silx.SetParameterMap( silx.GetDefaultParameterMap( "rigid", 2 ) ) );
+  EXPECT_NO_THROW( silx.SetFixedImage( fixedImage ) );
+  EXPECT_NO_THROW( silx.SetMovingImage( movingImage ) );
+  EXPECT_NO_THROW( silx.SetMultiStartCandidates( candidates ) );
+  EXPECT_EQ( 4u, silx.GetMultiStartCandidates().size() );
+  EXPECT_NO_THROW( resultImage = silx.Execute() );
+  EXPECT_FALSE( silxIsEmpty( resultImage ) );
+  EXPECT_EQ( 4u, silx.GetMultiStartMetricValues().size() );
+  EXPECT_EQ( 2u, silx.GetBestMultiStartCandidate() );
+
+  // The chosen candidate has the lowest final metric value
+  const std::vector< double > metricValues = silx.GetMultiStartMetricValues();
+  for( unsigned int i = 0; i < metricValues.size(); ++i )
+  {
+    EXPECT_EQ( metricValues[ i ], metricValues[ i ] );
+    EXPECT_LE( metricValues[ silx.GetBestMultiStartCandidate() ], metricValues[ i ] );
+  }
+
+  // A cached result is found before the candidates are registered again
+  EXPECT_NO_THROW( silx.UseResultCacheOn() );
+  EXPECT_NO_THROW( silx.Execute() );
+  const uint64_t resultCacheHits = SimpleElastix::GetResultCacheHits();
+  EXPECT_NO_THROW( silx.Execute() );
+  EXPECT_EQ( resultCacheHits + 1, SimpleElastix::GetResultCacheHits() );
+  EXPECT_EQ( 4u, silx.GetMultiStartMetricValues().size() );
+  EXPECT_EQ( 3u, silx.GetTransformParameterMap().size() );
+  EXPECT_NO_THROW( silx.UseResultCacheOff() );
+
+  // The candidate and its coarse registration precede the transform of the rigid parameter map
+  EXPECT_EQ( 3u, silx.GetTransformParameterMap().size() );
+  EXPECT_EQ( "EulerTransform", silx.GetTransformParameterMap()[ 0 ][ "Transform" ][ 0 ] );
+
+  // Candidates must have one parameter per degree of freedom
+  EXPECT_NO_THROW( silx.AddMultiStartCandidate( std::vector< double >( 6, 0.0 ) ) );
+  EXPECT_THROW( silx.Execute(), GenericException );
+  EXPECT_NO_THROW( silx.RemoveMultiStartCandidates() );
+  EXPECT_NO_THROW( silx.Execute() );
+  EXPECT_EQ( 1u, silx.GetTransformParameterMap().size() );
+}
+
 TEST( SimpleElastix, SameFixedImageForMultipleRegistrations )
 { 
   Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
@@ -391,6 +690,262 @@ TEST( SimpleElastix, SameFixedImageForMultipleRegistrations )
   EXPECT_NO_THROW( silx.SetMovingImage( movingImage2 ) );
   EXPECT_NO_THROW( resultImage2 = silx.Execute() );
   EXPECT_FALSE( silxIsEmpty( resultImage2 ) );
+
+  // Session mode converts the fixed image to float once for both registrations
+  EXPECT_FALSE( silx.GetCacheFixedImages() );
+  EXPECT_NO_THROW( silx.CacheFixedImagesOn() );
+  EXPECT_NO_THROW( silx.SetParameter( "FixedInternalImagePixelType", "float" ) );
+  EXPECT_NO_THROW( resultImage1 = silx.Execute() );
+  EXPECT_FALSE( silxIsEmpty( resultImage1 ) );
+  EXPECT_EQ( silx.GetFixedImageCacheMisses(), 1u );
+  EXPECT_EQ( silx.GetFixedImageCacheHits(), 0u );
+  EXPECT_NO_THROW( silx.SetMovingImage( movingImage1 ) );
+  EXPECT_NO_THROW( resultImage2 = silx.Execute() );
+  EXPECT_FALSE( silxIsEmpty( resultImage2 ) );
+  EXPECT_EQ( silx.GetFixedImageCacheMisses(), 1u );
+  EXPECT_EQ( silx.GetFixedImageCacheHits(), 1u );
+
+  // A new fixed image is converted again, also when it has the pixels of the old one
+  EXPECT_NO_THROW( silx.SetFixedImage( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) ) ) );
+  EXPECT_NO_THROW( silx.Execute() );
+  EXPECT_EQ( silx.GetFixedImageCacheMisses(), 2u );
+  EXPECT_EQ( silx.GetFixedImageCacheHits(), 1u );
+}
+
+TEST( SimpleElastix, ResultCache )
+{
+  Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
+  Image movingImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) );
+  Image resultImage;
+
+  SimpleElastix silx;
+  EXPECT_FALSE( silx.GetUseResultCache() );
+  EXPECT_NO_THROW( silx.UseResultCacheOn() );
+  EXPECT_NO_THROW( silx.SetFixedImage( fixedImage ) );
+  EXPECT_NO_THROW( silx.SetMovingImage( movingImage ) );
+  EXPECT_NO_THROW( silx.SetParameterMap( silx.GetDefaultParameterMap( "translation" ) ) );
+  EXPECT_NO_THROW( SimpleElastix::ClearResultCache() );
+  EXPECT_EQ( SimpleElastix::GetResultCacheSize(), 0u );
+
+  const uint64_t hits = SimpleElastix::GetResultCacheHits();
+  const uint64_t misses = SimpleElastix::GetResultCacheMisses();
+  EXPECT_NO_THROW( silx.Execute() );
+  SimpleElastix::ParameterMapVectorType transformParameterMapVector = silx.GetTransformParameterMap();
+  EXPECT_EQ( SimpleElastix::GetResultCacheMisses(), misses + 1 );
+  EXPECT_GT( SimpleElastix::GetResultCacheSize(), 0u );
+
+  // Same inputs and parameters
+  EXPECT_NO_THROW( resultImage = silx.Execute() );
+  EXPECT_FALSE( silxIsEmpty( resultImage ) );
+  EXPECT_EQ( SimpleElastix::GetResultCacheHits(), hits + 1 );
+  EXPECT_TRUE( silx.GetTransformParameterMap() == transformParameterMapVector );
+
+  // Unchanged images are not hashed again
+  EXPECT_EQ( silx.GetNumberOfHashedImages(), 2u );
+
+  // The image may be modified through the reference, so it is hashed again
+  EXPECT_NO_THROW( silx.GetMovingImage( 0 ) );
+  EXPECT_NO_THROW( silx.Execute() );
+  EXPECT_EQ( silx.GetNumberOfHashedImages(), 4u );
+  EXPECT_EQ( SimpleElastix::GetResultCacheHits(), hits + 2 );
+
+  // Equal pixels in other image objects are found by their content
+  SimpleElastix silx2;
+  EXPECT_NO_THROW( silx2.UseResultCacheOn() );
+  EXPECT_NO_THROW( silx2.SetFixedImage( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) ) ) );
+  EXPECT_NO_THROW( silx2.SetMovingImage( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) ) ) );
+  EXPECT_NO_THROW( silx2.SetParameterMap( silx.GetDefaultParameterMap( "translation" ) ) );
+  EXPECT_NO_THROW( silx2.Execute() );
+  EXPECT_EQ( SimpleElastix::GetResultCacheHits(), hits + 3 );
+
+  // Different parameters
+  EXPECT_NO_THROW( silx.SetParameter( "MaximumNumberOfIterations", "8" ) );
+  EXPECT_NO_THROW( silx.Execute() );
+  EXPECT_EQ( SimpleElastix::GetResultCacheMisses(), misses + 2 );
+
+  EXPECT_NO_THROW( SimpleElastix::SetResultCacheMaximumSize( 0u ) );
+  EXPECT_EQ( SimpleElastix::GetResultCacheSize(), 0u );
+  EXPECT_NO_THROW( SimpleElastix::SetResultCacheMaximumSize( 1024u * 1024u * 1024u ) );
+}
+
+TEST( SimpleElastix, BatchRegistration )
+{
+  Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
+  Image movingImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) );
+  SimpleElastix::VectorOfImage movingImages( 3, movingImage );
+  SimpleElastix::VectorOfImage resultImages;
+
+  SimpleElastix silx;
+  EXPECT_NO_THROW( silx.SetFixedImage( fixedImage ) );
+  EXPECT_NO_THROW( silx.SetParameterMap( silx.GetDefaultParameterMap( "translation" ) ) );
+  EXPECT_NO_THROW( silx.SetNumberOfThreads( 2 ) );
+  EXPECT_EQ( silx.GetNumberOfThreads(), 2u );
+  EXPECT_NO_THROW( resultImages = silx.ExecuteBatch( movingImages ) );
+  ASSERT_EQ( resultImages.size(), 3u );
+  for( unsigned int i = 0; i < resultImages.size(); ++i )
+  {
+    EXPECT_FALSE( silxIsEmpty( resultImages[ i ] ) );
+  }
+
+  EXPECT_EQ( silx.GetNumberOfBatchTransformParameterMaps(), 3u );
+  EXPECT_NO_THROW( silx.GetBatchTransformParameterMap( 2 ) );
+  EXPECT_THROW( silx.GetBatchTransformParameterMap( 3 ), GenericException );
+  EXPECT_THROW( silx.ExecuteBatch( SimpleElastix::VectorOfImage() ), GenericException );
+}
+
+TEST( SimpleElastix, ExecuteAsync )
+{
+  Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
+  Image movingImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) );
+  Image resultImage;
+
+  SimpleElastixFuture invalidFuture;
+  EXPECT_FALSE( invalidFuture.IsValid() );
+  EXPECT_THROW( invalidFuture.Wait(), GenericException );
+
+  SimpleElastix silx;
+  EXPECT_THROW( silx.ExecuteAsync(), GenericException );
+  EXPECT_NO_THROW( silx.SetFixedImage( fixedImage ) );
+  EXPECT_NO_THROW( silx.SetMovingImage( movingImage ) );
+  EXPECT_NO_THROW( silx.SetParameterMap( silx.GetDefaultParameterMap( "translation" ) ) );
+
+  // Without workers, both registrations are held in the queue, where the second one is cancelled
+  EXPECT_NO_THROW( SimpleElastix::SetNumberOfAsyncWorkers( 0 ) );
+  EXPECT_EQ( SimpleElastix::GetNumberOfAsyncWorkers(), 0u );
+  SimpleElastixFuture future1 = silx.ExecuteAsync();
+  SimpleElastixFuture future2 = silx.ExecuteAsync();
+  EXPECT_TRUE( future1.IsValid() );
+  EXPECT_EQ( SimpleElastix::GetNumberOfQueuedAsyncRegistrations(), 2u );
+  EXPECT_FALSE( future1.WaitFor( 0.1 ) );
+  EXPECT_FALSE( future1.IsDone() );
+  EXPECT_NO_THROW( future2.Cancel() );
+  EXPECT_TRUE( future2.IsCancelled() );
+  EXPECT_TRUE( future2.WaitFor( 0.0 ) );
+  EXPECT_THROW( future2.GetResultImage(), GenericException );
+  EXPECT_EQ( SimpleElastix::GetNumberOfQueuedAsyncRegistrations(), 1u );
+
+  EXPECT_NO_THROW( SimpleElastix::SetNumberOfAsyncWorkers( 1 ) );
+  EXPECT_EQ( SimpleElastix::GetNumberOfAsyncWorkers(), 1u );
+  EXPECT_NO_THROW( future1.Wait() );
+  EXPECT_TRUE( future1.IsDone() );
+  EXPECT_TRUE( future1.WaitFor( 0.0 ) );
+  EXPECT_FALSE( future1.IsCancelled() );
+  EXPECT_NO_THROW( resultImage = future1.GetResultImage() );
+  EXPECT_FALSE( silxIsEmpty( resultImage ) );
+  EXPECT_EQ( future1.GetTransformParameterMap().size(), 1u );
+
+  // Copies refer to the same registration, which continues after the object that started it is gone
+  SimpleElastixFuture future3;
+  {
+    SimpleElastix silx2;
+    EXPECT_NO_THROW( silx2.SetFixedImage( fixedImage ) );
+    EXPECT_NO_THROW( silx2.SetMovingImage( movingImage ) );
+    future3 = silx2.ExecuteAsync();
+  }
+  EXPECT_NO_THROW( resultImage = future3.GetResultImage() );
+  EXPECT_FALSE( silxIsEmpty( resultImage ) );
+  EXPECT_EQ( SimpleElastix::GetNumberOfQueuedAsyncRegistrations(), 0u );
+
+  // A running registration that would take hours stops after its current iteration
+  EXPECT_NO_THROW( silx.SetParameter( "MaximumNumberOfIterations", "1000000" ) );
+  SimpleElastixFuture future5 = silx.ExecuteAsync();
+  EXPECT_FALSE( future5.WaitFor( 2.0 ) );
+  EXPECT_EQ( SimpleElastix::GetNumberOfQueuedAsyncRegistrations(), 0u );
+  EXPECT_NO_THROW( future5.Cancel() );
+  EXPECT_TRUE( future5.WaitFor( 60.0 ) );
+  EXPECT_TRUE( future5.IsCancelled() );
+  EXPECT_THROW( future5.GetResultImage(), GenericException );
+
+  // Shutdown cancels what is still waiting and leaves the workers usable afterwards
+  EXPECT_NO_THROW( SimpleElastix::SetNumberOfAsyncWorkers( 0 ) );
+  SimpleElastixFuture future4 = silx.ExecuteAsync();
+  EXPECT_NO_THROW( SimpleElastix::ShutdownAsyncWorkers() );
+  EXPECT_TRUE( future4.IsCancelled() );
+  EXPECT_EQ( SimpleElastix::GetNumberOfQueuedAsyncRegistrations(), 0u );
+  EXPECT_NO_THROW( SimpleElastix::SetNumberOfAsyncWorkers( 1 ) );
+}
+
+TEST( SimpleElastix, Observers )
+{
+  Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
+  Image movingImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) );
+  Image resultImage;
+
+  SimpleElastix silx;
+  EXPECT_EQ( silx.GetName(), "SimpleElastix" );
+  EXPECT_NO_THROW( silx.SetFixedImage( fixedImage ) );
+  EXPECT_NO_THROW( silx.SetMovingImage( movingImage ) );
+  EXPECT_NO_THROW( silx.SetParameterMap( silx.GetDefaultParameterMap( "translation", 2 ) ) );
+  EXPECT_NO_THROW( silx.SetParameter( "MaximumNumberOfIterations", "32" ) );
+
+  CountCommand startCommand( silx );
+  CountCommand endCommand( silx );
+  CountCommand iterationCommand( silx );
+  CountCommand resolutionCommand( silx );
+  ProgressUpdate progressCommand( silx );
+  silx.AddCommand( sitkStartEvent, startCommand );
+  silx.AddCommand( sitkEndEvent, endCommand );
+  silx.AddCommand( sitkIterationEvent, iterationCommand );
+  silx.AddCommand( sitkMultiResolutionIterationEvent, resolutionCommand );
+  silx.AddCommand( sitkProgressEvent, progressCommand );
+
+  EXPECT_NO_THROW( resultImage = silx.Execute() );
+  EXPECT_FALSE( silxIsEmpty( resultImage ) );
+  EXPECT_EQ( startCommand.m_Count, 1 );
+  EXPECT_EQ( endCommand.m_Count, 1 );
+  EXPECT_EQ( resolutionCommand.m_Count, 2 );
+  EXPECT_EQ( iterationCommand.m_Count, 64 );
+  EXPECT_EQ( silx.GetCurrentLevel(), 1u );
+  EXPECT_EQ( silx.GetOptimizerIteration(), 31u );
+  EXPECT_FLOAT_EQ( progressCommand.m_Progress, 1.0f );
+
+  // Abort stops the optimizer without throwing and without a result
+  AbortAtCommand abortCommand( silx, 0.25f );
+  CountCommand abortEventCommand( silx );
+  silx.AddCommand( sitkProgressEvent, abortCommand );
+  silx.AddCommand( sitkAbortEvent, abortEventCommand );
+  EXPECT_NO_THROW( resultImage = silx.Execute() );
+  EXPECT_EQ( abortEventCommand.m_Count, 1 );
+  EXPECT_TRUE( silxIsEmpty( resultImage ) );
+  EXPECT_LT( silx.GetProgress(), 0.5f );
+}
+
+TEST( SimpleElastix, LogToMemory )
+{
+  Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
+  Image movingImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) );
+  std::vector< std::vector< double > > iterationTable;
+
+  SimpleElastix silx;
+  EXPECT_FALSE( silx.GetLogToMemory() );
+  EXPECT_NO_THROW( silx.LogToMemoryOn() );
+  EXPECT_NO_THROW( silx.SetFixedImage( fixedImage ) );
+  EXPECT_NO_THROW( silx.SetMovingImage( movingImage ) );
+  EXPECT_NO_THROW( silx.SetParameterMap( silx.GetDefaultParameterMap( "translation", 2 ) ) );
+  EXPECT_NO_THROW( silx.SetParameter( "MaximumNumberOfIterations", "32" ) );
+  EXPECT_NO_THROW( silx.Execute() );
+  EXPECT_NE( silx.GetLog().find( "Resolution: 1" ), std::string::npos );
+
+  // One row of parameter map, resolution, iteration, metric and step size per iteration
+  EXPECT_NO_THROW( iterationTable = silx.GetIterationTable() );
+  ASSERT_EQ( iterationTable.size(), 64u );
+  EXPECT_EQ( iterationTable[ 0 ].size(), 5u );
+  EXPECT_EQ( iterationTable[ 32 ][ 1 ], 1.0 );
+  EXPECT_EQ( iterationTable[ 63 ][ 2 ], 31.0 );
+
+  // Only the end of the log is kept
+  EXPECT_NO_THROW( silx.SetMaximumLogSize( 256u ) );
+  EXPECT_LE( silx.GetLog().size(), 256u );
+  EXPECT_NO_THROW( silx.Execute() );
+  EXPECT_LE( silx.GetLog().size(), 256u );
+  EXPECT_FALSE( silx.GetLog().empty() );
+
+  SimpleTransformix stfx;
+  EXPECT_NO_THROW( stfx.LogToMemoryOn() );
+  EXPECT_NO_THROW( stfx.SetMovingImage( Cast( movingImage, sitkFloat32 ) ) );
+  EXPECT_NO_THROW( stfx.SetTransformParameterMap( silx.GetTransformParameterMap() ) );
+  EXPECT_NO_THROW( stfx.Execute() );
+  EXPECT_FALSE( stfx.GetLog().empty() );
 }
 
 TEST( SimpleElastix, Registration3D )
@@ -422,6 +977,11 @@ TEST( SimpleElastix, Registration4D )
   EXPECT_NO_THROW( silx.SetMovingImage( movingImage ) );
   EXPECT_NO_THROW( resultImage = silx.Execute() );
   EXPECT_FALSE( silxIsEmpty( resultImage ) );
+
+  // elastix is built for 4D images of float only
+  silx.SetParameter( "FixedInternalImagePixelType", "short" );
+  silx.SetParameter( "MovingInternalImagePixelType", "short" );
+  EXPECT_THROW( silx.Execute(), GenericException );
 }
 
 #endif // SITK_4D_IMAGES
@@ -2,6 +2,10 @@
 #include "sitkCastImageFilter.h"
 #include "sitkSimpleElastix.h"
 #include "sitkSimpleTransformix.h"
+#include "sitkImageFileWriter.h"
+
+#include <cmath>
+#include <cstdlib>
 
 namespace itk {
   namespace simple {
@@ -79,6 +83,348 @@ TEST( SimpleTransformix, ProceduralInterface )
   EXPECT_FALSE( stfxIsEmpty( resultImage ) );
 }
 
+TEST( SimpleTransformix, InMemoryPointSet )
+{
+  Image fixedImage = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) ), sitkFloat32 );
+  Image movingImage = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) ), sitkFloat32 );
+
+  SimpleElastix silx;
+  silx.SetParameterMap( "translation" );
+  silx.SetFixedImage( fixedImage );
+  silx.SetMovingImage( movingImage );
+  silx.Execute();
+
+  std::vector< double > fixedPointSet;
+  fixedPointSet.push_back( 128.0 );
+  fixedPointSet.push_back( 128.0 );
+  fixedPointSet.push_back( 64.0 );
+  fixedPointSet.push_back( 32.0 );
+
+  SimpleTransformix stfx;
+  stfx.SetTransformParameterMap( silx.GetTransformParameterMap() );
+  EXPECT_THROW( stfx.GetTransformedPoints(), GenericException );
+  EXPECT_NO_THROW( stfx.SetFixedPointSet( fixedPointSet, 2 ) );
+  EXPECT_NO_THROW( stfx.Execute() );
+
+  std::vector< std::vector< double > > transformedPoints;
+  EXPECT_NO_THROW( transformedPoints = stfx.GetTransformedPoints() );
+  ASSERT_EQ( transformedPoints.size(), 2u );
+  ASSERT_EQ( transformedPoints[ 0 ].size(), 2u );
+  EXPECT_NEAR( transformedPoints[ 0 ][ 0 ] - transformedPoints[ 1 ][ 0 ], 64.0, 1e-3 );
+  EXPECT_NEAR( transformedPoints[ 0 ][ 1 ] - transformedPoints[ 1 ][ 1 ], 96.0, 1e-3 );
+}
+
+TEST( SimpleTransformix, LogToMemory )
+{
+  Image fixedImage = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) ), sitkFloat32 );
+  Image movingImage = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) ), sitkFloat32 );
+
+  SimpleElastix silx;
+  silx.SetParameterMap( "translation" );
+  silx.SetFixedImage( fixedImage );
+  silx.SetMovingImage( movingImage );
+  silx.Execute();
+
+  SimpleTransformix stfx;
+  EXPECT_FALSE( stfx.GetLogToMemory() );
+  EXPECT_NO_THROW( stfx.LogToMemoryOn() );
+  EXPECT_NO_THROW( stfx.SetTransformParameterMap( silx.GetTransformParameterMap() ) );
+  EXPECT_NO_THROW( stfx.SetMovingImage( movingImage ) );
+  EXPECT_NO_THROW( stfx.Execute() );
+  EXPECT_NE( stfx.GetLog().find( "transformix" ), std::string::npos );
+
+  // Each run replaces the log, which belongs to this object only
+  SimpleTransformix stfx2;
+  EXPECT_NO_THROW( stfx2.SetTransformParameterMap( silx.GetTransformParameterMap() ) );
+  EXPECT_NO_THROW( stfx2.SetMovingImage( movingImage ) );
+  EXPECT_NO_THROW( stfx2.Execute() );
+  EXPECT_TRUE( stfx2.GetLog().empty() );
+
+  const std::string log = stfx.GetLog();
+  EXPECT_NO_THROW( stfx.Execute() );
+  EXPECT_LT( stfx.GetLog().size(), 2 * log.size() );
+}
+
+TEST( SimpleTransformix, MultipleImagesWithSharedDeformation )
+{
+  Image fixedImage = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) ), sitkFloat32 );
+  Image movingImage = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) ), sitkFloat32 );
+  Image movingLabels = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) );
+
+  SimpleElastix silx;
+  silx.SetParameterMap( "translation" );
+  silx.SetFixedImage( fixedImage );
+  silx.SetMovingImage( movingImage );
+  silx.Execute();
+
+  SimpleTransformix::VectorOfImage movingImages;
+  movingImages.push_back( movingImage );
+  movingImages.push_back( movingLabels );
+
+  std::vector< unsigned int > finalBSplineInterpolationOrders;
+  finalBSplineInterpolationOrders.push_back( 3 );
+  finalBSplineInterpolationOrders.push_back( 0 );
+
+  SimpleTransformix stfx;
+  SimpleTransformix::VectorOfImage resultImages;
+  EXPECT_NO_THROW( stfx.SetNumberOfThreads( 1 ) );
+  EXPECT_THROW( stfx.Execute( movingImages ), GenericException );
+  EXPECT_NO_THROW( stfx.SetTransformParameterMap( silx.GetTransformParameterMap() ) );
+  EXPECT_THROW( stfx.Execute( movingImages, finalBSplineInterpolationOrders, std::vector< double >( 1, 0.0 ) ), GenericException );
+  EXPECT_NO_THROW( resultImages = stfx.Execute( movingImages, finalBSplineInterpolationOrders, std::vector< double >( 2, 0.0 ) ) );
+  ASSERT_EQ( resultImages.size(), 2u );
+  EXPECT_EQ( resultImages[ 0 ].GetPixelID(), sitkFloat32 );
+  EXPECT_EQ( resultImages[ 1 ].GetPixelID(), movingLabels.GetPixelID() );
+  EXPECT_EQ( resultImages[ 0 ].GetSize(), fixedImage.GetSize() );
+  EXPECT_EQ( resultImages[ 1 ].GetSize(), fixedImage.GetSize() );
+
+  // The deformation is computed from the transform in memory and matches transformix
+  EXPECT_NO_THROW( stfx.SetMovingImage( movingImage ) );
+  Image transformixResultImage = stfx.Execute();
+  float maximumDifference = 0.0f;
+  std::vector< uint32_t > index( 2 );
+  for( index[ 1 ] = 0; index[ 1 ] < transformixResultImage.GetHeight(); ++index[ 1 ] )
+  {
+    for( index[ 0 ] = 0; index[ 0 ] < transformixResultImage.GetWidth(); ++index[ 0 ] )
+    {
+      maximumDifference = std::max( maximumDifference, std::abs( resultImages[ 0 ].GetPixelAsFloat( index ) - transformixResultImage.GetPixelAsFloat( index ) ) );
+    }
+  }
+  EXPECT_LT( maximumDifference, 1e-2f );
+
+  // The cached deformation is reused for subsequent calls
+  EXPECT_NO_THROW( resultImages = stfx.Execute( movingImages ) );
+  EXPECT_EQ( resultImages.size(), 2u );
+}
+
+TEST( SimpleTransformix, TiledExecuteToFile )
+{
+  Image fixedImage = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) ), sitkFloat32 );
+  Image movingImage = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) ), sitkFloat32 );
+  const std::string movingImageFileName = dataFinder.GetOutputFile( "TiledMovingImage.mha" );
+  const std::string resultImageFileName = dataFinder.GetOutputFile( "TiledResultImage.mha" );
+  WriteImage( movingImage, movingImageFileName );
+
+  SimpleElastix silx;
+  silx.SetParameterMap( "affine" );
+  silx.SetFixedImage( fixedImage );
+  silx.SetMovingImage( movingImage );
+  silx.Execute();
+
+  SimpleTransformix stfx;
+  EXPECT_THROW( stfx.ExecuteToFile( movingImageFileName, resultImageFileName ), GenericException );
+  EXPECT_NO_THROW( stfx.SetTransformParameterMap( silx.GetTransformParameterMap() ) );
+  EXPECT_NO_THROW( stfx.SetTransformParameter( "FinalBSplineInterpolationOrder", "1" ) );
+  EXPECT_THROW( stfx.ExecuteToFile( movingImageFileName, dataFinder.GetOutputFile( "TiledResultImage.png" ) ), GenericException );
+  EXPECT_NO_THROW( stfx.ExecuteToFile( movingImageFileName, resultImageFileName, 7 ) );
+
+  // Tiles match the transformation of the whole image, also with the cubic B-spline, whose
+  // coefficients depend on the whole image, on an output grid that starts at a nonzero Index
+  // and in the ResultImagePixelType
+  for( unsigned int run = 0; run < 3; ++run )
+  {
+    if( run == 1 )
+    {
+      EXPECT_NO_THROW( stfx.SetTransformParameter( "FinalBSplineInterpolationOrder", "3" ) );
+      EXPECT_NO_THROW( stfx.SetTransformParameter( "Index", std::vector< std::string >( 2, "5" ) ) );
+      EXPECT_NO_THROW( stfx.ExecuteToFile( movingImageFileName, resultImageFileName, 7 ) );
+    }
+    else if( run == 2 )
+    {
+      EXPECT_NO_THROW( stfx.SetTransformParameter( "ResultImagePixelType", "long double" ) );
+      EXPECT_THROW( stfx.ExecuteToFile( movingImageFileName, resultImageFileName, 7 ), GenericException );
+      EXPECT_NO_THROW( stfx.SetTransformParameter( "ResultImagePixelType", "short" ) );
+      EXPECT_NO_THROW( stfx.ExecuteToFile( movingImageFileName, resultImageFileName, 7 ) );
+    }
+
+    Image tiledResultImage = ReadImage( resultImageFileName );
+    ASSERT_EQ( tiledResultImage.GetPixelID(), run == 2 ? sitkInt16 : sitkFloat32 );
+    Image resultImage = Cast( tiledResultImage, sitkFloat32 );
+    std::vector< Image > wholeResultImages = stfx.Execute( std::vector< Image >( 1, movingImage ) );
+    wholeResultImages[ 0 ] = Cast( wholeResultImages[ 0 ], sitkFloat32 );
+    ASSERT_EQ( resultImage.GetSize(), fixedImage.GetSize() );
+    EXPECT_EQ( resultImage.GetOrigin(), wholeResultImages[ 0 ].GetOrigin() );
+
+    float maximumDifference = 0.0f;
+    std::vector< uint32_t > index( 2 );
+    for( index[ 1 ] = 0; index[ 1 ] < resultImage.GetHeight(); ++index[ 1 ] )
+    {
+      for( index[ 0 ] = 0; index[ 0 ] < resultImage.GetWidth(); ++index[ 0 ] )
+      {
+        maximumDifference = std::max( maximumDifference, std::abs( resultImage.GetPixelAsFloat( index ) - wholeResultImages[ 0 ].GetPixelAsFloat( index ) ) );
+      }
+    }
+    EXPECT_LT( maximumDifference, run == 2 ? 1.0f : 1e-2f );
+  }
+}
+
+TEST( SimpleTransformix, DeformationFieldAndSpatialJacobian )
+{
+  Image fixedImage = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) ), sitkFloat32 );
+  Image movingImage = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) ), sitkFloat32 );
+
+  SimpleElastix silx;
+  silx.SetParameterMap( "translation" );
+  silx.SetFixedImage( fixedImage );
+  silx.SetMovingImage( movingImage );
+  silx.Execute();
+
+  SimpleTransformix stfx;
+  stfx.SetTransformParameterMap( silx.GetTransformParameterMap() );
+  stfx.SetMovingImage( movingImage );
+  stfx.RemoveOutputDirectory();
+  EXPECT_THROW( stfx.GetDeformationField(), GenericException );
+  EXPECT_NO_THROW( stfx.ComputeDeformationFieldOn() );
+  EXPECT_NO_THROW( stfx.ComputeSpatialJacobianOn() );
+  EXPECT_NO_THROW( stfx.ComputeDeterminantOfSpatialJacobianOn() );
+  EXPECT_NO_THROW( stfx.Execute() );
+
+  Image deformationField;
+  EXPECT_NO_THROW( deformationField = stfx.GetDeformationField() );
+  EXPECT_EQ( deformationField.GetSize(), fixedImage.GetSize() );
+  EXPECT_EQ( deformationField.GetNumberOfComponentsPerPixel(), 2u );
+  EXPECT_EQ( stfx.GetSpatialJacobian().GetNumberOfComponentsPerPixel(), 4u );
+  EXPECT_EQ( stfx.GetDeterminantOfSpatialJacobian().GetNumberOfComponentsPerPixel(), 1u );
+
+  // A translation does not change volume and displaces every voxel by its parameters
+  std::vector< unsigned int > index( 2, 64 );
+  EXPECT_NEAR( Cast( stfx.GetDeterminantOfSpatialJacobian(), sitkFloat64 ).GetPixelAsDouble( index ), 1.0, 1e-6 );
+  EXPECT_NEAR( stfx.GetSpatialJacobian().GetPixelAsVectorFloat32( index )[ 0 ], 1.0, 1e-6 );
+  EXPECT_NEAR( stfx.GetSpatialJacobian().GetPixelAsVectorFloat32( index )[ 1 ], 0.0, 1e-6 );
+
+  std::vector< double > translation;
+  for( unsigned int i = 0; i < 2; ++i )
+  {
+    translation.push_back( atof( silx.GetTransformParameterMap()[ 0 ][ "TransformParameters" ][ i ].c_str() ) );
+  }
+
+  EXPECT_NEAR( deformationField.GetPixelAsVectorFloat32( index )[ 0 ], translation[ 0 ], 1e-4 );
+  EXPECT_NEAR( deformationField.GetPixelAsVectorFloat32( index )[ 1 ], translation[ 1 ], 1e-4 );
+
+  // Output fields alone do not need a moving image
+  SimpleTransformix stfx2;
+  stfx2.SetTransformParameterMap( silx.GetTransformParameterMap() );
+  stfx2.ComputeDeterminantOfSpatialJacobianOn();
+  EXPECT_NO_THROW( stfx2.Execute() );
+  EXPECT_NEAR( Cast( stfx2.GetDeterminantOfSpatialJacobian(), sitkFloat64 ).GetPixelAsDouble( index ), 1.0, 1e-6 );
+}
+
+TEST( SimpleTransformix, SpatialJacobianMatchesTransformix )
+{
+  Image fixedImage = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) ), sitkFloat32 );
+  Image movingImage = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) ), sitkFloat32 );
+
+  SimpleElastix silx;
+  silx.SetParameterMap( "bspline" );
+  silx.SetParameter( "MaximumNumberOfIterations", "16" );
+  silx.SetFixedImage( fixedImage );
+  silx.SetMovingImage( movingImage );
+  silx.Execute();
+
+  // The B-spline transform is converted and differentiated in memory
+  SimpleTransformix stfx;
+  stfx.SetTransformParameterMap( silx.GetTransformParameterMap() );
+  stfx.ComputeSpatialJacobianOn();
+  stfx.ComputeDeterminantOfSpatialJacobianOn();
+  EXPECT_NO_THROW( stfx.Execute() );
+
+  // Behind an identity transform that it adds with a HowToCombineTransforms value that only
+  // transformix accepts, the same transform is differentiated by transformix
+  SimpleTransformix::ParameterMapType identityTransformParameterMap = silx.GetTransformParameterMap()[ 0 ];
+  identityTransformParameterMap[ "Transform" ] = SimpleTransformix::ParameterValueVectorType( 1, "TranslationTransform" );
+  identityTransformParameterMap[ "NumberOfParameters" ] = SimpleTransformix::ParameterValueVectorType( 1, "2" );
+  identityTransformParameterMap[ "TransformParameters" ] = SimpleTransformix::ParameterValueVectorType( 2, "0" );
+  SimpleTransformix::ParameterMapType bsplineTransformParameterMap = silx.GetTransformParameterMap()[ 0 ];
+  bsplineTransformParameterMap[ "HowToCombineTransforms" ] = SimpleTransformix::ParameterValueVectorType( 1, "Plus" );
+
+  SimpleTransformix stfx2;
+  stfx2.SetTransformParameterMap( identityTransformParameterMap );
+  stfx2.AddTransformParameterMap( bsplineTransformParameterMap );
+  stfx2.SetMovingImage( movingImage );
+  stfx2.ComputeSpatialJacobianOn();
+  stfx2.ComputeDeterminantOfSpatialJacobianOn();
+  EXPECT_THROW( stfx2.GetTransform(), GenericException );
+  EXPECT_NO_THROW( stfx2.Execute() );
+
+  Image spatialJacobian = Cast( stfx.GetSpatialJacobian(), sitkVectorFloat32 );
+  Image transformixSpatialJacobian = Cast( stfx2.GetSpatialJacobian(), sitkVectorFloat32 );
+  Image determinantOfSpatialJacobian = Cast( stfx.GetDeterminantOfSpatialJacobian(), sitkFloat32 );
+  Image transformixDeterminantOfSpatialJacobian = Cast( stfx2.GetDeterminantOfSpatialJacobian(), sitkFloat32 );
+  ASSERT_EQ( spatialJacobian.GetSize(), transformixSpatialJacobian.GetSize() );
+  ASSERT_EQ( transformixSpatialJacobian.GetNumberOfComponentsPerPixel(), 4u );
+
+  float maximumDifference = 0.0f;
+  float maximumDeterminantDifference = 0.0f;
+  std::vector< uint32_t > index( 2 );
+  for( index[ 1 ] = 0; index[ 1 ] < spatialJacobian.GetHeight(); ++index[ 1 ] )
+  {
+    for( index[ 0 ] = 0; index[ 0 ] < spatialJacobian.GetWidth(); ++index[ 0 ] )
+    {
+      const std::vector< float > jacobian = spatialJacobian.GetPixelAsVectorFloat32( index );
+      const std::vector< float > transformixJacobian = transformixSpatialJacobian.GetPixelAsVectorFloat32( index );
+      for( unsigned int i = 0; i < 4; ++i )
+      {
+        maximumDifference = std::max( maximumDifference, std::abs( jacobian[ i ] - transformixJacobian[ i ] ) );
+      }
+
+      maximumDeterminantDifference = std::max( maximumDeterminantDifference, std::abs( determinantOfSpatialJacobian.GetPixelAsFloat( index ) - transformixDeterminantOfSpatialJacobian.GetPixelAsFloat( index ) ) );
+    }
+  }
+
+  EXPECT_LT( maximumDifference, 1e-4f );
+  EXPECT_LT( maximumDeterminantDifference, 1e-4f );
+}
+
+TEST( SimpleTransformix, ConvertToTransform )
+{
+  Image fixedImage = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) ), sitkFloat32 );
+  Image movingImage = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) ), sitkFloat32 );
+
+  SimpleElastix silx;
+  silx.SetParameterMap( "translation" );
+  silx.AddParameterMap( silx.GetDefaultParameterMap( "affine" ) );
+  silx.AddParameterMap( silx.GetDefaultParameterMap( "bspline" ) );
+  silx.SetParameter( "MaximumNumberOfIterations", "8" );
+  silx.SetFixedImage( fixedImage );
+  silx.SetMovingImage( movingImage );
+  silx.Execute();
+
+  std::vector< std::vector< double > > fixedPointSet;
+  fixedPointSet.push_back( std::vector< double >( 2, 60.0 ) );
+  fixedPointSet.push_back( std::vector< double >( 2, 120.0 ) );
+
+  SimpleTransformix stfx;
+  EXPECT_THROW( stfx.GetTransform(), GenericException );
+  stfx.SetTransformParameterMap( silx.GetTransformParameterMap() );
+  stfx.SetFixedPointSet( fixedPointSet );
+  stfx.RemoveOutputDirectory();
+  stfx.Execute();
+
+  Transform transform;
+  EXPECT_NO_THROW( transform = stfx.GetTransform() );
+  EXPECT_EQ( transform.GetDimension(), 2u );
+  for( unsigned int i = 0; i < fixedPointSet.size(); ++i )
+  {
+    const std::vector< double > transformedPoint = transform.TransformPoint( fixedPointSet[ i ] );
+    EXPECT_NEAR( transformedPoint[ 0 ], stfx.GetTransformedPoints()[ i ][ 0 ], 1e-3 );
+    EXPECT_NEAR( transformedPoint[ 1 ], stfx.GetTransformedPoints()[ i ][ 1 ], 1e-3 );
+  }
+
+  EXPECT_NO_THROW( stfx.SetTransformParameter( 0, "Transform", "AffineDTITransform" ) );
+  EXPECT_THROW( stfx.GetTransform(), GenericException );
+
+  // Initial transform files that refer to each other are rejected
+  const std::string firstFileName = dataFinder.GetOutputFile( "CyclicInitialTransform1.txt" );
+  const std::string secondFileName = dataFinder.GetOutputFile( "CyclicInitialTransform2.txt" );
+  std::map< std::string, std::vector< std::string > > transformParameterMap = silx.GetTransformParameterMap()[ 0 ];
+  transformParameterMap[ "InitialTransformParametersFileName" ] = std::vector< std::string >( 1, secondFileName );
+  WriteParameterFile( transformParameterMap, firstFileName );
+  transformParameterMap[ "InitialTransformParametersFileName" ] = std::vector< std::string >( 1, firstFileName );
+  WriteParameterFile( transformParameterMap, secondFileName );
+  EXPECT_NO_THROW( stfx.SetTransformParameterMap( transformParameterMap ) );
+  EXPECT_THROW( stfx.GetTransform(), GenericException );
+}
+
 #ifdef SITK_4D_IMAGES
 
 TEST( SimpleTransformix, Transformation4D )
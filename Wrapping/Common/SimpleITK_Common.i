@@ -57,6 +57,7 @@
 // Global Tweaks to sitk::Image
 %ignore itk::simple::Image::GetITKBase( void );
 %ignore itk::simple::Image::GetITKBase( void ) const;
+%ignore itk::simple::Image::GetITKRegionViewBase( void ) const;
 
 #ifndef SWIGCSHARP
 %ignore itk::simple::Image::GetBufferAsInt8;
@@ -69,6 +70,7 @@
 %ignore itk::simple::Image::GetBufferAsUInt64;
 %ignore itk::simple::Image::GetBufferAsFloat;
 %ignore itk::simple::Image::GetBufferAsDouble;
+%ignore itk::simple::Image::GetRegionViewBuffer;
 #endif
 
 
@@ -124,6 +126,7 @@ namespace std
   %template(VectorDouble) vector<double>;
   %template(VectorOfImage) vector< itk::simple::Image >;
   %template(VectorUIntList) vector< vector<unsigned int> >;
+  %template(VectorDoubleList) vector< vector<double> >;
   %template(VectorString) vector< std::string >;
 
   %template(DoubleDoubleMap) map<double, double>;
@@ -151,6 +154,7 @@ namespace std
 %include "sitkVersion.h"
 %include "sitkPixelIDValues.h"
 %include "sitkImage.h"
+%include "sitkImageBufferPool.h"
 %include "sitkCommand.h"
 %include "sitkInterpolator.h"
 %include "sitkKernel.h"
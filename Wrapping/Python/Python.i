@@ -173,13 +173,108 @@
 
 
 
-         # NOTE: the __i*__ methods are not implemented because there
-         # currently in no way to make the underlying filters run
-         # inplace. But python will implement a default version based
-         # on the standard method
+        # NOTE: the __i*__ methods modify this image, like the in-place
+        # operators of numpy, and reuse its buffer when no other image
+        # shares it and the pixel type does not change.
         def __iadd__ ( self, other ):
-            self = Add( self, other )
-            return self;
+            if isinstance( other, Image ):
+               AddImageFilter().ExecuteInPlace( self, other )
+               return self
+            try:
+               AddImageFilter().ExecuteInPlace( self, float(other) )
+               return self
+            except ValueError:
+               return NotImplemented
+        def __isub__ ( self, other ):
+            if isinstance( other, Image ):
+               SubtractImageFilter().ExecuteInPlace( self, other )
+               return self
+            try:
+               SubtractImageFilter().ExecuteInPlace( self, float(other) )
+               return self
+            except ValueError:
+               return NotImplemented
+        def __imul__ ( self, other ):
+            if isinstance( other, Image ):
+               MultiplyImageFilter().ExecuteInPlace( self, other )
+               return self
+            try:
+               MultiplyImageFilter().ExecuteInPlace( self, float(other) )
+               return self
+            except ValueError:
+               return NotImplemented
+        def __idiv__ ( self, other ):
+            if isinstance( other, Image ):
+               DivideImageFilter().ExecuteInPlace( self, other )
+               return self
+            try:
+               DivideImageFilter().ExecuteInPlace( self, float(other) )
+               return self
+            except ValueError:
+               return NotImplemented
+        def __ifloordiv__ ( self, other ):
+            if isinstance( other, Image ):
+               DivideFloorImageFilter().ExecuteInPlace( self, other )
+               return self
+            try:
+               DivideFloorImageFilter().ExecuteInPlace( self, float(other) )
+               return self
+            except ValueError:
+               return NotImplemented
+        def __itruediv__ ( self, other ):
+            if isinstance( other, Image ):
+               DivideRealImageFilter().ExecuteInPlace( self, other )
+               return self
+            try:
+               DivideRealImageFilter().ExecuteInPlace( self, float(other) )
+               return self
+            except ValueError:
+               return NotImplemented
+        def __imod__ ( self, other ):
+            if isinstance( other, Image ):
+               ModulusImageFilter().ExecuteInPlace( self, other )
+               return self
+            try:
+               ModulusImageFilter().ExecuteInPlace( self, int(other) )
+               return self
+            except ValueError:
+               return NotImplemented
+        def __ipow__ ( self, other ):
+            if isinstance( other, Image ):
+               PowImageFilter().ExecuteInPlace( self, other )
+               return self
+            try:
+               PowImageFilter().ExecuteInPlace( self, float(other) )
+               return self
+            except ValueError:
+               return NotImplemented
+        def __iand__ ( self, other ):
+            if isinstance( other, Image ):
+               AndImageFilter().ExecuteInPlace( self, other )
+               return self
+            try:
+               AndImageFilter().ExecuteInPlace( self, int(other) )
+               return self
+            except ValueError:
+               return NotImplemented
+        def __ior__ ( self, other ):
+            if isinstance( other, Image ):
+               OrImageFilter().ExecuteInPlace( self, other )
+               return self
+            try:
+               OrImageFilter().ExecuteInPlace( self, int(other) )
+               return self
+            except ValueError:
+               return NotImplemented
+        def __ixor__ ( self, other ):
+            if isinstance( other, Image ):
+               XorImageFilter().ExecuteInPlace( self, other )
+               return self
+            try:
+               XorImageFilter().ExecuteInPlace( self, int(other) )
+               return self
+            except ValueError:
+               return NotImplemented
 
         # logic operators
 
@@ -326,7 +421,8 @@
             index.
 
             Multi-dimension extended slice based indexing is also
-            implemented. The return is a copy of a new image. The
+            implemented. The return is a new image, which is a region
+            view of this image when all the steps are one. The
             standard sliced based indices are supported including
             negative indices, to indicate location relative to the
             end, along with negative step sized to indicate reversing
@@ -406,6 +502,12 @@
               # extract each element of the indices rages together
               (start, stop, step) = zip(*sidx)
 
+              # a region with unit steps is viewed without copying
+              if ( slice_dim == -1
+                   and all( s[2] == 1 and s[1] > s[0] for s in sidx )
+                   and self.GetPixelID() not in ( sitkLabelUInt8, sitkLabelUInt16, sitkLabelUInt32, sitkLabelUInt64 ) ):
+                return self.GetRegionView( start, [ s[1] - s[0] for s in sidx ] )
+
               # run the slice filter
               img = Slice(self, start=start, stop=stop, step=step)
 
@@ -605,6 +707,8 @@
 // Numpy array conversion support
 %native(_GetByteArrayFromImage) PyObject *sitk_GetByteArrayFromImage( PyObject *self, PyObject *args );
 %native(_SetImageFromArray) PyObject *sitk_SetImageFromArray( PyObject *self, PyObject *args );
+%native(_GetBufferAddressFromImage) PyObject *sitk_GetBufferAddressFromImage( PyObject *self, PyObject *args );
+%native(_SetImageViewFromArray) PyObject *sitk_SetImageViewFromArray( PyObject *self, PyObject *args );
 
 %pythoncode %{
 
@@ -756,6 +860,79 @@ def GetImageFromArray( arr, isVector=False):
 
     _SimpleITK._SetImageFromArray( z.tostring(), img )
 
+    return img
+
+class _ArrayInterface(object):
+    """Exposes a buffer to numpy through the array interface, and keeps
+    its owner alive for as long as an array refers to it."""
+
+    def __init__(self, owner, interface):
+        self.owner = owner
+        self.__array_interface__ = interface
+
+def GetArrayViewFromImage(image):
+    """Get a read-only numpy array that refers to the pixel buffer of a SimpleITK Image, without copying it.
+
+    The array keeps the buffer alive after the image is deleted. The image continues to share the buffer
+    until it is modified, at which point it gets a copy of its own, so the array never changes. The array of
+    a region view is a strided view of the buffer the region view refers to."""
+
+    if not HAVE_NUMPY:
+        raise ImportError('Numpy not available.')
+
+    pixelID = image.GetPixelIDValue()
+    assert pixelID != sitkUnknown, "An SimpleITK image of Unknow pixel type should now exists!"
+
+    dtype = _get_numpy_dtype( image )
+
+    shape = image.GetRegionViewBufferSize();
+    if image.GetNumberOfComponentsPerPixel() > 1:
+      shape = ( image.GetNumberOfComponentsPerPixel(), ) + shape
+
+    # Only the array refers to this image, which shares the buffer with the caller's image
+    owner = Image( image )
+    interface = { 'shape': shape[::-1],
+                  'typestr': numpy.dtype( dtype ).str,
+                  'data': ( _SimpleITK._GetBufferAddressFromImage( owner ), True ),
+                  'version': 3 }
+
+    arr = numpy.asarray( _ArrayInterface( owner, interface ) )
+
+    if image.IsRegionView():
+      region = tuple( slice( i, i + s ) for i, s in zip( image.GetRegionViewIndex(), image.GetSize() ) )
+      arr = arr[ region[::-1] ]
+
+    return arr
+
+def GetImageViewFromArray( arr, isVector=False):
+    """Get a SimpleITK Image that refers to the buffer of a numpy array, without copying it. If isVector is True, then a 3D array will be treated as a 2D vector image, otherwise it will be treated as a 3D image
+
+    The array must be writable and C contiguous. Changes to the array are seen by the image and vice versa.
+    The image, and any image that shares its buffer, keeps the array alive."""
+
+    if not HAVE_NUMPY:
+        raise ImportError('Numpy not available.')
+
+    z = numpy.asarray( arr )
+
+    assert z.ndim in ( 2, 3, 4 ), \
+      "Only arrays of 2, 3 or 4 dimensions are supported."
+
+    if not z.flags['C_CONTIGUOUS'] or not z.flags['WRITEABLE']:
+      raise ValueError("Only writable C contiguous arrays can be viewed as an image. Use GetImageFromArray to copy the array.")
+
+    if ( z.ndim == 3 and isVector ) or (z.ndim == 4):
+      id = _get_sitk_vector_pixelid( z )
+      size = z.shape[-2::-1]
+      numberOfComponents = z.shape[-1]
+    elif z.ndim in ( 2, 3 ):
+      id = _get_sitk_pixelid( z )
+      size = z.shape[::-1]
+      numberOfComponents = 1
+
+    img = Image()
+    _SimpleITK._SetImageViewFromArray( z, img, size, id, numberOfComponents )
+
     return img
 %}
 
@@ -21,6 +21,7 @@
 #include <functional>
 
 #include "sitkImage.h"
+#include "sitkImportImageFilter.h"
 #include "sitkConditional.h"
 #include "sitkExceptionObject.h"
 
@@ -340,6 +341,253 @@ fail:
   return NULL;
 }
 
+/** An internal function that returns the address of the image buffer,
+ * so that a numpy array can refer to it through the array interface
+ * without a copy. The buffer is accessed through the const interface,
+ * so an image that shares its buffer with other images keeps sharing
+ * it. For a region view this is the buffer of the viewed image. The
+ * caller must hold a reference to the image for as long as the address
+ * is in use.
+ */
+static PyObject *
+sitk_GetBufferAddressFromImage( PyObject *SWIGUNUSEDPARM(self), PyObject *args )
+{
+  const void * sitkBufferPtr = NULL;
+
+  /* Cast over to a sitk Image. */
+  PyObject * pyImage;
+  void * voidImage;
+  const sitk::Image * sitkImage;
+  int res = 0;
+  if( !PyArg_ParseTuple( args, "O", &pyImage ) )
+    {
+    SWIG_fail; // SWIG_fail is a macro that says goto: fail (return NULL)
+    }
+  res = SWIG_ConvertPtr( pyImage, &voidImage, SWIGTYPE_p_itk__simple__Image, 0 );
+  if( !SWIG_IsOK( res ) )
+    {
+    SWIG_exception_fail(SWIG_ArgError(res), "in method 'GetBufferAddressFromImage', argument needs to be of type 'sitk::Image *'");
+    }
+  sitkImage = reinterpret_cast< sitk::Image * >( voidImage );
+
+  switch( sitkImage->GetPixelIDValue() )
+    {
+  case sitk::sitkUnknown:
+    PyErr_SetString( PyExc_RuntimeError, "Unknown pixel type." );
+    SWIG_fail;
+    break;
+  case sitk::ConditionalValue< sitk::sitkVectorUInt8 != sitk::sitkUnknown, sitk::sitkVectorUInt8, -14 >::Value:
+  case sitk::ConditionalValue< sitk::sitkUInt8 != sitk::sitkUnknown, sitk::sitkUInt8, -2 >::Value:
+  case sitk::ConditionalValue< sitk::sitkVectorInt8 != sitk::sitkUnknown, sitk::sitkVectorInt8, -15 >::Value:
+  case sitk::ConditionalValue< sitk::sitkInt8 != sitk::sitkUnknown, sitk::sitkInt8, -3 >::Value:
+  case sitk::ConditionalValue< sitk::sitkVectorUInt16 != sitk::sitkUnknown, sitk::sitkVectorUInt16, -16 >::Value:
+  case sitk::ConditionalValue< sitk::sitkUInt16 != sitk::sitkUnknown, sitk::sitkUInt16, -4 >::Value:
+  case sitk::ConditionalValue< sitk::sitkVectorInt16 != sitk::sitkUnknown, sitk::sitkVectorInt16, -17 >::Value:
+  case sitk::ConditionalValue< sitk::sitkInt16 != sitk::sitkUnknown, sitk::sitkInt16, -5 >::Value:
+  case sitk::ConditionalValue< sitk::sitkVectorUInt32 != sitk::sitkUnknown, sitk::sitkVectorUInt32, -18 >::Value:
+  case sitk::ConditionalValue< sitk::sitkUInt32 != sitk::sitkUnknown, sitk::sitkUInt32, -6 >::Value:
+  case sitk::ConditionalValue< sitk::sitkVectorInt32 != sitk::sitkUnknown, sitk::sitkVectorInt32, -19 >::Value:
+  case sitk::ConditionalValue< sitk::sitkInt32 != sitk::sitkUnknown, sitk::sitkInt32, -7 >::Value:
+  case sitk::ConditionalValue< sitk::sitkVectorUInt64 != sitk::sitkUnknown, sitk::sitkVectorUInt64, -20 >::Value:
+  case sitk::ConditionalValue< sitk::sitkUInt64 != sitk::sitkUnknown, sitk::sitkUInt64, -8 >::Value:
+  case sitk::ConditionalValue< sitk::sitkVectorInt64 != sitk::sitkUnknown, sitk::sitkVectorInt64, -21 >::Value:
+  case sitk::ConditionalValue< sitk::sitkInt64 != sitk::sitkUnknown, sitk::sitkInt64, -9 >::Value:
+  case sitk::ConditionalValue< sitk::sitkVectorFloat32 != sitk::sitkUnknown, sitk::sitkVectorFloat32, -22 >::Value:
+  case sitk::ConditionalValue< sitk::sitkFloat32 != sitk::sitkUnknown, sitk::sitkFloat32, -10 >::Value:
+  case sitk::ConditionalValue< sitk::sitkVectorFloat64 != sitk::sitkUnknown, sitk::sitkVectorFloat64, -23 >::Value:
+  case sitk::ConditionalValue< sitk::sitkFloat64 != sitk::sitkUnknown, sitk::sitkFloat64, -11 >::Value:
+    sitkBufferPtr = sitkImage->GetRegionViewBuffer();
+    break;
+  case sitk::ConditionalValue< sitk::sitkComplexFloat32 != sitk::sitkUnknown, sitk::sitkComplexFloat32, -12 >::Value:
+  case sitk::ConditionalValue< sitk::sitkComplexFloat64 != sitk::sitkUnknown, sitk::sitkComplexFloat64, -13 >::Value:
+    PyErr_SetString( PyExc_RuntimeError, "Images of Complex Pixel types currently are not supported." );
+    SWIG_fail;
+    break;
+  default:
+    PyErr_SetString( PyExc_RuntimeError, "Unknown pixel type." );
+    SWIG_fail;
+    }
+
+  return PyLong_FromVoidPtr( const_cast< void * >( sitkBufferPtr ) );
+
+fail:
+  return NULL;
+}
+
+
+/** Releases the buffer of a python object that was adopted by an
+ * image. Images may be destroyed on any thread, so the GIL is taken.
+ * Images that outlive the interpreter, e.g. in static objects, can
+ * no longer release the export, which then goes with the process.
+ */
+static void
+sitk_ReleaseArrayBuffer( void * SWIGUNUSEDPARM(buffer), void * clientData )
+{
+  Py_buffer * pyBuffer = static_cast< Py_buffer * >( clientData );
+
+  if( Py_IsInitialized() )
+    {
+    PyGILState_STATE gilState = PyGILState_Ensure();
+    PyBuffer_Release( pyBuffer );
+    PyGILState_Release( gilState );
+    }
+
+  delete pyBuffer;
+}
+
+
+/** An internal function that makes the image refer to the buffer of a
+ * C contiguous python object, e.g. a numpy array, without a copy. The
+ * image and all images that share its buffer hold the buffer export of
+ * the python object, which is released with the last of them.
+ */
+static PyObject*
+sitk_SetImageViewFromArray( PyObject *SWIGUNUSEDPARM(self), PyObject *args )
+{
+  PyObject * pyArray = NULL;
+  PyObject * pyImage = NULL;
+  PyObject * pySize = NULL;
+  int pixelIDValue = sitk::sitkUnknown;
+  unsigned int numberOfComponents = 1;
+
+  Py_buffer * pyBuffer = new Py_buffer;
+  memset(pyBuffer, 0, sizeof(Py_buffer));
+
+  sitk::Image * sitkImage = NULL;
+  sitk::ImportImageFilter importer;
+  std::vector< unsigned int > size;
+  size_t pixelSize = 1;
+  size_t len = 1;
+
+  if( !PyArg_ParseTuple( args, "OOOiI", &pyArray, &pyImage, &pySize, &pixelIDValue, &numberOfComponents ) )
+    {
+    delete pyBuffer;
+    return NULL;
+    }
+
+  // The importer writes through the buffer, so it must be writable as well
+  if( PyObject_GetBuffer( pyArray, pyBuffer, PyBUF_C_CONTIGUOUS | PyBUF_WRITABLE ) != 0 )
+    {
+    PyErr_Clear();
+    PyErr_SetString( PyExc_TypeError, "A writable C Contiguous buffer object is required." );
+    delete pyBuffer;
+    return NULL;
+    }
+
+  /* Cast over to a sitk Image. */
+  {
+    void * voidImage;
+    int res = 0;
+    res = SWIG_ConvertPtr( pyImage, &voidImage, SWIGTYPE_p_itk__simple__Image, 0 );
+    if( !SWIG_IsOK( res ) )
+      {
+      SWIG_exception_fail(SWIG_ArgError(res), "in method 'SetImageViewFromArray', argument needs to be of type 'sitk::Image *'");
+      }
+    sitkImage = reinterpret_cast< sitk::Image * >( voidImage );
+  }
+
+  for( Py_ssize_t i = 0; i < PySequence_Size( pySize ); ++i )
+    {
+    PyObject * item = PySequence_GetItem( pySize, i );
+    size.push_back( static_cast< unsigned int >( PyLong_AsUnsignedLong( item ) ) );
+    Py_XDECREF( item );
+    }
+  if( PyErr_Occurred() )
+    {
+    goto fail;
+    }
+
+  try
+    {
+    switch( pixelIDValue )
+      {
+      case sitk::ConditionalValue< sitk::sitkVectorUInt8 != sitk::sitkUnknown, sitk::sitkVectorUInt8, -14 >::Value:
+      case sitk::ConditionalValue< sitk::sitkUInt8 != sitk::sitkUnknown, sitk::sitkUInt8, -2 >::Value:
+        importer.SetBufferAsUInt8( static_cast< uint8_t * >( pyBuffer->buf ), numberOfComponents );
+        pixelSize  = sizeof( uint8_t );
+        break;
+      case sitk::ConditionalValue< sitk::sitkVectorInt8 != sitk::sitkUnknown, sitk::sitkVectorInt8, -15 >::Value:
+      case sitk::ConditionalValue< sitk::sitkInt8 != sitk::sitkUnknown, sitk::sitkInt8, -3 >::Value:
+        importer.SetBufferAsInt8( static_cast< int8_t * >( pyBuffer->buf ), numberOfComponents );
+        pixelSize  = sizeof( int8_t );
+        break;
+      case sitk::ConditionalValue< sitk::sitkVectorUInt16 != sitk::sitkUnknown, sitk::sitkVectorUInt16, -16 >::Value:
+      case sitk::ConditionalValue< sitk::sitkUInt16 != sitk::sitkUnknown, sitk::sitkUInt16, -4 >::Value:
+        importer.SetBufferAsUInt16( static_cast< uint16_t * >( pyBuffer->buf ), numberOfComponents );
+        pixelSize  = sizeof( uint16_t );
+        break;
+      case sitk::ConditionalValue< sitk::sitkVectorInt16 != sitk::sitkUnknown, sitk::sitkVectorInt16, -17 >::Value:
+      case sitk::ConditionalValue< sitk::sitkInt16 != sitk::sitkUnknown, sitk::sitkInt16, -5 >::Value:
+        importer.SetBufferAsInt16( static_cast< int16_t * >( pyBuffer->buf ), numberOfComponents );
+        pixelSize  = sizeof( int16_t );
+        break;
+      case sitk::ConditionalValue< sitk::sitkVectorUInt32 != sitk::sitkUnknown, sitk::sitkVectorUInt32, -18 >::Value:
+      case sitk::ConditionalValue< sitk::sitkUInt32 != sitk::sitkUnknown, sitk::sitkUInt32, -6 >::Value:
+        importer.SetBufferAsUInt32( static_cast< uint32_t * >( pyBuffer->buf ), numberOfComponents );
+        pixelSize  = sizeof( uint32_t );
+        break;
+      case sitk::ConditionalValue< sitk::sitkVectorInt32 != sitk::sitkUnknown, sitk::sitkVectorInt32, -19 >::Value:
+      case sitk::ConditionalValue< sitk::sitkInt32 != sitk::sitkUnknown, sitk::sitkInt32, -7 >::Value:
+        importer.SetBufferAsInt32( static_cast< int32_t * >( pyBuffer->buf ), numberOfComponents );
+        pixelSize  = sizeof( int32_t );
+        break;
+      case sitk::ConditionalValue< sitk::sitkVectorUInt64 != sitk::sitkUnknown, sitk::sitkVectorUInt64, -20 >::Value:
+      case sitk::ConditionalValue< sitk::sitkUInt64 != sitk::sitkUnknown, sitk::sitkUInt64, -8 >::Value:
+        importer.SetBufferAsUInt64( static_cast< uint64_t * >( pyBuffer->buf ), numberOfComponents );
+        pixelSize  = sizeof( uint64_t );
+        break;
+      case sitk::ConditionalValue< sitk::sitkVectorInt64 != sitk::sitkUnknown, sitk::sitkVectorInt64, -21 >::Value:
+      case sitk::ConditionalValue< sitk::sitkInt64 != sitk::sitkUnknown, sitk::sitkInt64, -9 >::Value:
+        importer.SetBufferAsInt64( static_cast< int64_t * >( pyBuffer->buf ), numberOfComponents );
+        pixelSize  = sizeof( int64_t );
+        break;
+      case sitk::ConditionalValue< sitk::sitkVectorFloat32 != sitk::sitkUnknown, sitk::sitkVectorFloat32, -22 >::Value:
+      case sitk::ConditionalValue< sitk::sitkFloat32 != sitk::sitkUnknown, sitk::sitkFloat32, -10 >::Value:
+        importer.SetBufferAsFloat( static_cast< float * >( pyBuffer->buf ), numberOfComponents );
+        pixelSize  = sizeof( float );
+        break;
+      case sitk::ConditionalValue< sitk::sitkVectorFloat64 != sitk::sitkUnknown, sitk::sitkVectorFloat64, -23 >::Value:
+      case sitk::ConditionalValue< sitk::sitkFloat64 != sitk::sitkUnknown, sitk::sitkFloat64, -11 >::Value:
+        importer.SetBufferAsDouble( static_cast< double * >( pyBuffer->buf ), numberOfComponents );
+        pixelSize  = sizeof( double );
+        break;
+      default:
+        PyErr_SetString( PyExc_RuntimeError, "Only arrays of integer and floating point pixels can be viewed as an image." );
+        goto fail;
+      }
+
+    len = std::accumulate( size.begin(), size.end(), size_t(1), std::multiplies<size_t>() );
+    len *= pixelSize * numberOfComponents;
+
+    if ( static_cast< size_t >( pyBuffer->len ) != len )
+      {
+      PyErr_SetString( PyExc_RuntimeError, "Size mismatch of image and Buffer." );
+      goto fail;
+      }
+
+    // If Execute throws, the importer has not adopted the buffer and
+    // the export is released below, once
+    importer.SetSize( size );
+    importer.SetBufferDeleter( sitk_ReleaseArrayBuffer, pyBuffer );
+    *sitkImage = importer.Execute();
+    }
+  catch( const std::exception &e )
+    {
+    std::string msg = "Exception thrown in SimpleITK new Image: ";
+    msg += e.what();
+    PyErr_SetString( PyExc_RuntimeError, msg.c_str() );
+    goto fail;
+    }
+
+  // The image owns the buffer export now
+  Py_RETURN_NONE;
+
+fail:
+  PyBuffer_Release( pyBuffer );
+  delete pyBuffer;
+  return NULL;
+}
+
 #ifdef __cplusplus
 } // end extern "C"
 #endif